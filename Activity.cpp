@@ -0,0 +1,94 @@
+#include "Activity.hpp"
+#include "decodedtext.h"
+
+CallDetail
+Activity::compoundCall(DecodedText const & decodedtext,
+                       StringPool        & strings)
+{
+  CallDetail cd = {};
+
+  cd.call    = strings.intern(decodedtext.compoundCall());
+  cd.grid    = strings.intern(decodedtext.extra()); // compound calls via pings may contain grid...
+  cd.snr     = decodedtext.snr();
+  cd.offset  = decodedtext.frequencyOffset();
+  cd.bits    = decodedtext.bits();
+  cd.submode = decodedtext.submode();
+
+  return cd;
+}
+
+CommandDetail
+Activity::directedCommand(DecodedText const & decodedtext,
+                          StringPool        & strings)
+{
+  auto const    parts = decodedtext.directedMessage();
+  CommandDetail cmd   = {};
+
+  cmd.from    = strings.intern(parts.at(0));
+  cmd.to      = strings.intern(parts.at(1));
+  cmd.cmd     = strings.intern(parts.at(2));
+  cmd.offset  = decodedtext.frequencyOffset();
+  cmd.snr     = decodedtext.snr();
+  cmd.bits    = decodedtext.bits();
+  cmd.extra   = parts.length() > 2 ? parts.mid(3).join(" ") : "";
+  cmd.submode = decodedtext.submode();
+
+  return cmd;
+}
+
+CallDetail
+Activity::caller(CommandDetail const & cmd)
+{
+  CallDetail cd = {};
+
+  cd.call         = cmd.from;
+  cd.grid         = cmd.grid;
+  cd.snr          = cmd.snr;
+  cd.dial         = cmd.dial;
+  cd.offset       = cmd.offset;
+  cd.bits         = cmd.bits;
+  cd.utcTimestamp = cmd.utcTimestamp;
+  cd.tdrift       = cmd.tdrift;
+  cd.submode      = cmd.submode;
+
+  return cd;
+}
+
+bool
+Activity::logCall(QMap<QString, CallDetail> & calls,
+                  CallDetail                & d,
+                  StringPool                & strings)
+{
+  // every record for a call shares the one copy of it, and of its grid
+  d.call    = strings.intern(d.call);
+  d.through = strings.intern(d.through);
+  d.grid    = strings.intern(d.grid);
+
+  if (auto it = calls.find(d.call); it != calls.end())
+  {
+    // update (keep grid)
+    CallDetail const & old = *it;
+
+    if (d.grid.isEmpty() && !old.grid.isEmpty())
+    {
+      d.grid = old.grid;
+    }
+    if (!d.ackTimestamp.isValid() && old.ackTimestamp.isValid())
+    {
+      d.ackTimestamp = old.ackTimestamp;
+    }
+    if (!d.cqTimestamp.isValid() && old.cqTimestamp.isValid())
+    {
+      d.cqTimestamp = old.cqTimestamp;
+    }
+
+    *it = d;
+
+    return false;
+  }
+
+  // create
+  calls.insert(d.call, d);
+
+  return true;
+}
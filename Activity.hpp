@@ -0,0 +1,100 @@
+#ifndef ACTIVITY_HPP__
+#define ACTIVITY_HPP__
+
+#include <QMap>
+#include <QString>
+#include "DriftingDateTime.h"
+#include "StringPool.hpp"
+
+class DecodedText;
+
+// Records of what's been heard on the band; calls, the commands they've
+// sent, and the text heard at each offset. These are what the main window
+// holds on to, in its activity maps and the queues between decoding and
+// display, and so what a busy band fills memory with.
+
+struct CallDetail
+{
+  QString call;
+  QString through;
+  QString grid;
+  int dial;
+  int offset;
+  UtcTime cqTimestamp;
+  UtcTime ackTimestamp;
+  UtcTime utcTimestamp;
+  int snr;
+  int bits;
+  float tdrift;
+  int submode;
+};
+
+struct CommandDetail
+{
+  bool isCompound;
+  bool isBuffered;
+  QString from;
+  QString to;
+  QString cmd;
+  int dial;
+  int offset;
+  UtcTime utcTimestamp;
+  int snr;
+  int bits;
+  QString grid;
+  QString text;
+  QString extra;
+  float tdrift;
+  int submode;
+  QString relayPath;
+};
+
+struct ActivityDetail
+{
+  bool isLowConfidence;
+  bool isCompound;
+  bool isDirected;
+  bool isBuffered;
+  int bits;
+  int dial;
+  int offset;
+  QString text;
+  UtcTime utcTimestamp;
+  int snr;
+  bool shouldDisplay;
+  float tdrift;
+  int submode;
+};
+
+// Building the records from decodes, and keeping the latest for each call.
+// Strings that recur from one decode to the next are interned in the pool
+// given, so that records share them; the dial frequency, timestamps and
+// drift are left to the caller, who knows them.
+
+namespace Activity
+{
+  // The compound call of a decode, with its grid, if any.
+
+  CallDetail compoundCall(DecodedText const &,
+                          StringPool        &);
+
+  // The directed command of a decode; from, to and command.
+
+  CommandDetail directedCommand(DecodedText const &,
+                                StringPool        &);
+
+  // The call sending a command, as heard in it.
+
+  CallDetail caller(CommandDetail const &);
+
+  // Keep the record for a call, interning its strings, and keeping the
+  // grid and the ack and CQ timestamps of any record it replaces that it
+  // doesn't have itself; the record's left as kept. Returns true if the
+  // call wasn't already known.
+
+  bool logCall(QMap<QString, CallDetail> &,
+               CallDetail                &,
+               StringPool                &);
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include "ApiQueries.hpp"
+#include <exception>
+#include <QDebug>
+#include <QMetaObject>
+
+namespace
+{
+  // Limits we're keeping before we bother discarding those that have
+  // lapsed; clients come and go, and we needn't remember them forever.
+
+  constexpr qsizetype PRUNE_AT = 64;
+
+  QString
+  limitKey(QString const & client,
+           QString const & type)
+  {
+    return client + QLatin1Char('|') + type;
+  }
+}
+
+ApiQueries::ApiQueries(QObject * parent)
+  : QObject(parent)
+{
+  // One at a time; queries are answered in the order they were asked.
+
+  m_pool.setMaxThreadCount(1);
+}
+
+qint64
+ApiQueries::submit(QString const & client,
+                   Message const & request,
+                   Query           query)
+{
+  if (m_limits.size() >= PRUNE_AT) prune();
+
+  auto const key   = limitKey(client, request.type());
+  auto const id    = request.id();
+  auto     & limit = m_limits[key];
+
+  if (limit.inFlight) return MIN_INTERVAL_MS;
+
+  if (limit.last.isValid())
+  {
+    if (auto const elapsed = limit.last.elapsed();
+                   elapsed < MIN_INTERVAL_MS)
+    {
+      return MIN_INTERVAL_MS - elapsed;
+    }
+  }
+
+  limit.last.start();
+  limit.inFlight = true;
+
+  m_pool.start([this, key, id, query = std::move(query)]()
+  {
+    Message reply;
+
+    try
+    {
+      reply = query();
+    }
+    catch (Busy const &)
+    {
+      reply = Message("API.ERROR", "Busy", {{"_ID", QVariant(id)}, {"RETRY_MS", QVariant(MIN_INTERVAL_MS)}});
+    }
+    catch (std::exception const & e)
+    {
+      qWarning() << "API query" << key << "failed:" << e.what();
+      reply = Message("API.ERROR", e.what(), {{"_ID", QVariant(id)}});
+    }
+
+    QMetaObject::invokeMethod(this, [this, key, reply]() { finished(key, reply); }, Qt::QueuedConnection);
+  });
+
+  return 0;
+}
+
+void
+ApiQueries::finished(QString const & key,
+                     Message const & reply)
+{
+  if (auto const it = m_limits.find(key); it != m_limits.end()) it->inFlight = false;
+
+  if (!reply.type().isEmpty()) emit ready(reply);
+}
+
+void
+ApiQueries::prune()
+{
+  m_limits.removeIf([](auto const & it)
+  {
+    return !it.value().inFlight && it.value().last.hasExpired(MIN_INTERVAL_MS);
+  });
+}
+
+/******************************************************************************/
@@ -0,0 +1,86 @@
+#ifndef API_QUERIES_HPP__
+#define API_QUERIES_HPP__
+
+#include <functional>
+#include <stdexcept>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include "Message.hpp"
+
+// Runs the expensive read-only API queries off the GUI thread. A query is
+// submitted as a function that builds its reply from a snapshot of the
+// state it needs; the snapshot is taken on the GUI thread when the query
+// is submitted, and since it's made of implicitly shared containers, it's
+// cheap to take and unaffected by anything that happens afterward. Queries
+// run one at a time, in the order submitted, and each reply is delivered
+// by the ready signal on the thread that owns us.
+//
+// Each client may have only one query of a given type in flight, and may
+// ask for it no more often than the minimum interval; a query over that
+// limit isn't run, so that a script polling as fast as it can gets told
+// to back off rather than making the GUI stutter. Anything that changes
+// state never comes through here; it's handled on the GUI thread, in the
+// order received.
+//
+// Since queries run one at a time, one that waits holds up every query
+// behind it, from every client. A query that needs a lock held elsewhere,
+// e.g., on the inbox while the GUI thread writes to it, should wait for it
+// no longer than the busy timeout, and if it's still held, throw Busy; the
+// client's told to ask again, as if it had been rate limited.
+
+class ApiQueries final
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  // Builds the reply; one of no type, i.e., a default constructed message,
+  // means there's nothing to say.
+  using Query = std::function<Message()>;
+
+  static constexpr qint64 MIN_INTERVAL_MS = 1000;
+  static constexpr int    BUSY_TIMEOUT_MS = 100;
+
+  // Thrown by a query that couldn't get at what it needs in time.
+  struct Busy : std::runtime_error
+  {
+    Busy() : std::runtime_error("Busy") {}
+  };
+
+  explicit ApiQueries(QObject * parent = nullptr);
+
+  // Run the query answering a request on behalf of the client, unless that
+  // would put it over its limit for this type of request; returns zero if
+  // it was accepted, or how long, in milliseconds, the client should wait
+  // before asking again.
+  qint64 submit(QString const & client,
+                Message const & request,
+                Query           query);
+
+  Q_SIGNAL void ready(Message const & reply);
+
+private:
+
+  struct Limit
+  {
+    QElapsedTimer last;             // since the last query was accepted
+    bool          inFlight = false;
+  };
+
+  void finished(QString const & key,
+                Message const & reply);
+  void prune();
+
+  QHash<QString, Limit> m_limits;   // client and type -> limit
+
+  // Declared last so that it's destroyed first, waiting for any query
+  // still in flight before the rest of us goes away.
+
+  QThreadPool           m_pool;
+};
+
+#endif
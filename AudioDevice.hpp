@@ -1,7 +1,9 @@
 #ifndef AUDIODEVICE_HPP__
 #define AUDIODEVICE_HPP__
 
+#include <algorithm>
 #include <QIODevice>
+#include "AudioKernels.hpp"
 
 class QDataStream;
 
@@ -51,26 +53,23 @@ protected:
   void store (char const * source, size_t numFrames, qint16 * dest)
   {
     qint16 const * begin (reinterpret_cast<qint16 const *> (source));
-    for ( qint16 const * i = begin; i != begin + numFrames * (bytesPerFrame () / sizeof (qint16)); i += bytesPerFrame () / sizeof (qint16))
+    switch (m_channel)
       {
-	switch (m_channel)
-	  {
-	  case Mono:
-	    *dest++ = *i;
-	    break;
+      case Mono:
+	std::copy_n (begin, numFrames, dest);
+	break;
 
-	  case Right:
-	    *dest++ = *(i + 1);
-	    break;
+      case Right:
+	AudioKernels::deinterleave (begin, numFrames, 1, dest);
+	break;
 
-	  case Both:		// should be able to happen but if it
+      case Both:		// should be able to happen but if it
 				// does we'll take left
-	    Q_ASSERT (Both == m_channel);
-      [[fallthrough]];
-	  case Left:
-	    *dest++ = *i;
-	    break;
-	  }
+	Q_ASSERT (Both == m_channel);
+	[[fallthrough]];
+      case Left:
+	AudioKernels::deinterleave (begin, numFrames, 0, dest);
+	break;
       }
   }
 
@@ -100,6 +99,18 @@ protected:
     return dest;
   }
 
+  // as above, for a block of samples at a time
+  qint16 * load (qint16 const * source, size_t numFrames, qint16 * dest)
+  {
+    if (Mono == m_channel)
+      {
+	return std::copy_n (source, numFrames, dest);
+      }
+
+    AudioKernels::interleave (source, numFrames, Right != m_channel, Left != m_channel, dest);
+    return dest + 2 * numFrames;
+  }
+
 private:
   Channel m_channel;
 };
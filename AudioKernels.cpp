@@ -0,0 +1,631 @@
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <QByteArray>
+#include <QDebug>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AUDIO_KERNELS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define AUDIO_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_KERNELS_NEON 1
+#include <arm_neon.h>
+#elif defined(__arm__) && defined(__linux__) && (defined(__ARM_NEON) || (defined(__GNUC__) && !defined(__clang__)))
+#define AUDIO_KERNELS_NEON 1
+#include <arm_neon.h>
+#if !defined(__ARM_NEON)
+#define AUDIO_KERNELS_NEON_DETECT 1
+#define AUDIO_KERNELS_NEON_TARGET __attribute__((target("fpu=neon")))
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#if !defined(AUDIO_KERNELS_NEON_TARGET)
+#define AUDIO_KERNELS_NEON_TARGET
+#endif
+
+namespace
+{
+  constexpr float FULL_SCALE = std::numeric_limits<qint16>::max();
+
+  /****************************************************************************/
+  // Plain C++; the reference for all the others, and what they use for any
+  // samples left over after their last full vector.
+  /****************************************************************************/
+
+  namespace scalar
+  {
+    void
+    deinterleave(qint16 const * in,
+                 std::size_t    frames,
+                 std::size_t    channel,
+                 qint16       * out)
+    {
+      for (in += channel; frames; --frames, in += 2) *out++ = *in;
+    }
+
+    void
+    interleave(qint16 const * in,
+               std::size_t    frames,
+               bool     const left,
+               bool     const right,
+               qint16       * out)
+    {
+      for (; frames; --frames)
+      {
+        auto const sample = *in++;
+        *out++ = left  ? sample : 0;
+        *out++ = right ? sample : 0;
+      }
+    }
+
+    void
+    toInt16(float const * in,
+            std::size_t   count,
+            qint16      * out)
+    {
+      for (; count; --count)
+      {
+        *out++ = static_cast<qint16>(std::lrint(std::clamp(*in++, -1.0f, 1.0f) * FULL_SCALE));
+      }
+    }
+
+    void
+    toFloat(qint16 const * in,
+            std::size_t    count,
+            float        * out)
+    {
+      for (; count; --count) *out++ = *in++ * (1.0f / FULL_SCALE);
+    }
+
+    AudioKernels::Level
+    level(qint16 const * in,
+          std::size_t    count,
+          AudioKernels::Level level = {})
+    {
+      for (; count; --count)
+      {
+        int const sample = *in++;
+        level.sumOfSquares += static_cast<quint64>(sample * sample);
+        level.peak          = std::max(level.peak, std::abs(sample));
+      }
+      return level;
+    }
+  }
+
+  /****************************************************************************/
+  // SSE2; always there on x86-64.
+  /****************************************************************************/
+
+#if AUDIO_KERNELS_SSE2
+  namespace sse2
+  {
+    void
+    deinterleave(qint16 const * in,
+                 std::size_t    frames,
+                 std::size_t    channel,
+                 qint16       * out)
+    {
+      // Sign extend the channel we want from each 32-bit frame, and pack
+      // the lot back down to 16 bits; nothing saturates.
+
+      for (; frames >= 8; frames -= 8, in += 16, out += 8)
+      {
+        auto a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in));
+        auto b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 8));
+
+        if (channel)
+        {
+          a = _mm_srai_epi32(a, 16);
+          b = _mm_srai_epi32(b, 16);
+        }
+        else
+        {
+          a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+          b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packs_epi32(a, b));
+      }
+
+      scalar::deinterleave(in, frames, channel, out);
+    }
+
+    void
+    interleave(qint16 const * in,
+               std::size_t    frames,
+               bool     const left,
+               bool     const right,
+               qint16       * out)
+    {
+      auto const l = _mm_set1_epi16(left  ? -1 : 0);
+      auto const r = _mm_set1_epi16(right ? -1 : 0);
+
+      for (; frames >= 8; frames -= 8, in += 8, out += 16)
+      {
+        auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in));
+        auto const a = _mm_and_si128(s, l);
+        auto const b = _mm_and_si128(s, r);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),     _mm_unpacklo_epi16(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpackhi_epi16(a, b));
+      }
+
+      scalar::interleave(in, frames, left, right, out);
+    }
+
+    void
+    toInt16(float const * in,
+            std::size_t   count,
+            qint16      * out)
+    {
+      auto const lo    = _mm_set1_ps(-1.0f);
+      auto const hi    = _mm_set1_ps( 1.0f);
+      auto const scale = _mm_set1_ps(FULL_SCALE);
+
+      for (; count >= 8; count -= 8, in += 8, out += 8)
+      {
+        auto const a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in),     lo), hi), scale);
+        auto const b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4), lo), hi), scale);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packs_epi32(_mm_cvtps_epi32(a),
+                                                                            _mm_cvtps_epi32(b)));
+      }
+
+      scalar::toInt16(in, count, out);
+    }
+
+    void
+    toFloat(qint16 const * in,
+            std::size_t    count,
+            float        * out)
+    {
+      auto const scale = _mm_set1_ps(1.0f / FULL_SCALE);
+
+      for (; count >= 8; count -= 8, in += 8, out += 8)
+      {
+        auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in));
+        auto const a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        auto const b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+
+        _mm_storeu_ps(out,     _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+        _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+      }
+
+      scalar::toFloat(in, count, out);
+    }
+
+    AudioKernels::Level
+    level(qint16 const * in,
+          std::size_t    count)
+    {
+      // Pairs of squares are summed to 32 bits, where the worst case, two
+      // full scale negative samples, is 2^31; that fits if taken unsigned,
+      // and they're widened to 64 bits before accumulating.
+
+      auto const zero = _mm_setzero_si128();
+      auto       sum  = _mm_setzero_si128();
+      auto       max  = _mm_setzero_si128();
+      auto       min  = _mm_setzero_si128();
+
+      for (; count >= 8; count -= 8, in += 8)
+      {
+        auto const s  = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in));
+        auto const sq = _mm_madd_epi16(s, s);
+
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(sq, zero));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(sq, zero));
+        max = _mm_max_epi16(max, s);
+        min = _mm_min_epi16(min, s);
+      }
+
+      alignas(16) quint64 sums[2];
+      alignas(16) qint16  maxs[8];
+      alignas(16) qint16  mins[8];
+
+      _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum);
+      _mm_store_si128(reinterpret_cast<__m128i *>(maxs), max);
+      _mm_store_si128(reinterpret_cast<__m128i *>(mins), min);
+
+      AudioKernels::Level level;
+
+      level.sumOfSquares = sums[0] + sums[1];
+      level.peak         = std::max(int(*std::max_element(std::begin(maxs), std::end(maxs))),
+                                   -int(*std::min_element(std::begin(mins), std::end(mins))));
+
+      return scalar::level(in, count, level);
+    }
+  }
+#endif
+
+  /****************************************************************************/
+  // AVX2; where the processor has it. Anything not worth doing 16 at a time
+  // is left to SSE2.
+  /****************************************************************************/
+
+#if AUDIO_KERNELS_AVX2
+  namespace avx2
+  {
+    // The 256-bit packs work within each 128-bit lane; this puts the 64-bit
+    // quarters back in order afterward.
+
+    constexpr int UNLANE = 0xd8;
+
+    __attribute__((target("avx2")))
+    void
+    deinterleave(qint16 const * in,
+                 std::size_t    frames,
+                 std::size_t    channel,
+                 qint16       * out)
+    {
+      for (; frames >= 16; frames -= 16, in += 32, out += 16)
+      {
+        auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in));
+        auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in + 16));
+
+        if (channel)
+        {
+          a = _mm256_srai_epi32(a, 16);
+          b = _mm256_srai_epi32(b, 16);
+        }
+        else
+        {
+          a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+          b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), UNLANE));
+      }
+
+      sse2::deinterleave(in, frames, channel, out);
+    }
+
+    __attribute__((target("avx2")))
+    void
+    toInt16(float const * in,
+            std::size_t   count,
+            qint16      * out)
+    {
+      auto const lo    = _mm256_set1_ps(-1.0f);
+      auto const hi    = _mm256_set1_ps( 1.0f);
+      auto const scale = _mm256_set1_ps(FULL_SCALE);
+
+      for (; count >= 16; count -= 16, in += 16, out += 16)
+      {
+        auto const a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in),     lo), hi), scale);
+        auto const b = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + 8), lo), hi), scale);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_cvtps_epi32(a),
+                                                                        _mm256_cvtps_epi32(b)), UNLANE));
+      }
+
+      sse2::toInt16(in, count, out);
+    }
+
+    __attribute__((target("avx2")))
+    AudioKernels::Level
+    level(qint16 const * in,
+          std::size_t    count)
+    {
+      auto const zero = _mm256_setzero_si256();
+      auto       sum  = _mm256_setzero_si256();
+      auto       max  = _mm256_setzero_si256();
+      auto       min  = _mm256_setzero_si256();
+
+      for (; count >= 16; count -= 16, in += 16)
+      {
+        auto const s  = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in));
+        auto const sq = _mm256_madd_epi16(s, s);
+
+        sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(sq, zero));
+        sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(sq, zero));
+        max = _mm256_max_epi16(max, s);
+        min = _mm256_min_epi16(min, s);
+      }
+
+      alignas(32) quint64 sums[4];
+      alignas(32) qint16  maxs[16];
+      alignas(32) qint16  mins[16];
+
+      _mm256_store_si256(reinterpret_cast<__m256i *>(sums), sum);
+      _mm256_store_si256(reinterpret_cast<__m256i *>(maxs), max);
+      _mm256_store_si256(reinterpret_cast<__m256i *>(mins), min);
+
+      AudioKernels::Level level;
+
+      for (auto const value : sums) level.sumOfSquares += value;
+      for (auto const value : maxs) level.peak = std::max(level.peak,  int(value));
+      for (auto const value : mins) level.peak = std::max(level.peak, -int(value));
+
+      auto const rest = sse2::level(in, count);
+
+      level.sumOfSquares += rest.sumOfSquares;
+      level.peak          = std::max(level.peak, rest.peak);
+
+      return level;
+    }
+  }
+#endif
+
+  /****************************************************************************/
+  // NEON; always there on AArch64, and on 32-bit ARM where the processor has
+  // it, e.g., armhf on a Cortex-A7 or later. Only what's in both the A64 and
+  // the A32 instruction sets is used, other than rounding on AArch64.
+  /****************************************************************************/
+
+#if AUDIO_KERNELS_NEON
+  namespace neon
+  {
+    // Round to the nearest integer, ties to even. A32 has no instruction for
+    // it, but adding and then taking away 1.5 * 2^23 does the same for any
+    // value of less than 2^22 in magnitude, NEON always rounding to nearest.
+
+    AUDIO_KERNELS_NEON_TARGET
+    int32x4_t
+    nearest(float32x4_t const value)
+    {
+#if defined(__aarch64__) || defined(_M_ARM64)
+      return vcvtnq_s32_f32(value);
+#else
+      auto const magic = vdupq_n_f32(12582912.0f);
+      return vcvtq_s32_f32(vsubq_f32(vaddq_f32(value, magic), magic));
+#endif
+    }
+
+    AUDIO_KERNELS_NEON_TARGET
+    void
+    deinterleave(qint16 const * in,
+                 std::size_t    frames,
+                 std::size_t    channel,
+                 qint16       * out)
+    {
+      for (; frames >= 8; frames -= 8, in += 16, out += 8)
+      {
+        auto const s = vld2q_s16(in);
+        vst1q_s16(out, channel ? s.val[1] : s.val[0]);
+      }
+
+      scalar::deinterleave(in, frames, channel, out);
+    }
+
+    AUDIO_KERNELS_NEON_TARGET
+    void
+    interleave(qint16 const * in,
+               std::size_t    frames,
+               bool     const left,
+               bool     const right,
+               qint16       * out)
+    {
+      auto const l = vdupq_n_s16(left  ? -1 : 0);
+      auto const r = vdupq_n_s16(right ? -1 : 0);
+
+      for (; frames >= 8; frames -= 8, in += 8, out += 16)
+      {
+        auto const s = vld1q_s16(in);
+        vst2q_s16(out, int16x8x2_t {{vandq_s16(s, l), vandq_s16(s, r)}});
+      }
+
+      scalar::interleave(in, frames, left, right, out);
+    }
+
+    AUDIO_KERNELS_NEON_TARGET
+    void
+    toInt16(float const * in,
+            std::size_t   count,
+            qint16      * out)
+    {
+      for (; count >= 8; count -= 8, in += 8, out += 8)
+      {
+        auto const a = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(in),     vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), FULL_SCALE);
+        auto const b = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + 4), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), FULL_SCALE);
+
+        vst1q_s16(out, vcombine_s16(vqmovn_s32(nearest(a)),
+                                    vqmovn_s32(nearest(b))));
+      }
+
+      scalar::toInt16(in, count, out);
+    }
+
+    AUDIO_KERNELS_NEON_TARGET
+    void
+    toFloat(qint16 const * in,
+            std::size_t    count,
+            float        * out)
+    {
+      for (; count >= 8; count -= 8, in += 8, out += 8)
+      {
+        auto const s = vld1q_s16(in);
+
+        vst1q_f32(out,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))),  1.0f / FULL_SCALE));
+        vst1q_f32(out + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), 1.0f / FULL_SCALE));
+      }
+
+      scalar::toFloat(in, count, out);
+    }
+
+    AUDIO_KERNELS_NEON_TARGET
+    AudioKernels::Level
+    level(qint16 const * in,
+          std::size_t    count)
+    {
+      // Squares are at most 2^30, and are widened to 64 bits as they're
+      // accumulated.
+
+      auto sum = vdupq_n_u64(0);
+      auto max = vdupq_n_s16(0);
+      auto min = vdupq_n_s16(0);
+
+      for (; count >= 8; count -= 8, in += 8)
+      {
+        auto const s = vld1q_s16(in);
+
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(vmull_s16(vget_low_s16(s),  vget_low_s16(s))));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(vmull_s16(vget_high_s16(s), vget_high_s16(s))));
+        max = vmaxq_s16(max, s);
+        min = vminq_s16(min, s);
+      }
+
+      alignas(16) quint64 sums[2];
+      alignas(16) qint16  maxs[8];
+      alignas(16) qint16  mins[8];
+
+      vst1q_u64(sums, sum);
+      vst1q_s16(maxs, max);
+      vst1q_s16(mins, min);
+
+      AudioKernels::Level level;
+
+      level.sumOfSquares = sums[0] + sums[1];
+      level.peak         = std::max(int(*std::max_element(std::begin(maxs), std::end(maxs))),
+                                   -int(*std::min_element(std::begin(mins), std::end(mins))));
+
+      return scalar::level(in, count, level);
+    }
+  }
+#endif
+
+  /****************************************************************************/
+  // Dispatch
+  /****************************************************************************/
+
+  struct Table
+  {
+    char const * name;
+
+    decltype(&AudioKernels::deinterleave) deinterleave;
+    decltype(&AudioKernels::interleave)   interleave;
+    decltype(&AudioKernels::toInt16)      toInt16;
+    decltype(&AudioKernels::toFloat)      toFloat;
+    decltype(&AudioKernels::level)        level;
+  };
+
+  AudioKernels::Level
+  scalarLevel(qint16 const * in,
+              std::size_t    count)
+  {
+    return scalar::level(in, count);
+  }
+
+#if AUDIO_KERNELS_NEON
+  // Whether the processor has NEON; AArch64 always does, and 32-bit ARM
+  // built for it does, but armhf otherwise has to ask the kernel.
+
+  bool
+  hasNeon()
+  {
+#if AUDIO_KERNELS_NEON_DETECT
+    return getauxval(AT_HWCAP) & HWCAP_NEON;
+#else
+    return true;
+#endif
+  }
+#endif
+
+  // The best of the implementations that this processor can run, or the
+  // one requested in the environment, if it can run that one.
+
+  Table
+  select()
+  {
+    auto const requested = qgetenv("JS8CALL_AUDIO_KERNELS");
+
+    if (requested != "scalar")
+    {
+#if AUDIO_KERNELS_AVX2
+      if (requested != "sse2" && __builtin_cpu_supports("avx2"))
+      {
+        return {"AVX2", avx2::deinterleave, sse2::interleave, avx2::toInt16, sse2::toFloat, avx2::level};
+      }
+#endif
+#if AUDIO_KERNELS_SSE2
+      return {"SSE2", sse2::deinterleave, sse2::interleave, sse2::toInt16, sse2::toFloat, sse2::level};
+#endif
+#if AUDIO_KERNELS_NEON
+      if (hasNeon())
+      {
+        return {"NEON", neon::deinterleave, neon::interleave, neon::toInt16, neon::toFloat, neon::level};
+      }
+#endif
+    }
+
+    return {"scalar", scalar::deinterleave, scalar::interleave, scalar::toInt16, scalar::toFloat, scalarLevel};
+  }
+
+  Table const &
+  table()
+  {
+    static Table const table = []
+    {
+      auto const selected = select();
+      qDebug() << "audio kernels:" << selected.name;
+      return selected;
+    }();
+
+    return table;
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+namespace AudioKernels
+{
+  void
+  deinterleave(qint16 const * const in,
+               std::size_t    const frames,
+               std::size_t    const channel,
+               qint16       * const out)
+  {
+    table().deinterleave(in, frames, channel, out);
+  }
+
+  void
+  interleave(qint16 const * const in,
+             std::size_t    const frames,
+             bool           const left,
+             bool           const right,
+             qint16       * const out)
+  {
+    table().interleave(in, frames, left, right, out);
+  }
+
+  void
+  toInt16(float  const * const in,
+          std::size_t    const count,
+          qint16       * const out)
+  {
+    table().toInt16(in, count, out);
+  }
+
+  void
+  toFloat(qint16 const * const in,
+          std::size_t    const count,
+          float        * const out)
+  {
+    table().toFloat(in, count, out);
+  }
+
+  Level
+  level(qint16 const * const in,
+        std::size_t    const count)
+  {
+    return table().level(in, count);
+  }
+
+  char const *
+  instructionSet()
+  {
+    return table().name;
+  }
+}
+
+/******************************************************************************/
@@ -0,0 +1,76 @@
+#ifndef AUDIO_KERNELS_HPP__
+#define AUDIO_KERNELS_HPP__
+
+#include <cstddef>
+#include <QtGlobal>
+
+// Sample conversion and metering kernels for the audio paths, i.e., the
+// input path through AudioDevice and the Detector, the Modulator and the
+// notification mixer. Each is implemented in plain C++ and, where the CPU
+// has them, in SIMD instructions; SSE2, and AVX2 if the processor we find
+// ourselves running on supports it, on x86-64, and NEON on AArch64, and on
+// 32-bit ARM if the processor supports it. The implementation is chosen
+// once, on first use, and every one of them gives exactly the same results
+// as the plain C++ version.
+//
+// Setting JS8CALL_AUDIO_KERNELS to scalar, sse2, avx2 or neon in the
+// environment requests that implementation, for comparison and testing;
+// one the processor can't run is ignored.
+
+namespace AudioKernels
+{
+  // Sum of the squares of, and peak absolute value of, a run of samples.
+  // The sum is exact; the peak can be 32768, i.e., one more than qint16
+  // can hold.
+
+  struct Level
+  {
+    quint64 sumOfSquares = 0;
+    int     peak         = 0;
+  };
+
+  // Copy one channel, 0 for left or 1 for right, out of interleaved stereo
+  // frames.
+
+  void
+  deinterleave(qint16 const * in,
+               std::size_t    frames,
+               std::size_t    channel,
+               qint16       * out);
+
+  // Spread mono samples into interleaved stereo frames, placing each sample
+  // in the left channel, the right channel, or both; a channel not chosen
+  // is filled with silence.
+
+  void
+  interleave(qint16 const * in,
+             std::size_t    frames,
+             bool           left,
+             bool           right,
+             qint16       * out);
+
+  // Convert between float samples, at a full scale of 1.0, and 16-bit
+  // samples, at a full scale of 32767. Conversion to 16 bits clamps to
+  // full scale and rounds to nearest, ties to even.
+
+  void
+  toInt16(float  const * in,
+          std::size_t    count,
+          qint16       * out);
+
+  void
+  toFloat(qint16 const * in,
+          std::size_t    count,
+          float        * out);
+
+  Level
+  level(qint16 const * in,
+        std::size_t    count);
+
+  // Name of the instruction set in use.
+
+  char const *
+  instructionSet();
+}
+
+#endif
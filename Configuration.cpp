@@ -738,6 +738,21 @@ QString Configuration::notification_path(const QString &key) const {
 
     return m_->notifications_paths_.value(key, "");
 }
+QStringList Configuration::notification_paths() const {
+    QStringList paths;
+
+    if(!m_->enable_notifications_){
+        return paths;
+    }
+
+    for(auto it = m_->notifications_paths_.constBegin(); it != m_->notifications_paths_.constEnd(); ++it){
+        if(m_->notifications_enabled_.value(it.key(), false) && !it.value().isEmpty() && !paths.contains(it.value())){
+            paths.append(it.value());
+        }
+    }
+
+    return paths;
+}
 bool Configuration::restart_audio_input () const {return m_->restart_sound_input_device_;}
 bool Configuration::restart_audio_output () const {return m_->restart_sound_output_device_;}
 bool Configuration::restart_notification_audio_output () const {return m_->restart_notification_sound_output_device_;}
@@ -89,6 +89,7 @@ public:
 
   bool notifications_enabled() const;
   QString notification_path(const QString &key) const;
+  QStringList notification_paths() const;
   Q_SIGNAL void test_notify(const QString &key);
 
   // These query methods should be used after a call to exec() to
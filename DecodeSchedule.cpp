@@ -0,0 +1,235 @@
+#include "DecodeSchedule.hpp"
+#include <algorithm>
+#include "JS8Submode.hpp"
+#include "varicode.h"
+
+/******************************************************************************/
+// Local Constants
+/******************************************************************************/
+
+namespace
+{
+  constexpr qint64 SECOND = JS8_RX_SAMPLE_RATE;
+  constexpr qint64 RING   = JS8_RX_SAMPLE_SIZE;
+
+  // Spans at the start of a cycle, and before its symbols are complete,
+  // during which we decode.
+
+  constexpr qint64 EARLY = 3 * SECOND / 2;
+  constexpr qint64 LATE  = 3 * SECOND / 2;
+
+  // Frames between the starts of successive decodes of a submode.
+
+  constexpr qint64 CADENCE = SECOND;
+
+  // A move of more than this many frames isn't the detector progressing
+  // normally; we'd be guessing as to how many times the ring had wrapped,
+  // so start over instead.
+
+  constexpr qint64 MAX_ADVANCE = RING / 2;
+
+  // Start of the cycle containing an unwrapped position.
+
+  constexpr qint64
+  cycleStart(qint64 const position,
+             qint64 const cycleFrames)
+  {
+    return position / cycleFrames * cycleFrames;
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+DecodeSchedule::DecodeSchedule()
+{
+  auto const entry = [](int const submode) -> Entry
+  {
+    return {submode,
+            JS8::Submode::framesPerCycle(submode),
+            EARLY,
+            JS8::Submode::framesForSymbols(submode) - LATE,
+            false,
+            0,
+            NONE};
+  };
+
+  m_entries = {
+    entry(Varicode::JS8CallSlow),
+    entry(Varicode::JS8CallNormal),
+    entry(Varicode::JS8CallFast),
+    entry(Varicode::JS8CallTurbo),
+#if JS8_ENABLE_JS8I
+    entry(Varicode::JS8CallUltra),
+#endif
+  };
+}
+
+void
+DecodeSchedule::reset()
+{
+  m_base = -1;
+  m_k    = -1;
+  m_next = NONE;
+}
+
+void
+DecodeSchedule::setContinuous(int  const submode,
+                              bool const continuous)
+{
+  for (auto & entry : m_entries)
+  {
+    if (entry.submode == submode && entry.continuous != continuous)
+    {
+      entry.continuous = continuous;
+
+      if (m_k >= 0)
+      {
+        schedule(entry);
+        update();
+      }
+    }
+  }
+}
+
+bool
+DecodeSchedule::due(qint32 const k) const
+{
+  if (m_k < 0) return true;
+
+  return m_base + k + (k < m_k ? RING : 0) >= m_next;
+}
+
+QList<DecodeSchedule::Window>
+DecodeSchedule::advance(qint32 const k)
+{
+  if (m_k < 0)
+  {
+    sync(k);
+  }
+  else if (auto const delta = k - m_k + (k < m_k ? RING : 0);
+                      delta > MAX_ADVANCE)
+  {
+    sync(k);
+  }
+  else
+  {
+    if (k < m_k) m_base += RING;
+    m_k = k;
+  }
+
+  auto const position = m_base + k;
+
+  if (position < m_next) return {};
+
+  QList<Window> windows;
+
+  for (auto & entry : m_entries)
+  {
+    if (entry.due > position) continue;
+
+    if (entry.continuous)
+    {
+      // The most recent cycle's worth of frames, ending here.
+
+      auto const start = k - entry.cycleFrames;
+
+      windows.append({entry.submode,
+                      static_cast<qint32>(start < 0 ? start + RING : start),
+                      static_cast<qint32>(entry.cycleFrames)});
+    }
+    else
+    {
+      // The cycle so far; the ring is a whole number of cycles, so the
+      // cycle can't straddle the start of the ring.
+
+      auto const start  = cycleStart(position, entry.cycleFrames);
+      auto const offset = position - start;
+
+      if (offset >= entry.early && offset < entry.late)
+      {
+        // We've arrived in the middle of the cycle, e.g., following a
+        // stall; nothing to do until its end is approaching.
+
+        entry.due = start + entry.late;
+        continue;
+      }
+
+      windows.append({entry.submode,
+                      static_cast<qint32>(start - m_base),
+                      static_cast<qint32>(offset)});
+    }
+
+    entry.last = position;
+    schedule(entry);
+  }
+
+  update();
+
+  return windows;
+}
+
+qint64
+DecodeSchedule::framesUntilNext() const
+{
+  if (m_k < 0) return -1;
+
+  return std::max(qint64{0}, m_next - (m_base + m_k));
+}
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+// Take up a position in the ring from scratch; as if each submode had last
+// decoded at the start of its current cycle.
+
+void
+DecodeSchedule::sync(qint32 const k)
+{
+  m_base = 0;
+  m_k    = k;
+
+  for (auto & entry : m_entries)
+  {
+    entry.last = cycleStart(k, entry.cycleFrames);
+    schedule(entry);
+  }
+
+  update();
+}
+
+// Determine the earliest position, at least a cadence past the last decode,
+// at which an entry's next decode is due.
+
+void
+DecodeSchedule::schedule(Entry & entry)
+{
+  auto const earliest = entry.last + CADENCE;
+
+  if (entry.continuous)
+  {
+    entry.due = earliest;
+    return;
+  }
+
+  auto const start  = cycleStart(earliest, entry.cycleFrames);
+  auto const offset = earliest - start;
+
+  entry.due = (offset >= entry.early && offset < entry.late)
+            ? start + entry.late
+            : earliest;
+}
+
+void
+DecodeSchedule::update()
+{
+  m_next = std::min_element(m_entries.begin(), m_entries.end(), [](auto const & a,
+                                                                   auto const & b)
+  {
+    return a.due < b.due;
+  })->due;
+}
+
+/******************************************************************************/
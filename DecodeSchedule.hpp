@@ -0,0 +1,93 @@
+#ifndef DECODE_SCHEDULE_HPP__
+#define DECODE_SCHEDULE_HPP__
+
+#include <array>
+#include <limits>
+#include <QList>
+#include <QtGlobal>
+#include "commons.h"
+
+class DecodeSchedule
+{
+  // The detector hands us its position in the sample ring, which wraps
+  // every JS8_RX_SAMPLE_SIZE frames, i.e., on the minute, midnight being
+  // nothing special in that regard. Each submode divides the ring into
+  // cycles, and within each cycle there's a span near the end, where the
+  // symbols of a transmission should have arrived, and a span at the
+  // start, where stragglers may still be arriving, during which we try
+  // to decode once a second. Submodes being autosynced are decoded once
+  // a second throughout, over the most recent cycle's worth of frames.
+  //
+  // Rather than work all of that out for every submode each time the
+  // detector moves, we unwrap its position into a count of frames that
+  // only ever increases, precompute the cycle layout of each submode,
+  // and keep for each submode the position at which it's next due. The
+  // earliest of those is the only thing the caller needs to look at as
+  // frames arrive; nothing else happens until it's been reached.
+
+  struct Entry
+  {
+    int    submode;
+    qint64 cycleFrames;
+    qint64 early;         // decode through this offset into a cycle
+    qint64 late;          // and again from this offset onward
+    bool   continuous;    // decode every second, ignoring the above
+    qint64 last;          // position of the last decode
+    qint64 due;           // position at which the next decode is due
+  };
+
+  static constexpr qint64 NONE = std::numeric_limits<qint64>::max();
+
+#if JS8_ENABLE_JS8I
+  std::array<Entry, 5> m_entries;
+#else
+  std::array<Entry, 4> m_entries;
+#endif
+
+  qint64 m_base = -1;     // unwrapped position of the start of the ring
+  qint32 m_k    = -1;     // last ring position seen, or -1 if not synced
+  qint64 m_next = NONE;   // earliest due position across all submodes
+
+  void sync(qint32 k);
+  void schedule(Entry &);
+  void update();
+
+public:
+
+  struct Window
+  {
+    int    submode;
+    qint32 start;   // ring position
+    qint32 sz;      // frames, possibly wrapping the ring
+  };
+
+  DecodeSchedule();
+
+  // Forget where we are; the next position provided is taken to be the
+  // first, as it should be after the detector has been repositioned in
+  // the ring, e.g., on a change of drift, or after monitoring resumes.
+
+  void reset();
+
+  // Switch a submode between cycle-relative and continuous decoding;
+  // cheap if it's unchanged.
+
+  void setContinuous(int submode, bool continuous);
+
+  // Returns true if the provided ring position has reached the next due
+  // window; if not, there's nothing to be done for it.
+
+  bool due(qint32 k) const;
+
+  // Move to the provided ring position, returning the windows that have
+  // become due, if any.
+
+  QList<Window> advance(qint32 k);
+
+  // Frames until the next window is due, as of the last position seen,
+  // or -1 if we're not synced to a position yet.
+
+  qint64 framesUntilNext() const;
+};
+
+#endif
@@ -1,8 +1,10 @@
 #include "Detector.hpp"
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include <QDateTime>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QMutexLocker>
 #include <QtAlgorithms>
 #include "commons.h"
@@ -135,7 +137,20 @@ qint64
 Detector::writeData(char const * const data,
                     qint64       const maxSize)
 {
-  QMutexLocker mutex(&m_lock);
+  // The lock should only ever be held by others for moments; if it's not
+  // free, note how long we wait for it. The longest wait is reported once
+  // per period, since anything more than a small fraction of the time a
+  // buffer represents will show up as audio overruns.
+
+  std::unique_lock mutex(m_lock, std::try_to_lock);
+
+  if (!mutex.owns_lock())
+  {
+    QElapsedTimer timer;
+    timer.start();
+    mutex.lock();
+    m_longestWait = std::max(m_longestWait, timer.nsecsElapsed());
+  }
 
   // When ns has wrapped around to zero, restart the buffers.
 
@@ -143,6 +158,12 @@ Detector::writeData(char const * const data,
   if(ns < m_ns) {
     dec_data.params.kin = 0;
     m_bufferPos         = 0;
+
+    if (m_longestWait)
+    {
+      qDebug() << "detector waited at most" << m_longestWait / 1000 << "us for the lock during the last period";
+      m_longestWait = 0;
+    }
   }
   m_ns = ns;
 
@@ -127,6 +127,7 @@ private:
   Buffer::size_type m_bufferPos     = 0;
   std::size_t       m_samplesPerFFT = MaxBufferSize;
   qint32            m_ns            = 999;
+  qint64            m_longestWait   = 0;   // ns, audio thread only
 };
 
 #endif
@@ -48,4 +48,10 @@ namespace DriftingDateTime
     {
         return currentMSecsSinceEpoch() / 1000;
     }
+
+    UtcTime
+    currentUtc()
+    {
+        return UtcTime(currentMSecsSinceEpoch());
+    }
 }
\ No newline at end of file
@@ -1,7 +1,78 @@
 #ifndef DRIFTINGDATETIME_H
 #define DRIFTINGDATETIME_H
 
+#include <compare>
+#include <limits>
 #include <QDateTime>
+#include <QTimeZone>
+
+// A UTC instant, as integer milliseconds since the epoch. Cheap to take,
+// copy, compare and do arithmetic on, where a QDateTime carries shared,
+// time zone aware data along with it; convert to a QDateTime only to show
+// or serialize one. Default constructed, it's invalid, as a null QDateTime
+// would be, and orders before any valid instant.
+
+class UtcTime
+{
+public:
+    constexpr UtcTime() = default;
+    constexpr explicit UtcTime(qint64 const msecs) : m_msecs(msecs) {}
+
+    static UtcTime
+    fromDateTime(QDateTime const &dateTime)
+    {
+        return dateTime.isValid() ? UtcTime(dateTime.toMSecsSinceEpoch()) : UtcTime();
+    }
+
+    QDateTime
+    toDateTime() const
+    {
+        return isValid() ? QDateTime::fromMSecsSinceEpoch(m_msecs, QTimeZone::utc()) : QDateTime();
+    }
+
+    constexpr bool   isValid()           const { return m_msecs != INVALID; }
+    constexpr qint64 toMSecsSinceEpoch() const { return m_msecs; }
+
+    // As with QDateTime, the interval to or from an invalid instant is zero,
+    // and seconds are truncated toward zero.
+
+    constexpr qint64
+    msecsTo(UtcTime const other) const
+    {
+        return isValid() && other.isValid() ? other.m_msecs - m_msecs : 0;
+    }
+
+    constexpr qint64 secsTo(UtcTime const other) const { return msecsTo(other) / 1000; }
+
+    constexpr UtcTime
+    addMSecs(qint64 const msecs) const
+    {
+        return isValid() ? UtcTime(m_msecs + msecs) : UtcTime();
+    }
+
+    constexpr UtcTime addSecs(qint64 const secs) const { return addMSecs(secs * 1000); }
+
+    // Time of day; UTC has no leap seconds as far as the epoch is concerned.
+
+    constexpr int
+    msecsSinceStartOfDay() const
+    {
+        auto const ms = m_msecs % MSECS_PER_DAY;
+        return static_cast<int>(ms < 0 ? ms + MSECS_PER_DAY : ms);
+    }
+
+    constexpr int hour()   const { return msecsSinceStartOfDay() / 3600000; }
+    constexpr int minute() const { return msecsSinceStartOfDay() / 60000 % 60; }
+    constexpr int second() const { return msecsSinceStartOfDay() / 1000 % 60; }
+
+    constexpr auto operator<=>(UtcTime const &) const = default;
+
+private:
+    static constexpr qint64 INVALID       = std::numeric_limits<qint64>::min();
+    static constexpr qint64 MSECS_PER_DAY = 86400000;
+
+    qint64 m_msecs = INVALID;
+};
 
 namespace DriftingDateTime /*: QDateTime*/
 {
@@ -12,6 +83,7 @@ namespace DriftingDateTime /*: QDateTime*/
     QDateTime currentDateTimeUtc();
     qint64    currentMSecsSinceEpoch();
     qint64    currentSecsSinceEpoch();
+    UtcTime   currentUtc();
 };
 
 #endif // DRIFTINGDATETIME_H
@@ -341,6 +341,21 @@ namespace
   }
 }
 
+/******************************************************************************/
+// Vector Cache
+/******************************************************************************/
+
+namespace
+{
+  // Two-level cache of vectors, the first level keyed by origin, the second
+  // by remote; see vector() below for the rationale.
+
+  using Cache = QCache<QString, Geodesic::Vector>;
+
+  QMutex                 cacheMutex;
+  QCache<QString, Cache> caches;
+}
+
 /******************************************************************************/
 // Public Implementation
 /******************************************************************************/
@@ -437,12 +452,7 @@ namespace Geodesic
   vector(QStringView const origin,
          QStringView const remote)
   {
-    using Cache = QCache<QString, Vector>;
-
-    static QMutex                 mutex;
-    static QCache<QString, Cache> caches;
-
-    QMutexLocker lock(&mutex);
+    QMutexLocker lock(&cacheMutex);
 
     // Caller is expected to hand us a lot of garbage; it's literally the
     // common case. Prior to getting too far into the weeds here, a quick
@@ -495,6 +505,33 @@ namespace Geodesic
 
     return vector;
   }
+
+  // Report on the vector cache; every cached vector is a separate allocation,
+  // held by a QCache node along with its key.
+
+  MemoryAccounting::Usage
+  cacheUsage()
+  {
+    QMutexLocker lock(&cacheMutex);
+
+    MemoryAccounting::Usage usage;
+
+    for (auto const & origin : caches.keys())
+    {
+      usage.bytes += sizeof(Cache) + MemoryAccounting::heap(origin);
+
+      if (auto const cache = caches.object(origin))
+      {
+        for (auto const & remote : cache->keys())
+        {
+          usage.count += 1;
+          usage.bytes += 4 * sizeof(void *) + sizeof(QString) + sizeof(Vector) + MemoryAccounting::heap(remote);
+        }
+      }
+    }
+
+    return usage;
+  }
 }
 
 /******************************************************************************/
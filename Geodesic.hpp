@@ -2,6 +2,7 @@
 #include <utility>
 #include <QString>
 #include <QStringView>
+#include "MemoryAccounting.hpp"
 
 namespace Geodesic
 {
@@ -174,4 +175,9 @@ namespace Geodesic
   Vector
   vector(QStringView origin,
          QStringView remote);
+
+  // Number of vectors cached by the above, and the memory they're using.
+
+  MemoryAccounting::Usage
+  cacheUsage();
 }
\ No newline at end of file
@@ -76,13 +76,19 @@ bool Inbox::isOpen(){
     return db_ != nullptr;
 }
 
-bool Inbox::open(){
+bool Inbox::open(int busyTimeoutMs){
     int rc = sqlite3_open(path_.toLocal8Bit().data(), &db_);
     if(rc != SQLITE_OK){
         close();
         return false;
     }
 
+    // the inbox may be read on a worker while the GUI thread writes to it;
+    // wait out the other connection's lock rather than failing outright.
+    // a worker that mustn't wait long asks for a shorter timeout, and
+    // checks isBusy() to tell a lock from an empty result
+    sqlite3_busy_timeout(db_, busyTimeoutMs);
+
     rc = sqlite3_exec(db_, SCHEMA, nullptr, nullptr, nullptr);
     if(rc != SQLITE_OK){
         return false;
@@ -98,6 +104,10 @@ void Inbox::close(){
     }
 }
 
+bool Inbox::isBusy(){
+    return db_ && sqlite3_errcode(db_) == SQLITE_BUSY;
+}
+
 QString Inbox::error(){
     if(db_){
         return QString::fromLocal8Bit(sqlite3_errmsg(db_));
@@ -322,6 +332,86 @@ QPair<int, Message> Inbox::firstUnreadFrom(QString from){
     return v.first();
 }
 
+QList<QPair<int, QByteArray>> Inbox::conversation(QString call, int after, int before, int limit){
+    if(!isOpen()){
+        return {};
+    }
+
+    // the primary key provides the order and the bounds, so a page costs
+    // the same wherever it falls in the inbox
+    const char* sql = "SELECT id, blob FROM inbox_v1 "
+                      "WHERE id > ? AND id < ? "
+                      "AND ((json_extract(blob, '$.type') = 'STORE' AND json_extract(blob, '$.params.TO') LIKE ?) "
+                      "  OR (json_extract(blob, '$.type') IN ('READ', 'UNREAD') AND json_extract(blob, '$.params.FROM') LIKE ?)) "
+                      "ORDER BY id DESC "
+                      "LIMIT ?;";
+
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
+    if(rc != SQLITE_OK){
+        return {};
+    }
+
+    auto c8 = call.toLocal8Bit();
+    rc = sqlite3_bind_int(stmt, 1, after);
+    rc = sqlite3_bind_int(stmt, 2, before);
+    rc = sqlite3_bind_text(stmt, 3, c8.data(), -1, nullptr);
+    rc = sqlite3_bind_text(stmt, 4, c8.data(), -1, nullptr);
+    rc = sqlite3_bind_int(stmt, 5, limit);
+
+    QList<QPair<int, QByteArray>> v;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        v.append({
+            sqlite3_column_int(stmt, 0),
+            QByteArray((const char *)sqlite3_column_text (stmt, 1),
+                                     sqlite3_column_bytes(stmt, 1))
+        });
+    }
+
+    rc = sqlite3_finalize(stmt);
+    if(rc != SQLITE_OK){
+        return {};
+    }
+
+    return v;
+}
+
+QSet<int> Inbox::markReadFrom(QString from){
+    if(!isOpen()){
+        return {};
+    }
+
+    const char* sql = "UPDATE inbox_v1 SET blob = json_set(blob, '$.type', 'READ') "
+                      "WHERE json_extract(blob, '$.type') = 'UNREAD' "
+                      "AND json_extract(blob, '$.params.FROM') LIKE ? "
+                      "RETURNING id;";
+
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
+    if(rc != SQLITE_OK){
+        return {};
+    }
+
+    auto f8 = from.toLocal8Bit();
+    rc = sqlite3_bind_text(stmt, 1, f8.data(), -1, nullptr);
+
+    QSet<int> ids;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        ids.insert(sqlite3_column_int(stmt, 0));
+    }
+
+    rc = sqlite3_finalize(stmt);
+    if(rc != SQLITE_OK){
+        return {};
+    }
+
+    return ids;
+}
+
 QMap<QString, int> Inbox::getGroupMessageCounts()
 {
 	if(!isOpen()){
@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QString>
 #include <QPair>
+#include <QSet>
 #include <QVariant>
 
 #include "vendor/sqlite3/sqlite3.h"
@@ -23,9 +24,13 @@ public:
 
     // Low-Level Interface
     bool isOpen();
-    bool open();
+    bool open(int busyTimeoutMs = 2000);
     void close();
     QString error();
+
+    // Whether the last statement failed because another connection held a
+    // lock for longer than the busy timeout.
+    bool isBusy();
     int count(QString type, QString query, QString match);
     QList<QPair<int, Message>> values(QString type, QString query, QString match, int offset, int limit);
     Message value(int key);
@@ -37,6 +42,14 @@ public:
     int countUnreadFrom(QString from);
     QPair<int, Message> firstUnreadFrom(QString from);
 
+    // Messages stored for a callsign, or read or unread from it, with ids in
+    // the open interval (after, before), newest first, as undecoded JSON;
+    // for keyset pagination, in either direction, from a known id.
+    QList<QPair<int, QByteArray>> conversation(QString call, int after, int before, int limit);
+
+    // Mark all unread messages from a callsign as read, returning their ids.
+    QSet<int> markReadFrom(QString from);
+
 	QMap<QString, int> getGroupMessageCounts();
 	int getNextGroupMessageIdForCallsign(const QString &group_name, const QString &callsign);
 	bool markGroupMsgDeliveredForCallsign(int msgId, QString callsign);
@@ -5,18 +5,22 @@
 #include "JS8.hpp"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <complex>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <optional>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -30,6 +34,7 @@
 #include <vendor/Eigen/Dense>
 #include <QDebug>
 #include "commons.h"
+#include "JS8Metrics.hpp"
 
 // A C++ conversion of the Fortran JS8 encoding and decoder function.
 // Some notes on the conversion:
@@ -189,6 +194,13 @@ namespace
     constexpr float       TAU      = 2.0f * M_PI;
     constexpr auto        ZERO     = std::complex<float>{0.0f, 0.0f};
 
+    // The soft symbol metrics, being in their own header, keep their own
+    // copies of the symbol counts; make sure we agree.
+
+    static_assert(JS8::Metrics::ND    == ND &&
+                  JS8::Metrics::NN    == NN &&
+                  JS8::Metrics::NROWS == NROWS);
+
     // Key for the constants that follow:
     //
     //   NSUBMODE - ID of the submode
@@ -384,6 +396,17 @@ namespace
     // coefficients, so it's critical that the degree of the polynomial is
     // odd, resulting in an even number of coefficients.
 
+    // Energy gate settings for the first-order sync search. Bins whose
+    // Costas footprint doesn't rise above the noise floor by GATE_SIGMA
+    // standard deviations, and that don't lie within GATE_GUARD signal
+    // widths of one that does, are skipped. Every GATE_STRIDE'th bin is
+    // searched regardless, providing an unbiased sample of the band for
+    // sync normalization.
+
+    constexpr auto GATE_SIGMA  = 3.0f;
+    constexpr auto GATE_GUARD  = 1;
+    constexpr auto GATE_STRIDE = 8;
+
     static_assert(BASELINE_DEGREE &  1,   "Degree must be odd");
     static_assert(BASELINE_SAMPLE >= 0 &&
                   BASELINE_SAMPLE <= 100, "Sample must be a percentage");
@@ -615,6 +638,54 @@ namespace
         >
     >;
 
+    // Accumulated energy gate statistics for syncjs8(); bins in the search
+    // range versus bins actually searched, time spent in the gated search,
+    // and, when measuring recall, candidates found by a full search versus
+    // those of them that the gated search also found.
+
+    struct GateStats
+    {
+        using Duration = std::chrono::steady_clock::duration;
+
+        std::size_t bins     = 0;
+        std::size_t searched = 0;
+        std::size_t expected = 0;
+        std::size_t recalled = 0;
+        Duration    gated    = Duration::zero();
+        Duration    complete = Duration::zero();
+    };
+
+    // A candidate that passed the sync quality check, but that BP couldn't
+    // decode; we retain enough of it to try ordered statistics decoding on
+    // it later, and to complete the decode should that succeed. The weight
+    // is the best syndrome weight any of the BP attempts achieved, and the
+    // LLRs are those of the attempt that achieved it.
+
+    struct NearMiss
+    {
+        int                                      weight;
+        float                                    f1;
+        float                                    xdt;
+        float                                    sync;
+        float                                    xbase;
+        std::array<float, N>                     llr;
+        std::array<std::array<float, NN>, NROWS> s2;
+    };
+
+    // Accumulated ordered statistics decoding statistics; near misses we
+    // tried, those we didn't get to within the budget, those that decoded,
+    // and the time spent.
+
+    struct OSDStats
+    {
+        using Duration = std::chrono::steady_clock::duration;
+
+        std::size_t attempts = 0;
+        std::size_t skipped  = 0;
+        std::size_t decoded  = 0;
+        Duration    elapsed  = Duration::zero();
+    };
+
     // Represents a decoded message, i.e., the 3-bit message type
     // and the 12 bytes that result from decoding a message.
 
@@ -657,6 +728,51 @@ namespace
     constexpr int BP_MAX_ROWS       = 7;  // Max rows per column in Nm
     constexpr int BP_MAX_CHECKS     = 3;  // Max checks per bit in Mn
     constexpr int BP_MAX_ITERATIONS = 30; // Max iterations in BP decoder
+    constexpr int BP_MAX_PASSES     = 4;  // LLR variants tried per candidate
+
+    // Early abort settings for the BP decoder. Once BP_ABORT_MIN iterations
+    // have run, an attempt that still has more than BP_ABORT_WEIGHT checks
+    // unsatisfied is abandoned if either its syndrome weight hasn't bettered
+    // its best for BP_ABORT_STALL iterations, or its hard decisions haven't
+    // changed for that long; in the latter case it's settled into a trapping
+    // set that further iterations aren't going to get it out of.
+
+    constexpr int BP_ABORT_MIN    = 5;
+    constexpr int BP_ABORT_STALL  = 5;
+    constexpr int BP_ABORT_WEIGHT = 15;
+
+    // Convergence record of a single BP attempt; iterations run, syndrome
+    // weight at the start and at its best, and the iteration on which the
+    // early abort criteria were first met, if they were, whether or not we
+    // actually aborted.
+
+    struct BPTrace
+    {
+        int iterations = 0;
+        int initial    = 0;
+        int best       = 0;
+        int abortable  = 0;
+
+        bool progressed() const { return best < initial; }
+    };
+
+    // Accumulated BP statistics, by pass; attempts made, histogram of the
+    // iterations they ran, those that decoded, were aborted, or skipped by
+    // triage, and, when measuring, decodes that early abort or triage would
+    // have cost us.
+
+    struct BPStats
+    {
+        template <typename T>
+        using ByPass = std::array<T, BP_MAX_PASSES>;
+
+        ByPass<std::array<std::size_t, BP_MAX_ITERATIONS + 2>> iterations = {};
+        ByPass<std::size_t>                                    attempts   = {};
+        ByPass<std::size_t>                                    decoded    = {};
+        ByPass<std::size_t>                                    aborted    = {};
+        ByPass<std::size_t>                                    skipped    = {};
+        ByPass<std::size_t>                                    lost       = {};
+    };
 
     constexpr std::array<std::array<int, BP_MAX_CHECKS>, N> Mn =
     {{
@@ -735,7 +851,9 @@ namespace
     int
     bpdecode174(std::array<float, N> const & llr,
                 std::array<int8_t, K>      & decoded,
-                std::array<int8_t, N>      & cw)
+                std::array<int8_t, N>      & cw,
+                bool                 const   earlyAbort,
+                BPTrace                    & trace)
     {
         // Initialize messages and variables
         std::array<std::array<float, BP_MAX_CHECKS>, N> tov     = {}; // Messages to variable nodes
@@ -747,6 +865,10 @@ namespace
 
         int ncnt   = 0;
         int nclast = 0;
+        int stall  = 0; // Iterations since the syndrome weight last improved
+        int still  = 0; // Iterations since a hard decision last flipped
+
+        trace = {};
 
         // Initialize toc (messages from bits to checks)
         for (int i = 0; i < M; ++i) {
@@ -762,8 +884,14 @@ namespace
                 zn[i] = llr[i] + std::accumulate(tov[i].begin(), tov[i].begin() + BP_MAX_CHECKS, 0.0f);
             }
 
-            // Check if we have a valid codeword
-            for (int i = 0; i < N; ++i) cw[i] = zn[i] > 0 ? 1 : 0;
+            // Check if we have a valid codeword, noting how many hard
+            // decisions have changed since the previous iteration.
+            int flips = 0;
+            for (int i = 0; i < N; ++i) {
+                int8_t const bit = zn[i] > 0 ? 1 : 0;
+                if (iter > 0 && bit != cw[i]) ++flips;
+                cw[i] = bit;
+            }
 
             int ncheck = 0;
             for (int i = 0; i < M; ++i) {
@@ -774,6 +902,16 @@ namespace
                 if (synd[i] % 2 != 0) ++ncheck;
             }
 
+            // Track convergence.
+            trace.iterations = iter + 1;
+            if (iter == 0) {
+                trace.initial = trace.best = ncheck;
+            } else {
+                stall = (ncheck < trace.best) ? 0 : stall + 1;
+                still = (flips  == 0)         ? still + 1 : 0;
+                trace.best = std::min(trace.best, ncheck);
+            }
+
             if (ncheck == 0)
             {
                 // Extract decoded bits (last N-M bits of codeword)
@@ -800,6 +938,18 @@ namespace
             }
             nclast = ncheck;
 
+            // Early abort criteria; when measuring, just note that we
+            // could have, and carry on.
+            if (trace.abortable == 0         &&
+                iter   >= BP_ABORT_MIN       &&
+                ncheck >  BP_ABORT_WEIGHT    &&
+                (stall >= BP_ABORT_STALL || still >= BP_ABORT_STALL)) {
+                trace.abortable = trace.iterations;
+                if (earlyAbort) {
+                    return -1;
+                }
+            }
+
             // Send messages from bits to check nodes
             for (int i = 0; i < M; ++i) {
                 for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
@@ -1061,6 +1211,306 @@ namespace
     }();
 }
 
+/******************************************************************************/
+// Ordered Statistics Decoder
+/******************************************************************************/
+
+namespace
+{
+    constexpr int OSD_MAX_WEIGHT     = 20; // Max BP syndrome weight worth trying
+    constexpr int OSD_MAX_HARDERRORS = 30; // Max hard errors in an accepted result
+
+    // Codewords, and rows of the generator matrix, as packed bits.
+
+    using OSDRow = std::array<std::uint64_t, (N + 63) / 64>;
+
+    inline bool test(OSDRow const & row, int const bit) { return (row[bit / 64] >> (bit % 64)) & 1; }
+    inline void set (OSDRow       & row, int const bit) { row[bit / 64] |= std::uint64_t{1} << (bit % 64); }
+
+    inline OSDRow
+    operator^(OSDRow const & a,
+              OSDRow const & b)
+    {
+        OSDRow c;
+        for (std::size_t i = 0; i < c.size(); ++i) c[i] = a[i] ^ b[i];
+        return c;
+    }
+
+    // Generator matrix for the (174,87) code, in systematic form; row j is
+    // the codeword for message bit j alone, i.e., the 87 parity bits given
+    // by column j of the parity matrix, followed by the identity.
+
+    auto const generator = []()
+    {
+        std::array<OSDRow, K> rows = {};
+
+        for (int j = 0; j < K; ++j)
+        {
+            for (int i = 0; i < M; ++i)
+            {
+                if (parity(i, j)) set(rows[j], i);
+            }
+
+            set(rows[j], M + j);
+        }
+
+        return rows;
+    }();
+
+    // Ordered statistics decoder; a last resort for candidates that BP was
+    // unable to decode. We order the bits by decreasing reliability, find
+    // the most reliable basis, i.e., the 87 most reliable bits that can be
+    // independently specified, by Gaussian elimination of the generator,
+    // and re-encode the hard decisions on it. At depth 1, we additionally
+    // try every single bit flip of the basis, and at depth 2 every pair,
+    // keeping the codeword at the least soft distance from what we received.
+    //
+    // Depth 2 is about 3800 candidate codewords; if the deadline passes
+    // while we're working through them, we make do with what we've found.
+    //
+    // Returns the number of hard errors in the codeword chosen; the caller
+    // must decide if it's to be believed.
+
+    int
+    osd174(std::array<float, N>                  const & llr,
+           int                                   const   depth,
+           std::chrono::steady_clock::time_point const   deadline,
+           std::array<int8_t, K>                       & decoded,
+           std::array<int8_t, N>                       & cw)
+    {
+        // Bit positions, in order of decreasing reliability, and the hard
+        // decisions and reliabilities in that order.
+
+        std::array<int, N> order;
+
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&llr](int const a,
+                                                            int const b)
+        {
+            return std::abs(llr[a]) > std::abs(llr[b]);
+        });
+
+        OSDRow               hard = {};
+        std::array<float, N> reliability;
+
+        for (int c = 0; c < N; ++c)
+        {
+            reliability[c] = std::abs(llr[order[c]]);
+            if (llr[order[c]] > 0.0f) set(hard, c);
+        }
+
+        // Generator, columns in reliability order, reduced such that each
+        // row has a pivot column, in which no other row has a bit set.
+
+        std::array<OSDRow, K> g = {};
+        std::array<int,    K> pivot;
+
+        for (int r = 0; r < K; ++r)
+        {
+            for (int c = 0; c < N; ++c)
+            {
+                if (test(generator[r], order[c])) set(g[r], c);
+            }
+        }
+
+        int rank = 0;
+
+        for (int c = 0; c < N && rank < K; ++c)
+        {
+            int p = rank;
+
+            while (p < K && !test(g[p], c)) ++p;
+
+            if (p == K) continue;
+
+            std::swap(g[p], g[rank]);
+
+            for (int q = 0; q < K; ++q)
+            {
+                if (q != rank && test(g[q], c)) g[q] = g[q] ^ g[rank];
+            }
+
+            pivot[rank++] = c;
+        }
+
+        if (rank < K) return -1;
+
+        // Soft distance of a codeword from the hard decisions, expressed as
+        // the pattern of bits on which they differ.
+
+        auto const distance = [&reliability](OSDRow const & errors)
+        {
+            float sum = 0.0f;
+
+            for (std::size_t w = 0; w < errors.size(); ++w)
+            {
+                for (auto bits = errors[w]; bits; bits &= bits - 1)
+                {
+                    sum += reliability[w * 64 + std::countr_zero(bits)];
+                }
+            }
+
+            return sum;
+        };
+
+        // Order 0; the hard decisions on the basis, re-encoded. Flipping the
+        // basis bit of row r flips the codeword bits of row r, so the error
+        // patterns of the higher orders follow from that of order 0.
+
+        OSDRow encoded = {};
+
+        for (int r = 0; r < K; ++r)
+        {
+            if (test(hard, pivot[r])) encoded = encoded ^ g[r];
+        }
+
+        auto const errors = encoded ^ hard;
+        auto       best   = errors;
+        float      dbest  = distance(errors);
+
+        auto const consider = [&](OSDRow const & candidate)
+        {
+            if (float const d = distance(candidate); d < dbest)
+            {
+                dbest = d;
+                best  = candidate;
+            }
+        };
+
+        for (int r = 0; depth >= 1 && r < K; ++r)
+        {
+            consider(errors ^ g[r]);
+        }
+
+        for (int r = 0; depth >= 2 && r < K; ++r)
+        {
+            if (std::chrono::steady_clock::now() > deadline) break;
+
+            auto const single = errors ^ g[r];
+
+            for (int s = r + 1; s < K; ++s) consider(single ^ g[s]);
+        }
+
+        // Back to the original bit order.
+
+        auto const codeword = hard ^ best;
+
+        for (int c = 0; c < N; ++c) cw[order[c]] = test(codeword, c);
+
+        std::copy(cw.begin() + M, cw.end(), decoded.begin());
+
+        int nharderrors = 0;
+
+        for (auto const word : best) nharderrors += std::popcount(word);
+
+        return nharderrors;
+    }
+}
+
+/******************************************************************************/
+// A Priori Decoding
+/******************************************************************************/
+
+namespace
+{
+    using Hint = dec_data::dec_params::dec_hint;
+
+    constexpr float AP_MAX_OFFSET     = 10.0f; // Max Hz between a candidate and a hint
+    constexpr int   AP_MAX_HARDERRORS = 30;    // Max hard errors in an accepted result
+
+    // Accumulated a priori decoding statistics; candidates we tried a hint
+    // on, those that decoded, and those that BP converged on, but that we
+    // didn't believe.
+
+    struct APStats
+    {
+        std::size_t attempts = 0;
+        std::size_t decoded  = 0;
+        std::size_t rejected = 0;
+    };
+
+    // Returns the hint for the submode closest in frequency to a candidate,
+    // if any is close enough to be worth trying.
+
+    Hint const *
+    findHint(dec_data::dec_params const & params,
+             int                  const   submode,
+             float                const   f1)
+    {
+        Hint const * best = nullptr;
+
+        for (int i = 0; i < std::min(params.nhints, JS8_AP_MAX_HINTS); ++i)
+        {
+            auto const & hint = params.hints[i];
+
+            if (hint.submode != submode ||
+                std::abs(hint.freq - f1) > AP_MAX_OFFSET) continue;
+
+            if (!best || std::abs(hint.freq - f1) < std::abs(best->freq - f1)) best = &hint;
+        }
+
+        return best;
+    }
+
+    // Bias the message bits of a set of LLRs toward those expected by a hint;
+    // the known bits are given a magnitude just beyond that of the strongest
+    // received bit, so BP will trust them, but isn't forbidden to flip them.
+
+    std::array<float, N>
+    biasLLR(std::array<float, N> const & llr,
+            Hint                 const & hint)
+    {
+        auto       biased = llr;
+        auto const apmag  = 1.01f * std::abs(*std::max_element(llr.begin(), llr.end(), [](float const a,
+                                                                                          float const b)
+        {
+            return std::abs(a) < std::abs(b);
+        }));
+
+        for (int i = 0; i < 64; ++i)
+        {
+            auto const bit = std::uint64_t{1} << (63 - i);
+
+            if (hint.mask & bit) biased[M + i] = (hint.bits & bit) ? apmag : -apmag;
+        }
+
+        return biased;
+    }
+
+    // BP will happily converge on the hint, given enough of a push, whether
+    // or not it's what was sent; the CRC alone is but 12 bits, against the
+    // 28 or so that are left to chance. Accept a result only if it agrees
+    // with the hint, passes the CRC, and, measured against what we actually
+    // received rather than the biased LLRs, has few enough hard errors that
+    // it would have been in contention without the hint.
+
+    int
+    checkHint(std::array<float, N>  const & llr,
+              std::array<int8_t, K> const & decoded,
+              std::array<int8_t, N> const & cw,
+              Hint                  const & hint)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            auto const bit = std::uint64_t{1} << (63 - i);
+
+            if ((hint.mask & bit) && (decoded[i] != 0) != ((hint.bits & bit) != 0)) return -1;
+        }
+
+        if (std::all_of(cw.begin(), cw.end(), [](int x) { return x == 0; }) ||
+            !checkCRC12(decoded)) return -1;
+
+        int nharderrors = 0;
+
+        for (int i = 0; i < N; ++i)
+        {
+            if ((2 * cw[i] - 1) * llr[i] < 0.0f) ++nharderrors;
+        }
+
+        return nharderrors <= AP_MAX_HARDERRORS ? nharderrors : -1;
+    }
+}
+
 /******************************************************************************/
 // DecodeMode Template Class
 /******************************************************************************/
@@ -1072,10 +1522,26 @@ namespace
     template <typename Mode>
     class DecodeMode
     {
+        // Fine sync reference for one Costas symbol; the conjugate of the
+        // symbol's waveform, frequency adjusted for one of the fine search
+        // steps, split into real and imaginary parts so that correlating
+        // against it vectorizes.
+
+        struct SyncRef
+        {
+            alignas(64) std::array<float, Mode::NDOWNSPS> re;
+            alignas(64) std::array<float, Mode::NDOWNSPS> im;
+        };
+
+        // Fine sync references for each of the 21 Costas symbols, at each
+        // of the fine frequency search steps, i.e., -NFSRCH through NFSRCH.
+
+        using SyncRefs = std::array<std::array<SyncRef, NS>, 2 * NFSRCH + 1>;
+
         // Data members
 
         std::array<float, Mode::NFFT1>                                                nuttal;
-        std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3> csyncs;
+        SyncRefs                                                                      csyncs;
         alignas(64) std::array<std::complex<float>, Mode::NDOWNSPS>                   csymb;
         alignas(64) std::array<std::complex<float>, Mode::NMAX>                       filter;
         alignas(64) std::array<std::complex<float>, Mode::NMAX>                       cfilt;
@@ -1085,8 +1551,17 @@ namespace
         std::array<float, Mode::NMAX>                                                 dd;
         std::array<std::array<float, Mode::NHSYM>, Mode::NSPS>                        s;
         std::array<float, Mode::NSPS>                                                 savg;
+        std::array<float, Mode::NSPS>                                                 spow;
+        std::array<bool,  Mode::NSPS>                                                 gate;
+        std::vector<float>                                                            sampled;
         FFTWPlanManager                                                               plans;
         SyncIndex                                                                     sync;
+        SyncIndex                                                                     full;
+        GateStats                                                                     stats;
+        BPStats                                                                       bpstats;
+        OSDStats                                                                      osdstats;
+        APStats                                                                       apstats;
+        std::vector<NearMiss>                                                         nearmisses;
 
         using Plan = FFTWPlanManager::Type;
 
@@ -1144,7 +1619,12 @@ namespace
 
         std::optional<Decode>
         js8dec(bool          const syncStats,
+               bool          const syncPrune,
+               bool          const earlyAbort,
+               bool          const bpRecall,
+               bool          const keepNearMiss,
                bool          const lsubtract,
+               Hint  const * const hint,
                float             & f1,
                float             & xdt,
                int               & nharderrors,
@@ -1171,18 +1651,44 @@ namespace
             int   i0   = static_cast<int>(std::round((xdt + Mode::ASTART) * FS2));
             float smax = 0.0f;
     
-            // Search for the best synchronization offset.
+            // Search for the best synchronization offset. If asked to prune
+            // the search, try every other offset in the window, and then only
+            // those between them that syncbound() says could better the best
+            // so far. Ties go to the earliest offset, as they would were every
+            // offset tried in order, so either way we arrive at the same one.
 
-            for (int idt  = i0 - Mode::NQSYMBOL;
-                     idt <= i0 + Mode::NQSYMBOL;
-                   ++idt)
-            {
-                float const sync = syncjs8d(idt, 0.0f);
+            int const tlo = i0 - Mode::NQSYMBOL;
+            int const thi = i0 + Mode::NQSYMBOL;
 
-                if (sync > smax) {
-                    smax = sync;
+            auto const consider = [&](int   const idt,
+                                      float const sync)
+            {
+                if (sync > smax || (sync == smax && sync > 0.0f && idt < ibest)) {
+                    smax  = sync;
                     ibest = idt;
                 }
+            };
+
+            if (syncPrune)
+            {
+                std::array<std::array<float, NS>, 2 * Mode::NQSYMBOL + 1> mags;
+
+                for (int idt = tlo; idt <= thi; idt += 2)
+                {
+                    consider(idt, syncjs8d(idt, 0, &mags[idt - tlo]));
+                }
+
+                for (int idt = tlo + 1; idt < thi; idt += 2)
+                {
+                    if (std::min(syncbound(idt - 1,  1, mags[idt - 1 - tlo]),
+                                 syncbound(idt + 1, -1, mags[idt + 1 - tlo])) < smax) continue;
+
+                    consider(idt, syncjs8d(idt));
+                }
+            }
+            else
+            {
+                for (int idt = tlo; idt <= thi; ++idt) consider(idt, syncjs8d(idt));
             }
 
             // Improved estimate for DT.
@@ -1199,7 +1705,7 @@ namespace
                    ++ifr)
             {
                 float const delf = ifr * 0.5f;
-                float const sync = syncjs8d(i0, delf);
+                float const sync = syncjs8d(i0, ifr);
 
                 if (sync > smax) {
                     smax     = sync;
@@ -1224,7 +1730,7 @@ namespace
             xdt = xdt2;
             f1 += delfbest;
 
-            float const sync = syncjs8d(i0, 0.0f);
+            float const sync = syncjs8d(i0);
 
             std::array<std::array<float, NN>, NROWS> s2;
 
@@ -1245,11 +1751,12 @@ namespace
 
                 fftwf_execute(plans[Plan::CS]);
 
-                // Normalize and take the magnitude of the first 8 points.
+                // Normalize and take the magnitude of the first 8 points;
+                // no need for the overflow protection of std::abs() here.
 
                 for (int i = 0; i < NROWS; ++i)
                 {
-                    s2[i][k] = std::abs(csymb[i]) / 1000.0f;
+                    s2[i][k] = std::sqrt(std::norm(csymb[i])) / 1000.0f;
                 }
             }
 
@@ -1293,76 +1800,30 @@ namespace
                                                            xdt,
                                                            {.candidate = nsync}});
 
-            std::array<std::array<float, ND>, NROWS> s1;
-
-            // Fill s1 from s2, excluding the Costas arrays.
-
-            for (int row = 0; row < NROWS; ++row)
-            {
-                std::copy(s2[row].begin() +  7, s2[row].begin() + 36, s1[row].begin());
-                std::copy(s2[row].begin() + 43, s2[row].begin() + 72, s1[row].begin() + 29);
-            }
-
-            // Temporary variables for metrics
-
-            std::array<float, 3 * ND> llr0 = {};
-            std::array<float, 3 * ND> llr1 = {};
-
-            // Compute metrics for each row in `s1`
-
-            for (int j = 0; j < ND; ++j)
-            {
-                int const i1 = 3 * j;     // First column (matches Fortran's i1)
-                int const i2 = 3 * j + 1; // Second column (matches Fortran's i2)
-                int const i4 = 3 * j + 2; // Third column (matches Fortran's i4)
-
-                std::array<float, NROWS> ps;
+            // Compute normalized metrics for the data symbols.
 
-                for (int i = 0; i < NROWS; ++i) ps[i] = s1[i][j];
+            std::array<float, 3 * ND> llr0;
+            std::array<float, 3 * ND> llr1;
 
-                // Assign to `bmeta` in column order, with correct values
-                llr0[i1] = std::max({ps[4], ps[5], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[2], ps[3]}); // r4
-                llr0[i2] = std::max({ps[2], ps[3], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[4], ps[5]}); // r2
-                llr0[i4] = std::max({ps[1], ps[3], ps[5], ps[7]}) - std::max({ps[0], ps[2], ps[4], ps[6]}); // r1
+            JS8::Metrics::softmetrics(s2, llr0, llr1);
 
-                for (auto & x : ps) x = std::log(x + 1e-32f); 
+            // The erasure passes modify LLR 0; if we've a hint to try later,
+            // we'll want it as received.
 
-                // Assign to `bmetb` in column order, with correct values
-                llr1[i1] = std::max({ps[4], ps[5], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[2], ps[3]}); // r4
-                llr1[i2] = std::max({ps[2], ps[3], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[4], ps[5]}); // r2
-                llr1[i4] = std::max({ps[1], ps[3], ps[5], ps[7]}) - std::max({ps[0], ps[2], ps[4], ps[6]}); // r1
-            }
-
-            auto const normalizeLLR = [](auto & llr)
-            {
-                float sum            = 0.0f;
-                float sum_of_squares = 0.0f;
-
-                for (auto const value : llr)
-                {
-                    sum            += value;
-                    sum_of_squares += value * value;
-                }
-
-                float const llrav    = sum            / llr.size();
-                float const llr2av   = sum_of_squares / llr.size();
-                float const variance = llr2av - llrav * llrav;
-                float const llrsig   = std::sqrt(variance > 0.0f ? variance : llr2av);
-
-                for (float & val : llr) val = (val / llrsig) * 2.83f;
-            };
-
-            // Normalize and process metrics
+            std::optional<std::array<float, N>> received;
 
-            normalizeLLR(llr0);
-            normalizeLLR(llr1);
+            if (hint) received = llr0;
 
-            std::array<int8_t, K> decoded;
-            std::array<int8_t, N> cw;
+            std::array<int8_t, K>              decoded;
+            std::array<int8_t, N>              cw;
+            std::array<BPTrace, BP_MAX_PASSES> traces;
+            std::optional<NearMiss>            nearMiss;
 
             // Loop over decoding passes
-            for (int ipass = 1; ipass <= 4; ++ipass)
+            for (int ipass = 1; ipass <= BP_MAX_PASSES; ++ipass)
             {
+                auto const pass = ipass - 1;
+
                 // LLR 0 used on passes 1, 3, and 4; LLR 1 used on pass 2.
 
                 auto const & llr = ipass == 2 ? llr1 : llr0;
@@ -1373,11 +1834,44 @@ namespace
                 if      (ipass == 3) std::fill(llr0.begin(),      llr0.begin() + 24, 0.0f);
                 else if (ipass == 4) std::fill(llr0.begin() + 24, llr0.begin() + 48, 0.0f);
 
+                // The erasure passes are variants of the first; if neither it
+                // nor the log domain pass made any headway at all, then there's
+                // nothing that erasing part of it is going to rescue. Skipped
+                // only along with early abort; if we're measuring, they're
+                // tried anyway, noting that we'd have skipped.
+
+                bool const triaged = ipass > 2             &&
+                                     !traces[0].progressed() &&
+                                     !traces[1].progressed();
+
+                if (triaged)
+                {
+                    ++bpstats.skipped[pass];
+                    if (earlyAbort && !bpRecall) continue;
+                }
+
                 // Decode using belief propagation.
 
-                nharderrors = bpdecode174(llr, decoded, cw);
+                nharderrors = bpdecode174(llr, decoded, cw, earlyAbort && !bpRecall, traces[pass]);
                 xsnr        = -99.0f;
 
+                ++bpstats.attempts[pass];
+                ++bpstats.iterations[pass][traces[pass].iterations];
+
+                if (traces[pass].abortable) ++bpstats.aborted[pass];
+
+                // If BP failed, but got closer than any previous attempt, this
+                // is the attempt to give ordered statistics decoding, if we're
+                // going to.
+
+                if (keepNearMiss                        &&
+                    nharderrors < 0                     &&
+                    traces[pass].best <= OSD_MAX_WEIGHT &&
+                    (!nearMiss || traces[pass].best < nearMiss->weight))
+                {
+                    nearMiss.emplace(NearMiss{traces[pass].best, f1, xdt2, sync, xbase, llr, s2});
+                }
+
                 // Check for all-zero codeword
                 if (std::all_of(cw.begin(), cw.end(), [](int x) { return x == 0; }))
                 {
@@ -1391,59 +1885,175 @@ namespace
                 {
                    if (checkCRC12(decoded))
                    {
-                        if (syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::DECODED,
-                                                                       Mode::NSUBMODE,
-                                                                       f1,
-                                                                       xdt2,
-                                                                       {.decoded = sync}});
-
-                        auto message = extractmessage174(decoded);
-
-                        int const i3bit = (decoded[72] << 2) |
-                                          (decoded[73] << 1) |
-                                           decoded[74];
+                        ++bpstats.decoded[pass];
 
-                        std::array<int, NN> itone;
+                        if (triaged || traces[pass].abortable) ++bpstats.lost[pass];
 
-                        JS8::encode(i3bit, Costas, message.data(), itone.data());
-
-                        // Subtract signal if needed.
-
-                        if (lsubtract) subtractjs8(genjs8refsig(itone, f1), xdt2);
+                        return js8complete(syncStats, lsubtract, decoded, f1, xdt2, sync, xbase, s2, xsnr, emitEvent);
+                   }
+                }
+                else
+                {
+                    nharderrors = -1;
+                }
+            }
 
-                        // Compute the signal power.
+            // If we're expecting to hear from somebody near here, try one more
+            // pass, with what we expect to hear from them filled in.
 
-                        float xsig = 0.0f;
+            if (hint)
+            {
+                BPTrace trace;
 
-                        for (std::size_t i = 0; i < itone.size(); ++i)
-                        {
-                            xsig += std::pow(s2[itone[i]][i], 2);
-                        }
+                ++apstats.attempts;
 
-                        // Compute SNR, clamping results lower than -28 to -28.
-                        // Note that std::log10(1.259e-10) is about -9.9; we're
-                        // avoiding undefined behavior in the log10 computation.
+                if (bpdecode174(biasLLR(*received, *hint), decoded, cw, earlyAbort && !bpRecall, trace) >= 0)
+                {
+                    if (nharderrors = checkHint(*received, decoded, cw, *hint);
+                        nharderrors >= 0)
+                    {
+                        ++apstats.decoded;
 
-                        xsnr = std::max(
-                            10.0f * std::log10(std::max(
-                                xsig / xbase -  1.0f,
-                                1.259e-10f)) - 32.0f,
-                           -60.0f);  // XXX was -28.0f in Fortran
+                        return js8complete(syncStats, lsubtract, decoded, f1, xdt2, sync, xbase, s2, xsnr, emitEvent);
+                    }
 
-                        return std::make_optional<Decode>(i3bit, message);
-                   }
-                }
-                else
-                {
-                    nharderrors = -1;
+                    ++apstats.rejected;
                 }
+
+                nharderrors = -1;
             }
 
+            if (nearMiss) nearmisses.push_back(std::move(*nearMiss));
+
             return std::nullopt;
         }
 
-        // Compute noise baseline. We differ quite a bit from the Fortran
-        // implementation here.
+        // Completes a decode, from either BP or ordered statistics decoding;
+        // announces it if we're reporting sync state, subtracts the signal if
+        // requested, and computes the SNR.
+
+        Decode
+        js8complete(bool                                     const   syncStats,
+                    bool                                     const   lsubtract,
+                    std::array<int8_t, K>                    const & decoded,
+                    float                                    const   f1,
+                    float                                    const   xdt2,
+                    float                                    const   sync,
+                    float                                    const   xbase,
+                    std::array<std::array<float, NN>, NROWS> const & s2,
+                    float                                          & xsnr,
+                    JS8::Event::Emitter                              emitEvent)
+        {
+            if (syncStats) emitEvent(JS8::Event::SyncState{JS8::Event::SyncState::Type::DECODED,
+                                                           Mode::NSUBMODE,
+                                                           f1,
+                                                           xdt2,
+                                                           {.decoded = sync}});
+
+            auto message = extractmessage174(decoded);
+
+            int const i3bit = (decoded[72] << 2) |
+                              (decoded[73] << 1) |
+                               decoded[74];
+
+            std::array<int, NN> itone;
+
+            JS8::encode(i3bit, Costas, message.data(), itone.data());
+
+            // Subtract signal if needed.
+
+            if (lsubtract) subtractjs8(genjs8refsig(itone, f1), xdt2);
+
+            // Compute the signal power.
+
+            float xsig = 0.0f;
+
+            for (std::size_t i = 0; i < itone.size(); ++i)
+            {
+                xsig += std::pow(s2[itone[i]][i], 2);
+            }
+
+            // Compute SNR, clamping results lower than -28 to -28.
+            // Note that std::log10(1.259e-10) is about -9.9; we're
+            // avoiding undefined behavior in the log10 computation.
+
+            xsnr = std::max(
+                10.0f * std::log10(std::max(
+                    xsig / xbase -  1.0f,
+                    1.259e-10f)) - 32.0f,
+               -60.0f);  // XXX was -28.0f in Fortran
+
+            return Decode(i3bit, message);
+        }
+
+        // Ordered statistics decoding of the near misses from a pass, most
+        // promising first, i.e., lowest syndrome weight, for as long as the
+        // cycle's budget for it holds out. Results must pass the CRC check,
+        // and, since OSD will always produce a codeword, have no more than
+        // OSD_MAX_HARDERRORS bits in disagreement with what we received; at
+        // depth 2, a mere CRC-12 alone would pass rather too much noise.
+
+        template <typename Accept>
+        void
+        osdjs8(int                                 const depth,
+               std::chrono::steady_clock::duration const budget,
+               bool                                const syncStats,
+               bool                                const lsubtract,
+               Accept                              const & accept,
+               JS8::Event::Emitter                       emitEvent)
+        {
+            using Clock = std::chrono::steady_clock;
+
+            std::stable_sort(nearmisses.begin(),
+                             nearmisses.end(),
+                             [](auto const & a,
+                                auto const & b)
+                             {
+                                return a.weight < b.weight;
+                             });
+
+            for (auto & miss : nearmisses)
+            {
+                auto const start = Clock::now();
+
+                if (osdstats.elapsed >= budget)
+                {
+                    ++osdstats.skipped;
+                    continue;
+                }
+
+                std::array<int8_t, K> decoded;
+                std::array<int8_t, N> cw;
+
+                int const nharderrors = osd174(miss.llr,
+                                               depth,
+                                               start + (budget - osdstats.elapsed),
+                                               decoded,
+                                               cw);
+                ++osdstats.attempts;
+
+                bool const good = nharderrors >= 0                  &&
+                                  nharderrors <= OSD_MAX_HARDERRORS &&
+                                  std::any_of(cw.begin(), cw.end(), [](int x) { return x != 0; }) &&
+                                  checkCRC12(decoded);
+
+                osdstats.elapsed += Clock::now() - start;
+
+                if (!good) continue;
+
+                ++osdstats.decoded;
+
+                float xsnr   = 0.0f;
+                auto  decode = js8complete(syncStats, lsubtract, decoded, miss.f1, miss.xdt, miss.sync, miss.xbase, miss.s2, xsnr, emitEvent);
+
+                accept(std::move(decode), xsnr, miss.xdt, miss.f1, nharderrors);
+            }
+
+            nearmisses.clear();
+        }
+
+        // Compute noise baseline. We differ quite a bit from the Fortran
+        // implementation here.
         //
         // The Fortran version took `savg` as input; power scaled data from
         // `syncjs8`, and produced `sbase`, the noise baseline. To accomplish
@@ -1646,6 +2256,228 @@ namespace
                            [factor](auto & value) { return value * factor; });
         }
 
+        // Evaluate the Costas sync metric for frequency bin `i` at every time
+        // offset in [-JZ, JZ], returning the maximum value and the offset at
+        // which it occurred.
+
+        std::pair<float, int>
+        syncjs8bin(int const i) const
+        {
+            float max_value = -std::numeric_limits<float>::infinity();
+            int   max_index = -Mode::JZ;
+
+            for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
+            {
+                std::array<std::array<float, 3>, 2> t{};
+
+                for (int p = 0; p < 3; ++p)
+                {
+                    for (int n = 0; n < 7; ++n)
+                    {
+                        int const offset = j + Mode::JSTRT + NSSY * n + p * 36 * NSSY;
+
+                        if (offset >= 0 && offset < Mode::NHSYM)
+                        {
+                            // Accumulate Costas pattern contributions.
+
+                            t[0][p] += s[i + NFOS * Costas[p][n]][offset];
+
+                            // Accumulate sum over all frequencies for this block.
+
+                            for (int freq = 0; freq < 7; ++freq)
+                            {
+                                t[1][p] += s[i + NFOS * freq][offset];
+                            }
+                        }
+                    }
+                }
+
+                // Compute sync metric over the index range. We are at the moment
+                // maintaining the Fortran summation methodology for compatibility
+                // testing; there are more efficient ways to do this, but IEEE 754
+                // addition is a touchy thing, so we'll need to ensure that any
+                // changes don't negatively affect result precision.
+
+                auto const compute_sync = [&t](int start, int end)
+                {
+                    float tx = 0.0f;
+                    float t0 = 0.0f;
+
+                    for (int i = start; i <= end; ++i)
+                    {
+                        tx += t[0][i];
+                        t0 += t[1][i];
+                    }
+
+                    return tx / ((t0 - tx) / 6.0f);
+                };
+
+                if (auto const sync_value = std::max({
+                        compute_sync(0, 2),
+                        compute_sync(0, 1),
+                        compute_sync(1, 2)
+                    }); sync_value > max_value)
+                {
+                    max_value = sync_value;
+                    max_index = j;
+                }
+            }
+
+            return {max_value, max_index};
+        }
+
+        // Normalize the sync values in the index by the reference value, and
+        // extract candidates from it, strongest first. Near-duplicates of each
+        // candidate are removed from the index as we go, so the index will
+        // have been consumed to some degree on return.
+
+        std::vector<Sync>
+        candidatesjs8(SyncIndex & index,
+                      float const reference)
+        {
+            // Access the sync indices.
+
+            auto & freqIndex = index.get<Tag::Freq>();
+            auto & syncIndex = index.get<Tag::Sync>();
+
+            // Normalize using the frequency index, which is stable under
+            // sync value mutation.
+
+            auto const normalize = [reference](Sync & entry)
+            {
+                entry.sync /= reference;
+            };
+
+            for (auto it  = freqIndex.begin();
+                      it != freqIndex.end();
+                    ++it)
+            {
+                freqIndex.modify(it, normalize);
+            }
+
+            // Extract candidates.
+
+            std::vector<Sync> candidates;
+
+            for (auto it  = syncIndex.begin();
+                      it != syncIndex.end() && candidates.size() < NMAXCAND;
+                      it  = syncIndex.begin())
+            {
+                // Stop iteration if below threshold or invalid; as the
+                // index is sorted by sync, any subsequent entries will
+                // also be below the threshold or invalid.
+
+                if (it->sync < ASYNCMIN || std::isnan(it->sync)) break;
+
+                // Good value, relatively strong; save the candidate.
+
+                candidates.push_back(*it);
+
+                // Remove the candidate and any near-duplicates based
+                // on frequency. This invalidates `it`, so we reset it
+                // to the index begin in the loop increment condition.
+
+                freqIndex.erase(
+                    freqIndex.lower_bound(it->freq - Mode::AZ),
+                    freqIndex.upper_bound(it->freq + Mode::AZ));
+            }
+
+            return candidates;
+        }
+
+        // Determine which bins in the closed range [ia, ib] are worth a full
+        // sync search. On entry, `spow` contains the power summed over the
+        // Costas footprint of each bin, i.e., the 7 tones above it, and `savg`
+        // contains the noise baseline in dB, as computed by baselinejs8().
+        //
+        // The footprint power is converted to dB above the baseline, which
+        // removes any tilt in the receiver passband. What remains is noise of
+        // roughly constant variance, plus any signals. We estimate the mean
+        // and standard deviation of the noise from the lower tail, i.e., the
+        // 10th and 30th percentiles, of the bins in the baseline fitting range,
+        // where the baseline is most accurate; signals only ever add energy,
+        // so this holds up even in a band that's busy.
+        //
+        // Bins above the noise by GATE_SIGMA standard deviations are occupied;
+        // they're marked in `gate`, along with a guard margin either side, so
+        // that the edges of a signal and any slight drift are covered.
+
+        void
+        energygate(int const ia,
+                   int const ib)
+        {
+            using boost::math::ccmath::round;
+
+            constexpr int  width = NFOS * 7 + 1;
+            constexpr int  guard = NFOS * 8 * GATE_GUARD;
+            constexpr auto bmin  = static_cast<int>(round(BASELINE_MIN / Mode::DF));
+            constexpr auto bmax  = static_cast<int>(round(BASELINE_MAX / Mode::DF));
+
+            gate.fill(false);
+
+            if (ib < ia) return;
+
+            // Convert footprint power to average dB above the baseline at the
+            // center of the footprint.
+
+            for (int i = ia; i <= ib; ++i)
+            {
+                spow[i] = 10.0f * std::log10(std::max(spow[i] / width, 1.0e-30f))
+                        - savg[std::min(i + width / 2, ib)];
+            }
+
+            // Sample the noise statistics from the baseline fitting range if
+            // enough of it lies within the search range; otherwise, use the
+            // whole of the search range.
+
+            auto       first = std::max(ia, bmin);
+            auto       last  = std::min(ib, bmax);
+
+            if (last - first < 4 * width)
+            {
+                first = ia;
+                last  = ib;
+            }
+
+            std::vector<float> noise(spow.begin() + first,
+                                     spow.begin() + last + 1);
+
+            auto const quantile = [&noise](std::size_t const percent)
+            {
+                auto const nth = noise.begin() + (noise.size() - 1) * percent / 100;
+
+                std::nth_element(noise.begin(), nth, noise.end());
+
+                return *nth;
+            };
+
+            // For a normal distribution, the 10th and 30th percentiles lie at
+            // z-scores of -1.2816 and -0.5244 respectively.
+
+            auto const p10       = quantile(10);
+            auto const p30       = quantile(30);
+            auto const sigma     = std::max((p30 - p10) / 0.7572f, 0.01f);
+            auto const mean      = p30 + 0.5244f * sigma;
+            auto const threshold = mean + GATE_SIGMA * sigma;
+
+            // Mark occupied bins and their guard margins; `marked` is the last
+            // bin marked thus far, so that overlapping margins aren't redone.
+
+            int marked = ia - 1;
+
+            for (int i = ia; i <= ib; ++i)
+            {
+                if (spow[i] <= threshold) continue;
+
+                for (int j = std::max(marked + 1, i - guard); j <= std::min(ib, i + guard); ++j)
+                {
+                    gate[j] = true;
+                }
+
+                marked = std::min(ib, i + guard);
+            }
+        }
+
         // Evaluate the synchronization power of signal segments, ranks potential candidates, and
         // extracts the most promising ones for further decoding.
         //
@@ -1703,10 +2535,18 @@ namespace
         //       function, but I'm unsure why; nothing beyond this function references `s`,
         //       so it was effectively a somewhat expensive dead store. It's been eliminated
         //       in this version.
+        //
+        // Note: When gated, step 4 is restricted to the sub-bands that energygate() finds
+        //       to be occupied, and step 5 normalizes against the 40th percentile of a
+        //       strided sample of the band, rather than of every bin. When measuring recall,
+        //       the remaining bins are searched as well, and the candidates a full search
+        //       would have produced are compared against those of the gated search.
 
         std::vector<Sync>
-        syncjs8(int nfa,
-                int nfb)
+        syncjs8(int        nfa,
+                int        nfb,
+                bool const gated,
+                bool const recall)
         {
             // Compute symbol spectra
 
@@ -1756,140 +2596,132 @@ namespace
             auto const ia = std::max(0, static_cast<int>(std::round(nfa / Mode::DF)));
             auto const ib =             static_cast<int>(std::round(nfb / Mode::DF));
 
+            // The energy gate needs the power in the footprint of each bin
+            // before the average spectrum is replaced by the baseline.
+
+            if (gated)
+            {
+                for (int i = ia; i <= ib; ++i)
+                {
+                    spow[i] = std::accumulate(savg.begin() + i,
+                                              savg.begin() + i + NFOS * 7 + 1,
+                                              0.0f);
+                }
+            }
+
             // Convert average spectrum from power to db scale and compute
             // baseline from it; baseline replaces average spectrum.
 
             baselinejs8(ia, ib);
 
-            // Compute and populate the sync index.
+            if (gated) energygate(ia, ib);
 
-            sync.clear();
+            // Compute and populate the sync index, skipping any bins that
+            // the energy gate has excluded, unless they're sampled for the
+            // sake of normalization.
 
-            for (int i = ia; i <= ib; ++i)
+            using Clock = std::chrono::steady_clock;
+
+            auto const emplace = [this](SyncIndex & index,
+                                        int const   i)
             {
-                float max_value = -std::numeric_limits<float>::infinity();
-                int   max_index = -Mode::JZ;
+                auto const [max_value, max_index] = syncjs8bin(i);
 
-                for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
-                {
-                    std::array<std::array<float, 3>, 2> t{};
+                return index.emplace(Mode::DF    * i,
+                                     Mode::TSTEP * (max_index + 0.5f),
+                                                    max_value).first->sync;
+            };
 
-                    for (int p = 0; p < 3; ++p)
-                    {
-                        for (int n = 0; n < 7; ++n)
-                        {
-                            int const offset = j + Mode::JSTRT + NSSY * n + p * 36 * NSSY;
+            auto const skipped = [this, gated, ia](int const i)
+            {
+                return gated && !gate[i] && (i - ia) % GATE_STRIDE;
+            };
 
-                            if (offset >= 0 && offset < Mode::NHSYM)
-                            {
-                                // Accumulate Costas pattern contributions.
+            auto const start = Clock::now();
 
-                                t[0][p] += s[i + NFOS * Costas[p][n]][offset];
+            sync.clear();
+            sampled.clear();
 
-                                // Accumulate sum over all frequencies for this block.
+            for (int i = ia; i <= ib; ++i)
+            {
+                if (skipped(i)) continue;
 
-                                for (int freq = 0; freq < 7; ++freq)
-                                {
-                                    t[1][p] += s[i + NFOS * freq][offset];
-                                }
-                            }
-                        }
-                    }
+                auto const value = emplace(sync, i);
 
-                    // Compute sync metric over the index range. We are at the moment
-                    // maintaining the Fortran summation methodology for compatibility
-                    // testing; there are more efficient ways to do this, but IEEE 754
-                    // addition is a touchy thing, so we'll need to ensure that any
-                    // changes don't negatively affect result precision.
+                if (gated && (i - ia) % GATE_STRIDE == 0) sampled.push_back(value);
+            }
 
-                    auto const compute_sync = [&t](int start, int end)
-                    {
-                        float tx = 0.0f;
-                        float t0 = 0.0f;
+            stats.bins     += std::max(0, ib - ia + 1);
+            stats.searched += sync.size();
+            stats.gated    += Clock::now() - start;
 
-                        for (int i = start; i <= end; ++i)
-                        {
-                            tx += t[0][i];
-                            t0 += t[1][i];
-                        }
+            // If we're measuring recall, fill in what the gate skipped, so
+            // that we have what a full search would have seen.
 
-                        return tx / ((t0 - tx) / 6.0f);
-                    };
+            if (recall)
+            {
+                full = sync;
 
-                    if (auto const sync_value = std::max({
-                            compute_sync(0, 2),
-                            compute_sync(0, 1),
-                            compute_sync(1, 2)
-                        }); sync_value > max_value)
-                    {
-                        max_value = sync_value;
-                        max_index = j;
-                    }
+                for (int i = ia; i <= ib; ++i)
+                {
+                    if (skipped(i)) emplace(full, i);
                 }
 
-                sync.emplace(Mode::DF    * i,
-                             Mode::TSTEP * (max_index + 0.5f),
-                                            max_value);
+                stats.complete += Clock::now() - start;
             }
 
             // If we found nothing, we're done here.
 
             if (sync.empty()) return {};
 
-            // Access the sync indices.
-
-            auto & freqIndex = sync.get<Tag::Freq>();
-            auto & rankIndex = sync.get<Tag::Rank>();
-            auto & syncIndex = sync.get<Tag::Sync>();
+            // Normalize to the 40th percentile. One thing to note here is
+            // that the Fortran version didn't seem to reliably calculate
+            // the 40th percentile rank; sometimes high, other times low,
+            // infrequently actually the 40th percentile value. This method
+            // should be perfectly accurate in all cases. When gated, the
+            // searched bins are biased toward signals, so we use the strided
+            // sample instead, which is representative of the whole band.
 
-            // Normalize to the 40th percentile using the frequency index,
-            // which is stable under sync value mutation. One thing to note
-            // here is that the Fortran version didn't seem to reliably
-            // calculate the 40th percentile rank; sometimes high, other
-            // times low, infrequently actually the 40th percentile value.
-            // This method should be perfectly accurate in all cases.
-
-            auto const normalize =
-            [
-               sync = rankIndex.nth(rankIndex.size() * 4 / 10)->sync
-            ]
-            (Sync & entry)
+            auto const percentile = [](SyncIndex const & index)
             {
-                entry.sync /= sync;
+                auto const & rankIndex = index.get<Tag::Rank>();
+
+                return rankIndex.nth(rankIndex.size() * 4 / 10)->sync;
             };
 
-            for (auto it  = freqIndex.begin();
-                      it != freqIndex.end();
-                    ++it)
+            auto const reference = [&]()
             {
-                freqIndex.modify(it, normalize);
-            }
+                if (!gated) return percentile(sync);
 
-            // Extract candidates.
+                auto const nth = sampled.begin() + sampled.size() * 4 / 10;
 
-            std::vector<Sync> candidates;
+                std::nth_element(sampled.begin(), nth, sampled.end());
 
-            for (auto it  = syncIndex.begin();
-                      it != syncIndex.end() && candidates.size() < NMAXCAND;
-                      it  = syncIndex.begin())
-            {
-                // Stop iteration if below threshold or invalid; as the
-                // index is sorted by sync, any subsequent entries will
-                // also be below the threshold or invalid.
+                return *nth;
+            }();
 
-                if (it->sync < ASYNCMIN || std::isnan(it->sync)) break;
-
-                // Good value, relatively strong; save the candidate.
-
-                candidates.push_back(*it);
+            auto candidates = candidatesjs8(sync, reference);
 
-                // Remove the candidate and any near-duplicates based
-                // on frequency. This invalidates `it`, so we reset it
-                // to the index begin in the loop increment condition.
+            // Any candidate a full search would have found is considered to
+            // have been recalled if the gated search found one within the
+            // near-duplicate distance of it.
 
-                freqIndex.erase(
-                    freqIndex.lower_bound(it->freq - Mode::AZ),
-                    freqIndex.upper_bound(it->freq + Mode::AZ));
+            if (recall)
+            {
+                auto const expected = candidatesjs8(full, percentile(full));
+
+                stats.expected += expected.size();
+                stats.recalled += static_cast<std::size_t>(std::count_if(expected.begin(),
+                                                expected.end(),
+                                                [&candidates](auto const & want)
+                                                {
+                                                    return std::any_of(candidates.begin(),
+                                                                       candidates.end(),
+                                                                       [&want](auto const & have)
+                                                                       {
+                                                                           return std::abs(have.freq - want.freq) <= Mode::AZ;
+                                                                       });
+                                                }));
             }
 
             return candidates;
@@ -1897,76 +2729,118 @@ namespace
 
         // Returns the total synchronization power, which is a measure of how well
         // the signal aligns with the Costas sequence after accounting for the
-        // frequency adjustment. Used to identify the best alignment for further
-        // decoding.
+        // frequency adjustment of fine search step ifr, i.e., ifr * 0.5 Hz. Used
+        // to identify the best alignment for further decoding. If asked, also
+        // provides the magnitude of the correlation for each Costas symbol, or
+        // -1 for those lying outside of the downsampled signal.
+        //
+        // The frequency adjusted references are computed up front, so all we
+        // have to do here is correlate; we accumulate in NLANES independent
+        // lanes, which permits the compiler to vectorize the reductions.
 
         float
-        syncjs8d(int   const i0,
-                 float const delf)
+        syncjs8d(int                     const i0,
+                 int                     const ifr  = 0,
+                 std::array<float, NS> * const mags = nullptr)
         {
-            constexpr float BASE_DPHI = TAU * (1.0f / (12000.0f / Mode::NDOWN));
+            constexpr int NLANES = 4;
 
-            // If delta frequency is non-zero, compute the frequency
-            // adjustment array, otherwise, use what'll be an identity
-            // transfrom when multiplied.
+            static_assert(Mode::NDOWNSPS % NLANES == 0);
 
-            std::array<std::complex<float>, Mode::NDOWNSPS> freqAdjust;
+            auto const & refs = csyncs[ifr + NFSRCH];
+            float        sync = 0.0f;
 
-            if (delf != 0.0f)
+            for (int i = 0; i < 3; ++i)
             {
-                float const dphi = BASE_DPHI * delf;
-                float       phi  = 0.0f;
+                for (int j = 0; j < 7; ++j)
+                {
+                    if (auto const offset = 36 * i * Mode::NDOWNSPS
+                                          + i0 + j * Mode::NDOWNSPS; offset >= 0 &&
+                                            offset + Mode::NDOWNSPS <= Mode::NP2)
+                    {
+                        auto const & ref = refs[i * 7 + j];
+                        auto const * cd  = reinterpret_cast<float const *>(cd0.data() + offset);
 
-                // std::fmod() is almost like Fortran's mod(), but not quite;
-                // Since delf can be negative, we must ensure that phi stays
-                // within [0, TAU), which Fortran's mod() handles by itself.
+                        std::array<float, NLANES> re = {};
+                        std::array<float, NLANES> im = {};
 
-                for (int i = 0; i < Mode::NDOWNSPS; ++i)
-                {
-                    freqAdjust[i] = std::polar(1.0f, phi);
-                    if (phi = std::fmod(phi + dphi, TAU);
-                        phi < 0.0f)
+                        for (int n = 0; n < Mode::NDOWNSPS; n += NLANES)
+                        {
+                            for (int l = 0; l < NLANES; ++l)
+                            {
+                                float const cr = cd[2 * (n + l)];
+                                float const ci = cd[2 * (n + l) + 1];
+
+                                re[l] += cr * ref.re[n + l] - ci * ref.im[n + l];
+                                im[l] += cr * ref.im[n + l] + ci * ref.re[n + l];
+                            }
+                        }
+
+                        float const r = (re[0] + re[1]) + (re[2] + re[3]);
+                        float const m = (im[0] + im[1]) + (im[2] + im[3]);
+
+                        sync += r * r + m * m;
+
+                        if (mags) (*mags)[i * 7 + j] = std::sqrt(r * r + m * m);
+                    }
+                    else if (mags)
                     {
-                        phi += TAU;
+                        (*mags)[i * 7 + j] = -1.0f;
                     }
                 }
             }
-            else
-            {
-                freqAdjust.fill(std::complex<float>{1.0f, 0.0f});
-            }
 
-            // Compute sync power by looping over the Costas indices for
-            // each of the 3 Costas blocks, accumulating as we go.
+            return sync;
+        }
+
+        // Returns an upper bound on the synchronization power, without any
+        // frequency adjustment, at the offset a step of 1 or -1 from i0, given
+        // the correlation magnitudes for each Costas symbol at i0. Unadjusted,
+        // the references are pure tones, so a step changes each correlation
+        // by the sample that it drops at one end and the one it picks up at
+        // the other, rotated; its magnitude can change by no more than theirs.
+        // Symbols that are outside of the signal at the step contribute no
+        // power; if any that are outside at i0 aren't at the step, there's no
+        // bound to be had.
+        //
+        // The bound carries a little slack, more than enough to cover the
+        // rounding in both it and in syncjs8d().
+
+        float
+        syncbound(int                   const   i0,
+                  int                   const   step,
+                  std::array<float, NS> const & mags) const
+        {
+            constexpr float SLACK = 1.001f;
 
-            float sync = 0.0f;
+            float bound = 0.0f;
 
             for (int i = 0; i < 3; ++i)
             {
                 for (int j = 0; j < 7; ++j)
                 {
-                    if (auto const offset = 36 * i * Mode::NDOWNSPS
-                                          + i0 + j * Mode::NDOWNSPS; offset >= 0 &&
-                                            offset + Mode::NDOWNSPS <= Mode::NP2)
-                    {
-                        sync += std::norm(
-                            std::transform_reduce(
-                                freqAdjust.begin(),     // Range start
-                                freqAdjust.end(),       // Range end
-                                cd0.begin() + offset,   // Data start
-                                std::complex<float>{},  // Initial reduction value
-                                std::plus<>{},          // Reduction by accumulation
-                                [&](auto const & fa,    // Conjugate and multiply
-                                    auto const & cd)
-                                {
-                                    return cd * std::conj(fa * csyncs[i][j][&fa - &freqAdjust[0]]);
-                                }                             
-                            ));
-                    }
+                    auto const offset = 36 * i * Mode::NDOWNSPS + i0 + j * Mode::NDOWNSPS;
+
+                    if (offset + step < 0 || offset + step + Mode::NDOWNSPS > Mode::NP2) continue;
+
+                    auto const mag = mags[i * 7 + j];
+
+                    if (mag < 0.0f) return std::numeric_limits<float>::infinity();
+
+                    auto const [dropped, added] = step > 0
+                                                ? std::pair{offset,                          offset + Mode::NDOWNSPS}
+                                                : std::pair{offset + Mode::NDOWNSPS - 1, offset - 1};
+
+                    // No need for the overflow protection of std::abs() here.
+
+                    auto const most = mag + std::sqrt(std::norm(cd0[dropped]))
+                                          + std::sqrt(std::norm(cd0[added]));
+
+                    bound += most * most;
                 }
             }
 
-            return sync;
+            return bound * SLACK;
         }
 
         // Generate a reference signal, based on the provided tone sequence and
@@ -2108,6 +2982,8 @@ namespace
 
             // Initialize Costas waveforms.
 
+            std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3> costas;
+
             for (int i = 0; i < 7; ++i)
             {
                 float const dphia = TAU * Costas[0][i] / Mode::NDOWNSPS;
@@ -2120,9 +2996,9 @@ namespace
 
                 for (int j = 0; j < Mode::NDOWNSPS; ++j)
                 {
-                    csyncs[0][i][j] = std::polar(1.0f, phia);
-                    csyncs[1][i][j] = std::polar(1.0f, phib);
-                    csyncs[2][i][j] = std::polar(1.0f, phic);
+                    costas[0][i][j] = std::polar(1.0f, phia);
+                    costas[1][i][j] = std::polar(1.0f, phib);
+                    costas[2][i][j] = std::polar(1.0f, phic);
 
                     phia = std::fmod(phia + dphia, TAU);
                     phib = std::fmod(phib + dphib, TAU);
@@ -2130,6 +3006,50 @@ namespace
                 }
             }
 
+            // Fine sync references; the conjugate of each Costas waveform,
+            // frequency adjusted for each fine search step. A zero step is
+            // an identity adjustment.
+            //
+            // std::fmod() is almost like Fortran's mod(), but not quite;
+            // Since delf can be negative, we must ensure that phi stays
+            // within [0, TAU), which Fortran's mod() handles by itself.
+
+            constexpr float BASE_DPHI = TAU * (1.0f / (12000.0f / Mode::NDOWN));
+
+            for (int ifr = -NFSRCH; ifr <= NFSRCH; ++ifr)
+            {
+                std::array<std::complex<float>, Mode::NDOWNSPS> freqAdjust;
+
+                float const dphi = BASE_DPHI * (ifr * 0.5f);
+                float       phi  = 0.0f;
+
+                for (int n = 0; n < Mode::NDOWNSPS; ++n)
+                {
+                    freqAdjust[n] = std::polar(1.0f, phi);
+                    if (phi = std::fmod(phi + dphi, TAU);
+                        phi < 0.0f)
+                    {
+                        phi += TAU;
+                    }
+                }
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    for (int j = 0; j < 7; ++j)
+                    {
+                        auto & ref = csyncs[ifr + NFSRCH][i * 7 + j];
+
+                        for (int n = 0; n < Mode::NDOWNSPS; ++n)
+                        {
+                            auto const value = std::conj(freqAdjust[n] * costas[i][j][n]);
+
+                            ref.re[n] = value.real();
+                            ref.im[n] = value.imag();
+                        }
+                    }
+                }
+            }
+
             // Compute a Hann-like window directly into the real part of the
             // first NFILT + 1 elements in the filter, accumulating the sum
             // as we go.
@@ -2301,7 +3221,9 @@ namespace
                 // by frequency, but put any that are close to nfqso up front.
 
                 auto candidates = syncjs8(data.params.nfa,
-                                          data.params.nfb);
+                                          data.params.nfb,
+                                          data.params.energyGate,
+                                          data.params.gateRecall);
 
                 if (candidates.empty()) break;
 
@@ -2328,57 +3250,157 @@ namespace
                 bool const subtract = ipass < 3;
                 bool       improved = false;
 
+                // We don't need to be emitting duplicate events for something
+                // that's effectively the same SNR as a previous event. If this
+                // decode is new, or it's a duplicate with a better SNR than what
+                // we had before, then our situation has improved and we must
+                // announce that we've had some success.
+
+                auto const accept = [&](Decode      decode,
+                                        float const xsnr,
+                                        float const xdt,
+                                        float const f1,
+                                        int   const nharderrors)
+                {
+                    auto const snr = static_cast<int>(std::round(xsnr));
+
+                    if (auto [it, inserted] = decodes.try_emplace(std::move(decode), snr);
+                                  inserted || it->second < snr)
+                    {
+                        improved = true;
+
+                        // Update the SNR if this is an improved decode.
+
+                        if (!inserted) it->second = snr;
+
+                        // Emit decoded events on new or improved decodes.
+
+                        emitEvent(JS8::Event::Decoded{data.params.nutc,
+                                                      snr,
+                                                      xdt - Mode::ASTART,
+                                                      f1,
+                                                      it->first.data,
+                                                      it->first.type,
+                                                      1.0f - nharderrors / 60.0f,
+                                                      Mode::NSUBMODE});
+                    }
+                };
+
                 for (auto [f1, xdt, sync] : candidates)
                 {
                     float xsnr        =  0.0f;
                     int   nharderrors = -1;
 
                     if (auto decode = js8dec(data.params.syncStats,
+                                             data.params.syncPrune,
+                                             data.params.bpEarlyAbort,
+                                             data.params.bpRecall,
+                                             data.params.osdDepth > 0,
                                              subtract,
+                                             findHint(data.params, Mode::NSUBMODE, f1),
                                              f1,
                                              xdt,
                                              nharderrors,
                                              xsnr,
                                              emitEvent))
                     {
-                        // We don't need to be emitting duplicate events for something
-                        // that's effectively the same SNR as a previous event.
+                        accept(std::move(*decode), xsnr, xdt, f1, nharderrors);
+                    }
+                }
 
-                        auto const snr = static_cast<int>(std::round(xsnr));
+                // Give anything that BP came close on a second chance.
 
-                        // If this decode is new, or it's a duplicate with a better SNR
-                        // than what we had before, then our situation has improved and 
-                        // we must announce that we've had some success.
+                if (!nearmisses.empty())
+                {
+                    osdjs8(data.params.osdDepth,
+                           std::chrono::milliseconds(data.params.osdBudget),
+                           data.params.syncStats,
+                           subtract,
+                           accept,
+                           emitEvent);
+                }
 
-                        if (auto [it, inserted] = decodes.try_emplace(std::move(*decode), snr);
-                                      inserted || it->second < snr)
-                        {
-                            improved = true;
+                // If nothing from this pass improved our situation, there's no
+                // point in trying any remaining passes.
 
-                            // Update the SNR if this is an improved decode.
+                if (!improved) break;
+            }
 
-                            if (!inserted) it->second = snr;
+            // Report on the energy gate, if we've been asked to measure it,
+            // and start afresh for the next cycle.
 
-                            // Emit decoded events on new or improved decodes.
+            if (data.params.gateRecall)
+            {
+                using std::chrono::duration_cast;
+                using std::chrono::microseconds;
+
+                qDebug() << "JS8 submode"  << Mode::NSUBMODE
+                         << "energy gate searched" << stats.searched << "of" << stats.bins << "bins"
+                         << "in" << duration_cast<microseconds>(stats.gated).count()    << "us, full search"
+                                 << duration_cast<microseconds>(stats.complete).count() << "us; recalled"
+                         << stats.recalled << "of" << stats.expected << "candidates";
+            }
 
-                            emitEvent(JS8::Event::Decoded{data.params.nutc,
-                                                          snr,
-                                                          xdt - Mode::ASTART,
-                                                          f1,
-                                                          it->first.data,
-                                                          it->first.type,
-                                                          1.0f - nharderrors / 60.0f,
-                                                          Mode::NSUBMODE});
-                        }
+            // Likewise for belief propagation; per pass, the number of attempts
+            // by iterations run, followed by the outcomes.
+
+            if (data.params.bpRecall)
+            {
+                for (int pass = 0; pass < BP_MAX_PASSES; ++pass)
+                {
+                    std::string histogram;
+
+                    for (std::size_t i = 1; i < bpstats.iterations[pass].size(); ++i)
+                    {
+                        if (i > 1) histogram += ' ';
+                        histogram += std::to_string(bpstats.iterations[pass][i]);
                     }
+
+                    qDebug() << "JS8 submode" << Mode::NSUBMODE
+                             << "BP pass"     << pass + 1
+                             << "iterations"  << histogram.c_str()
+                             << "; attempts"  << bpstats.attempts[pass]
+                             << "decoded"     << bpstats.decoded[pass]
+                             << "abortable"   << bpstats.aborted[pass]
+                             << "triaged"     << bpstats.skipped[pass]
+                             << "lost"        << bpstats.lost[pass];
                 }
+            }
 
-                // If nothing from this pass improved our situation, there's no
-                // point in trying any remaining passes.
+            // Likewise for ordered statistics decoding, which is opt in; report
+            // on what it's bought us, in terms that permit a decision as to
+            // whether what it costs is worth paying on this hardware.
 
-                if (!improved) break;
+            if (osdstats.attempts || osdstats.skipped)
+            {
+                using std::chrono::duration;
+                using std::chrono::duration_cast;
+                using std::chrono::microseconds;
+
+                auto const ms = duration<double, std::milli>(osdstats.elapsed).count();
+
+                qDebug() << "JS8 submode" << Mode::NSUBMODE
+                         << "OSD depth"   << data.params.osdDepth
+                         << "decoded"     << osdstats.decoded  << "of" << osdstats.attempts << "near misses,"
+                         << osdstats.skipped << "over budget, in"
+                         << duration_cast<microseconds>(osdstats.elapsed).count() << "us;"
+                         << (ms > 0.0 ? osdstats.decoded / ms : 0.0) << "decodes per ms";
             }
 
+            // Likewise for a priori decoding, when we've had hints to try.
+
+            if (apstats.attempts)
+            {
+                qDebug() << "JS8 submode" << Mode::NSUBMODE
+                         << "AP decoded"  << apstats.decoded << "of" << apstats.attempts << "hinted candidates,"
+                         << apstats.rejected << "rejected";
+            }
+
+            stats    = {};
+            bpstats  = {};
+            osdstats = {};
+            apstats  = {};
+
             // Let the caller know how many unique decodes we discovered, if any.
 
             return decodes.size();
@@ -2550,10 +3572,45 @@ namespace JS8
 
         // Called by the owning Decoder to refresh the copy of the
         // decode data that the Worker implementation references.
-
-        void copy()
+        //
+        // We're handed a snapshot of the parameters, taken under the
+        // detector lock; the frames are copied without it. The audio
+        // thread only ever writes at or beyond the write position in
+        // the snapshot, and the windows we've been asked to decode lie
+        // behind it, so only the frames within them are copied, and
+        // the rest of the buffer, which won't be looked at, is left
+        // alone.
+
+        void copy(dec_data::dec_params const & params)
         {
-            m_data = dec_data;
+            m_data.params = params;
+
+            std::array const windows =
+            {
+                std::tuple{1 << 0, params.kposA, params.kszA},
+                std::tuple{1 << 1, params.kposB, params.kszB},
+                std::tuple{1 << 2, params.kposC, params.kszC},
+                std::tuple{1 << 3, params.kposE, params.kszE},
+                std::tuple{1 << 4, params.kposI, params.kszI}
+            };
+
+            for (auto const & [mode, kpos, ksz] : windows)
+            {
+                if ((params.nsubmodes & mode) != mode) continue;
+
+                // Same wrap handling as the decode entry point.
+
+                auto const pos   = std::clamp(kpos, 0, JS8_RX_SAMPLE_SIZE);
+                auto const sz    = std::clamp(ksz,  0, JS8_RX_SAMPLE_SIZE);
+                auto const first = std::min(sz, JS8_RX_SAMPLE_SIZE - pos);
+
+                std::copy(std::begin(dec_data.d2) + pos,
+                          std::begin(dec_data.d2) + pos + first,
+                          std::begin(m_data.d2)   + pos);
+                std::copy(std::begin(dec_data.d2),
+                          std::begin(dec_data.d2) + sz - first,
+                          std::begin(m_data.d2));
+            }
         };
 
     signals:
@@ -2635,9 +3692,9 @@ namespace JS8
     }
 
     void
-    Decoder::decode()
+    Decoder::decode(dec_data::dec_params const & params)
     {
-        m_worker->copy();
+        m_worker->copy(params);
         m_semaphore.release();
     }
 }
@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QSemaphore>
 #include <QThread>
+#include "commons.h"
 
 namespace JS8
 {
@@ -127,6 +128,11 @@ namespace JS8
       
     Decoder(QObject * parent = nullptr);
 
+    // Start a decoding pass with the provided parameters, copying the
+    // frames they refer to from the shared buffer.
+
+    void decode(dec_data::dec_params const & params);
+
   signals:
 
       void decodeEvent(Event::Variant const &);
@@ -135,7 +141,6 @@ namespace JS8
 
     void start(QThread::Priority priority);
     void quit();
-    void decode();
   };
 }
 
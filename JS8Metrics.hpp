@@ -0,0 +1,137 @@
+#ifndef JS8_METRICS_HPP__
+#define JS8_METRICS_HPP__
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Soft symbol metrics for the JS8 decoder; kept apart from the rest of the
+// decoder so that they can be checked against the direct computation that
+// they replaced, and timed, on their own.
+
+namespace JS8::Metrics
+{
+    constexpr int ND    = 58;   // Data symbols
+    constexpr int NN    = 79;   // Total channel symbols
+    constexpr int NROWS = 8;    // Tones
+
+    // Natural logarithm, for positive, finite, normal arguments, accurate to
+    // within 1e-5; splits the argument into exponent and mantissa, folding
+    // the mantissa into [sqrt(1/2), sqrt(2)), and evaluates log(m) by way of
+    // the atanh series, 2 * atanh((m - 1) / (m + 1)). Unlike std::log(), it
+    // has no error handling or special cases to get in the way of vectorizing.
+
+    inline float
+    fastlog(float const x)
+    {
+        constexpr float LN2   = 0.69314718f;
+        constexpr float SQRT2 = 1.41421356f;
+
+        auto const bits = std::bit_cast<std::uint32_t>(x);
+        auto       e    = static_cast<int>(bits >> 23) - 127;
+        auto       m    = std::bit_cast<float>((bits & 0x007fffffu) | 0x3f800000u);
+
+        if (m > SQRT2)
+        {
+            m *= 0.5f;
+            e += 1;
+        }
+
+        float const z  = (m - 1.0f) / (m + 1.0f);
+        float const z2 = z * z;
+
+        return e * LN2 + z * (2.0f + z2 * (2.0f / 3.0f + z2 * (2.0f / 5.0f + z2 * (2.0f / 7.0f))));
+    }
+
+    // Computes bit metrics for the data symbols of the tone magnitudes in s2,
+    // both in the linear (llr0) and log (llr1) domains, normalized to a fixed
+    // standard deviation. The metric for a bit is the difference between the
+    // strongest tone in which the bit is set and the strongest in which it's
+    // clear; we make one pass over the symbols, computing all three of the
+    // metrics for each, and accumulating the normalization moments as we go,
+    // and then a second to scale and interleave them.
+    //
+    // Since log is monotonic, the max of the log tone magnitudes is the log
+    // of the max; we therefore need only 2 logs per bit, rather than the 8
+    // per symbol of the direct approach.
+
+    inline void
+    softmetrics(std::array<std::array<float, NN>, NROWS> const & s2,
+                std::array<float, 3 * ND>                      & llr0,
+                std::array<float, 3 * ND>                      & llr1)
+    {
+        constexpr float EPSILON = 1e-32f;
+        constexpr float SIGMA   = 2.83f;
+
+        // Metrics by bit, i.e., r4, r2, r1, and then by symbol.
+
+        std::array<std::array<float, ND>, 3> m0;
+        std::array<std::array<float, ND>, 3> m1;
+
+        // Sums and sums of squares, by bit.
+
+        std::array<float, 3> sum0 = {}, squares0 = {};
+        std::array<float, 3> sum1 = {}, squares1 = {};
+
+        auto const metric = [&](int const bit,
+                                int const j,
+                                float const set,
+                                float const clear)
+        {
+            float const v0 = set - clear;
+            float const v1 = fastlog(set + EPSILON) - fastlog(clear + EPSILON);
+
+            m0[bit][j] = v0;
+            m1[bit][j] = v1;
+
+            sum0[bit] += v0; squares0[bit] += v0 * v0;
+            sum1[bit] += v1; squares1[bit] += v1 * v1;
+        };
+
+        // The data symbols lie between the Costas arrays, 7 through 35 and
+        // 43 through 71.
+
+        for (int j = 0; j < ND; ++j)
+        {
+            int const k = j < 29 ? j + 7 : j + 14;
+
+            float const p0 = s2[0][k], p1 = s2[1][k], p2 = s2[2][k], p3 = s2[3][k];
+            float const p4 = s2[4][k], p5 = s2[5][k], p6 = s2[6][k], p7 = s2[7][k];
+
+            metric(0, j, std::max(std::max(p4, p5), std::max(p6, p7)), std::max(std::max(p0, p1), std::max(p2, p3))); // r4
+            metric(1, j, std::max(std::max(p2, p3), std::max(p6, p7)), std::max(std::max(p0, p1), std::max(p4, p5))); // r2
+            metric(2, j, std::max(std::max(p1, p3), std::max(p5, p7)), std::max(std::max(p0, p2), std::max(p4, p6))); // r1
+        }
+
+        // Scale factor giving the metrics a standard deviation of SIGMA; if
+        // the variance is degenerate, use the mean square instead.
+
+        auto const scale = [](std::array<float, 3> const & sum,
+                              std::array<float, 3> const & squares)
+        {
+            constexpr float SIZE = 3 * ND;
+
+            float const llrav    = (sum[0]     + sum[1]     + sum[2])     / SIZE;
+            float const llr2av   = (squares[0] + squares[1] + squares[2]) / SIZE;
+            float const variance = llr2av - llrav * llrav;
+
+            return SIGMA / std::sqrt(variance > 0.0f ? variance : llr2av);
+        };
+
+        float const scale0 = scale(sum0, squares0);
+        float const scale1 = scale(sum1, squares1);
+
+        for (int j = 0; j < ND; ++j)
+        {
+            for (int bit = 0; bit < 3; ++bit)
+            {
+                llr0[3 * j + bit] = m0[bit][j] * scale0;
+                llr1[3 * j + bit] = m1[bit][j] * scale1;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,377 @@
+#include "LogDispatcher.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <QDebug>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QQueue>
+#include <QSaveFile>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include "pimpl_impl.hpp"
+#include "moc_LogDispatcher.cpp"
+
+/******************************************************************************/
+// Constants
+/******************************************************************************/
+
+namespace
+{
+  using namespace std::chrono_literals;
+
+  constexpr auto RETRY_MIN       = 5s;     // first retry after a failure
+  constexpr auto RETRY_MAX       = 300s;   // longest we'll wait between retries
+  constexpr auto CONNECT_TIMEOUT = 5s;     // to establish a TCP connection
+  constexpr auto SETTLE_DELAY    = 300ms;  // after writing a command, before counting it delivered
+  constexpr int  MAX_PENDING     = 500;    // per target; oldest dropped beyond
+}
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+class LogDispatcher::impl final : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  struct Entry
+  {
+    QString    host;
+    quint16    port;
+    QByteArray data;
+  };
+
+  struct Channel
+  {
+    QQueue<Entry>        pending;
+    QTimer             * retry   = nullptr;
+    std::chrono::seconds backoff = RETRY_MIN;
+  };
+
+  // Constructor; the queue is loaded here, rather than in start(), so that
+  // anything enqueued before we've been started joins it, rather than our
+  // saving over it.
+
+  impl(QString const & path,
+       LogDispatcher * self)
+    : QObject  {self}
+    , self_    {self}
+    , path_    {path}
+    , udp_     {new QUdpSocket {this}}
+    , tcp_     {new QTcpSocket {this}}
+    , connect_ {new QTimer     {this}}
+    , settle_  {new QTimer     {this}}
+  {
+    for (auto & channel : channels_)
+    {
+      channel.retry = new QTimer {this};
+      channel.retry->setSingleShot(true);
+    }
+
+    connect_->setSingleShot(true);
+    settle_->setSingleShot(true);
+
+    load();
+  }
+
+  // Intended to be called on the thread that starts us, which can be
+  // the main thread, if we're not going to be moved to a background
+  // thread.
+
+  void
+  start()
+  {
+    connect(channels_[N1MM ].retry, &QTimer::timeout, this, &impl::sendN1MM);
+    connect(channels_[N3FJP].retry, &QTimer::timeout, this, &impl::sendN3FJP);
+
+    connect(tcp_, &QTcpSocket::connected, this, [this]()
+    {
+      connect_->stop();
+      busy_ = false;
+      sendN3FJP();
+    });
+
+    // N3FJP doesn't acknowledge a command, so the most we can know is that
+    // it was handed off to the network in its entirety, and the connection
+    // was still up a moment later. A connection that N3FJP had closed is
+    // reset by our writing to it; that fails the command, and it's sent
+    // again. This isn't an acknowledgement; a command is lost if N3FJP
+    // goes away later without having acted on it, and sent twice if the
+    // connection fails just after it did act on it.
+
+    connect(tcp_, &QTcpSocket::bytesWritten, this, [this]()
+    {
+      if (busy_ && tcp_->bytesToWrite() == 0 && !settle_->isActive()) settle_->start(SETTLE_DELAY);
+    });
+
+    // Still connected, or we'd have heard otherwise; have N3FJP refresh its
+    // log display, and carry on with the next command, if any.
+
+    connect(settle_, &QTimer::timeout, this, [this]()
+    {
+      busy_ = false;
+      delivered(N3FJP);
+
+      tcp_->write("<CMD><CHECKLOG></CMD>\r\f");
+      tcp_->write("\r\n\r\f");
+
+      sendN3FJP();
+    });
+
+    // N3FJP is free to close the connection on us when we're idle; that's
+    // only a failure if we were in the middle of something.
+
+    connect(tcp_, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError)
+    {
+      if (!busy_) return;
+
+      connect_->stop();
+      settle_->stop();
+      busy_ = false;
+      tcp_->abort();
+      failed(N3FJP, tcp_->errorString());
+    });
+
+    connect(connect_, &QTimer::timeout, this, [this]()
+    {
+      busy_ = false;
+      tcp_->abort();
+      failed(N3FJP, QString {"Connection to %1:%2 timed out"}.arg(channels_[N3FJP].pending.head().host)
+                                                            .arg(channels_[N3FJP].pending.head().port));
+    });
+
+    started_ = true;
+
+    sendN1MM();
+    sendN3FJP();
+  }
+
+  void
+  enqueue(Target  const target,
+          Entry         entry)
+  {
+    auto & channel = channels_[target];
+
+    channel.pending.enqueue(std::move(entry));
+
+    while (channel.pending.size() > MAX_PENDING)
+    {
+      channel.pending.dequeue();
+      qDebug() << "LogDispatcher dropped oldest pending record for" << name(target);
+    }
+
+    save();
+
+    if (!started_) return;
+
+    if (target == N1MM) sendN1MM();
+    else                sendN3FJP();
+  }
+
+private:
+
+  static char const *
+  name(Target const target)
+  {
+    return QMetaEnum::fromType<Target>().valueToKey(target);
+  }
+
+  // N1MM takes an ADIF record per datagram; all we'll hear of a failure is
+  // an inability to send it at all.
+
+  void
+  sendN1MM()
+  {
+    auto & channel = channels_[N1MM];
+
+    while (!channel.pending.isEmpty() && !channel.retry->isActive())
+    {
+      auto const & entry = channel.pending.head();
+
+      if (udp_->writeDatagram(entry.data, QHostAddress {entry.host}, entry.port) < 0)
+      {
+        failed(N1MM, udp_->errorString());
+        return;
+      }
+
+      delivered(N1MM);
+    }
+  }
+
+  // N3FJP takes a command per write over a connection we keep open; one
+  // command at a time, connecting, or reconnecting, as required.
+
+  void
+  sendN3FJP()
+  {
+    auto & channel = channels_[N3FJP];
+
+    if (busy_ || channel.pending.isEmpty() || channel.retry->isActive()) return;
+
+    auto const & entry = channel.pending.head();
+
+    if (tcp_->state() != QAbstractSocket::UnconnectedState &&
+        (tcp_->peerName() != entry.host || tcp_->peerPort() != entry.port))
+    {
+      tcp_->abort();
+    }
+
+    busy_ = true;
+
+    if (tcp_->state() == QAbstractSocket::ConnectedState)
+    {
+      tcp_->write(entry.data + "\r\f");
+    }
+    else
+    {
+      if (tcp_->state() == QAbstractSocket::UnconnectedState) tcp_->connectToHost(entry.host, entry.port);
+
+      connect_->start(CONNECT_TIMEOUT);
+    }
+  }
+
+  void
+  delivered(Target const target)
+  {
+    auto & channel = channels_[target];
+
+    channel.pending.dequeue();
+    channel.backoff = RETRY_MIN;
+
+    save();
+
+    Q_EMIT self_->status(target, true, channel.pending.size(), {});
+  }
+
+  void
+  failed(Target  const   target,
+         QString const & message)
+  {
+    auto & channel = channels_[target];
+
+    qDebug() << "LogDispatcher" << name(target) << "failed:" << message
+             << "; retrying in" << channel.backoff.count() << "s";
+
+    channel.retry->start(channel.backoff);
+    channel.backoff = std::min(channel.backoff * 2, std::chrono::seconds {RETRY_MAX});
+
+    Q_EMIT self_->status(target, false, channel.pending.size(), message);
+  }
+
+  // Pending records, for all targets, as a JSON array; the file exists only
+  // while there's something pending.
+
+  void
+  load()
+  {
+    QFile file {path_};
+
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    auto const metaEnum = QMetaEnum::fromType<Target>();
+
+    for (auto const value : QJsonDocument::fromJson(file.readAll()).array())
+    {
+      auto const object = value.toObject();
+      bool       ok     = false;
+      auto const target = metaEnum.keyToValue(object["TARGET"].toString().toLatin1().constData(), &ok);
+
+      if (!ok) continue;
+
+      channels_[target].pending.enqueue({object["HOST"].toString(),
+                                         static_cast<quint16>(object["PORT"].toInt()),
+                                         object["DATA"].toString().toUtf8()});
+    }
+
+    for (Target const target : {N1MM, N3FJP})
+    {
+      if (auto const count = channels_[target].pending.size()) qDebug() << "LogDispatcher" << name(target) << "has" << count << "pending";
+    }
+  }
+
+  void
+  save()
+  {
+    QJsonArray array;
+
+    for (Target const target : {N1MM, N3FJP})
+    {
+      for (auto const & entry : channels_[target].pending)
+      {
+        array.append(QJsonObject {
+          {"TARGET", name(target)},
+          {"HOST",   entry.host},
+          {"PORT",   entry.port},
+          {"DATA",   QString::fromUtf8(entry.data)}
+        });
+      }
+    }
+
+    if (array.isEmpty())
+    {
+      QFile::remove(path_);
+      return;
+    }
+
+    QSaveFile file {path_};
+
+    if (file.open(QIODevice::WriteOnly))
+    {
+      file.write(QJsonDocument {array}.toJson(QJsonDocument::Compact));
+      if (file.commit()) return;
+    }
+
+    qDebug() << "LogDispatcher unable to save pending records:" << file.errorString();
+  }
+
+  // Data members
+
+  LogDispatcher         * self_;
+  QString                 path_;
+  QUdpSocket            * udp_;
+  QTcpSocket            * tcp_;
+  QTimer                * connect_;
+  QTimer                * settle_;
+  std::array<Channel, 2>  channels_;
+  bool                    busy_    = false;   // connecting, or a command in flight
+  bool                    started_ = false;
+};
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+#include "LogDispatcher.moc"
+
+// Constructor
+
+LogDispatcher::LogDispatcher(QString const & queuePath,
+                             QObject       * parent)
+  : QObject {parent}
+  , m_      {queuePath, this}
+{}
+
+void
+LogDispatcher::start()
+{
+  m_->start();
+}
+
+void
+LogDispatcher::enqueue(Target     const   target,
+                       QString    const & host,
+                       quint16    const   port,
+                       QByteArray const & data)
+{
+  m_->enqueue(target, {host, port, data});
+}
+
+/******************************************************************************/
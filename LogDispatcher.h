@@ -0,0 +1,50 @@
+#ifndef LOGDISPATCHER_H
+#define LOGDISPATCHER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include "pimpl_h.hpp"
+
+// Delivers logged QSOs to external logging programs, off the GUI thread.
+// Each target has a queue of pending records, delivered in order; those
+// that can't be delivered are retried, backing off, until they can be.
+// Pending records are kept in a file, so that they survive a restart.
+
+class LogDispatcher final : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  enum Target
+  {
+    N1MM,   // ADIF record by UDP datagram
+    N3FJP   // API command over a TCP connection
+  };
+  Q_ENUM(Target)
+
+  explicit LogDispatcher(QString const & queuePath,
+                         QObject       * parent = nullptr);
+
+  void start();
+
+  void enqueue(LogDispatcher::Target target,
+               QString       const & host,
+               quint16               port,
+               QByteArray    const & data);
+
+  // Emitted on each delivery, and on each failed attempt at one, with the
+  // number of records still pending for the target.
+
+  Q_SIGNAL void status(LogDispatcher::Target target,
+                       bool                  delivered,
+                       int                   pending,
+                       QString const &       message) const;
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+#endif // LOGDISPATCHER_H
@@ -0,0 +1,104 @@
+#include "MemoryAccounting.hpp"
+#include <algorithm>
+#include <QLocale>
+
+namespace
+{
+  QString
+  formatBytes(qsizetype const bytes)
+  {
+    return QLocale::c().formattedDataSize(bytes, 1, QLocale::DataSizeTraditionalFormat);
+  }
+}
+
+qsizetype
+MemoryAccounting::heap(QString const & string)
+{
+  return string.capacity() ? sizeof(QArrayData) + string.capacity() * sizeof(QChar) : 0;
+}
+
+qsizetype
+MemoryAccounting::heap(QByteArray const & bytes)
+{
+  return bytes.capacity() ? sizeof(QArrayData) + bytes.capacity() : 0;
+}
+
+void
+MemoryAccounting::add(QString const & name,
+                      Reporter        reporter)
+{
+  m_reporters.push_back(std::move(reporter));
+  m_entries.push_back({name, {}, {}});
+}
+
+void
+MemoryAccounting::sample()
+{
+  for (std::size_t index = 0; index < m_reporters.size(); ++index)
+  {
+    auto & entry = m_entries[index];
+
+    entry.current    = m_reporters[index]();
+    entry.peak.count = std::max(entry.peak.count, entry.current.count);
+    entry.peak.bytes = std::max(entry.peak.bytes, entry.current.bytes);
+  }
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::total() const
+{
+  Usage usage;
+
+  for (auto const & entry : m_entries) usage += entry.current;
+
+  return usage;
+}
+
+QString
+MemoryAccounting::toText() const
+{
+  QString text;
+
+  text += QString("%1 %2 %3 %4 %5\n").arg("Structure", -28)
+                                     .arg("Count", 9)
+                                     .arg("Size", 10)
+                                     .arg("Peak count", 11)
+                                     .arg("Peak size", 10);
+
+  for (auto const & entry : m_entries)
+  {
+    text += QString("%1 %2 %3 %4 %5\n").arg(entry.name, -28)
+                                       .arg(entry.current.count, 9)
+                                       .arg(formatBytes(entry.current.bytes), 10)
+                                       .arg(entry.peak.count, 11)
+                                       .arg(formatBytes(entry.peak.bytes), 10);
+  }
+
+  auto const usage = total();
+
+  text += QString("\n%1 elements, about %2 in all\n").arg(usage.count)
+                                                      .arg(formatBytes(usage.bytes));
+
+  return text;
+}
+
+QVariantMap
+MemoryAccounting::toVariantMap() const
+{
+  QVariantMap map;
+
+  for (auto const & entry : m_entries)
+  {
+    map[entry.name] = QVariantMap
+    {
+      {"COUNT",      QVariant(qlonglong(entry.current.count))},
+      {"BYTES",      QVariant(qlonglong(entry.current.bytes))},
+      {"PEAK_COUNT", QVariant(qlonglong(entry.peak.count))},
+      {"PEAK_BYTES", QVariant(qlonglong(entry.peak.bytes))}
+    };
+  }
+
+  return map;
+}
+
+/******************************************************************************/
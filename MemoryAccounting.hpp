@@ -0,0 +1,82 @@
+#ifndef MEMORY_ACCOUNTING_HPP__
+#define MEMORY_ACCOUNTING_HPP__
+
+#include <functional>
+#include <vector>
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+
+// Approximate accounting of the memory held by the major caches and
+// containers of a station that's left running for weeks. Each is added
+// with a function reporting its current element count and size in bytes;
+// sampling calls them all, in registration order, and keeps the high-water
+// mark of each.
+//
+// Sizes are estimates, built from element counts, string capacities and
+// the usual per-node overhead of the container involved, rather than
+// measured by the allocator; they're meant to show which structures grow,
+// not to account for every byte. Reporters are called on the thread that
+// samples, which is expected to be the GUI thread; anything owned by some
+// other thread must report in a way that's safe to call from there.
+
+class MemoryAccounting final
+{
+public:
+
+  struct Usage
+  {
+    qsizetype count = 0;   // elements
+    qsizetype bytes = 0;   // approximate, including the elements
+
+    Usage &
+    operator+=(Usage const & other)
+    {
+      count += other.count;
+      bytes += other.bytes;
+      return *this;
+    }
+  };
+
+  struct Entry
+  {
+    QString name;
+    Usage   current;
+    Usage   peak;      // high-water mark of each, independently
+  };
+
+  using Reporter = std::function<Usage()>;
+
+  // Per-node overhead of the Qt containers, in addition to the key and value
+  // stored in the node; QMap is a std::map underneath, and QHash keeps its
+  // nodes in spans, with a byte of offset per bucket.
+
+  static constexpr qsizetype MAP_NODE  = 4 * sizeof(void *);
+  static constexpr qsizetype HASH_NODE = 2;
+
+  // Heap held by a value beyond its own size; shared data is counted each
+  // time it's seen, so this errs on the high side.
+
+  static qsizetype heap(QString    const &);
+  static qsizetype heap(QByteArray const &);
+
+  // Register a structure; its reporter is called on every sample.
+  void add(QString const & name,
+           Reporter        reporter);
+
+  // Call every reporter, updating the current usage and high-water marks.
+  void sample();
+
+  std::vector<Entry> const & entries() const { return m_entries; }
+  Usage                      total()   const;
+
+  QString     toText()       const;
+  QVariantMap toVariantMap() const;
+
+private:
+
+  std::vector<Reporter> m_reporters;
+  std::vector<Entry>    m_entries;
+};
+
+#endif
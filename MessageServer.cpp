@@ -147,6 +147,8 @@ void Client::setSocket(qintptr handle){
     connect(m_socket, &QTcpSocket::readyRead, this, &Client::readyRead);
 
     m_socket->setSocketDescriptor(handle);
+
+    m_name = QString("tcp:%1:%2").arg(m_socket->peerAddress().toString()).arg(m_socket->peerPort());
 }
 
 void Client::setConnected(bool connected){
@@ -206,7 +208,7 @@ void Client::readyRead(){
         {
             auto m = Message::fromJson(msg);
             m_requests[m.ensureId()] = m;
-            emit m_server->message(m);
+            emit m_server->message(m, m_name);
         }
         catch (std::exception const & e)
         {
@@ -24,7 +24,8 @@ protected:
     void incomingConnection(qintptr handle);
 
 signals:
-    void message(Message const &message);
+    // the client is named for the peer it's connected to, e.g. "tcp:127.0.0.1:52110"
+    void message(Message const &message, QString const &client);
     void error (QString const&) const;
 
 public slots:
@@ -69,6 +70,7 @@ public slots:
 private:
     QMap<qint64, Message> m_requests;
     MessageServer * m_server;
+    QString m_name;
     QTcpSocket * m_socket;
     bool m_connected;
 };
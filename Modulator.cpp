@@ -1,4 +1,6 @@
 #include "Modulator.hpp"
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 #include <QDateTime>
@@ -125,8 +127,9 @@ Modulator::readData(char * const data,
 
   qint64               framesGenerated = 0;
   qint64         const maxFrames       = maxSize / bytesPerFrame();
+  qint64         const samplesPerFrame = bytesPerFrame() / sizeof(qint16);
   qint16       *       samples         = reinterpret_cast<qint16 *>(data);
-  qint16 const * const samplesEnd      = samples + maxFrames * (bytesPerFrame() / sizeof(qint16));
+  qint16       * const samplesEnd      = samples + maxFrames * samplesPerFrame;
 
   switch (m_state)
   {
@@ -137,12 +140,9 @@ Modulator::readData(char * const data,
         // Send silence up to end of start delay.
 
         framesGenerated = qMin(m_silentFrames, maxFrames);
+        m_silentFrames -= framesGenerated;
 
-        do
-        {
-          samples = load(0, samples);
-        }
-        while (--m_silentFrames && samples != samplesEnd);
+        samples = std::fill_n(samples, framesGenerated * samplesPerFrame, 0);
 
         if (!m_silentFrames)
         {
@@ -159,29 +159,40 @@ Modulator::readData(char * const data,
       unsigned int const i0 = (m_tuning ? 9999 : (JS8_NUM_SYMBOLS - 0.017) * 4.0) * m_nsps;
       unsigned int const i1 = (m_tuning ? 9999 :  JS8_NUM_SYMBOLS          * 4.0) * m_nsps;
 
+      // Generated as mono, a block at a time, and then spread into frames
+      // in the channels we're sending on.
+
       while (samples != samplesEnd && m_ic < i1)
       {
-        unsigned int const isym = m_tuning ? 0 : m_ic / (4.0 * m_nsps);
+        std::array<qint16, 1024> block;
 
-        if (isym != m_isym0 || m_frequency != m_frequency0)
+        auto const frames = std::min<std::size_t>(block.size(), (samplesEnd - samples) / samplesPerFrame);
+        auto       count  = std::size_t{0};
+
+        for (; count < frames && m_ic < i1; ++count, ++m_ic)
         {
-          double const toneFrequency = m_frequency + itone[isym] * m_toneSpacing;
+          unsigned int const isym = m_tuning ? 0 : m_ic / (4.0 * m_nsps);
 
-          m_dphi       = TAU * toneFrequency / FRAME_RATE;
-          m_isym0      = isym;
-          m_frequency0 = m_frequency;
-        }
+          if (isym != m_isym0 || m_frequency != m_frequency0)
+          {
+            double const toneFrequency = m_frequency + itone[isym] * m_toneSpacing;
 
-        m_phi += m_dphi;
+            m_dphi       = TAU * toneFrequency / FRAME_RATE;
+            m_isym0      = isym;
+            m_frequency0 = m_frequency;
+          }
 
-        if (m_phi > TAU) m_phi -= TAU;
-        if (m_ic  > i0)  m_amp  = 0.98 * m_amp;
-        if (m_ic  > i1)  m_amp  = 0.0;
+          m_phi += m_dphi;
 
-        samples = load(qRound(m_amp * qSin(m_phi)), samples);
+          if (m_phi > TAU) m_phi -= TAU;
+          if (m_ic  > i0)  m_amp  = 0.98 * m_amp;
+          if (m_ic  > i1)  m_amp  = 0.0;
 
-        ++framesGenerated;
-        ++m_ic;
+          block[count] = qRound(m_amp * qSin(m_phi));
+        }
+
+        samples          = load(block.data(), count, samples);
+        framesGenerated += count;
       }
 
       if (m_amp == 0.0)
@@ -196,11 +207,8 @@ Modulator::readData(char * const data,
       // Done for this chunk; continue on the next call. Pad the
       // block with silence.
 
-      while (samples != samplesEnd)
-      {
-        samples = load(0, samples);
-        ++framesGenerated;
-      }
+      framesGenerated += (samplesEnd - samples) / samplesPerFrame;
+      std::fill(samples, samplesEnd, 0);
 
       return framesGenerated * bytesPerFrame();
     }
@@ -1,15 +1,35 @@
 #include "NotificationAudio.h"
+#include <algorithm>
+#include <vector>
 #include <QDebug>
+#include <QIODevice>
 #include "Audio/BWFFile.hpp"
+#include "AudioKernels.hpp"
+#include "NotificationMixer.hpp"
 #include "soundout.h"
 
+/******************************************************************************/
+// Local Constants
+/******************************************************************************/
+
+namespace
+{
+    // Output buffer size used when the caller doesn't specify one; this is
+    // the bound on how long a triggered sound can wait behind silence that
+    // has already been handed to the device.
+
+    constexpr unsigned DEFAULT_MS_BUFFER = 40;
+}
+
 /******************************************************************************/
 // Public Implementation
 /******************************************************************************/
 
 NotificationAudio::NotificationAudio(QObject * parent)
-    : QObject  {parent}
-    , m_stream {new SoundOutput}
+    : QObject    {parent}
+    , m_stream   {new SoundOutput}
+    , m_mixer    {new NotificationMixer}
+    , m_msBuffer {0}
 {
     connect(m_stream.data(), &SoundOutput::status, this, &NotificationAudio::status);
     connect(m_stream.data(), &SoundOutput::error,  this, &NotificationAudio::error);
@@ -17,12 +37,16 @@ NotificationAudio::NotificationAudio(QObject * parent)
 
 NotificationAudio::~NotificationAudio()
 {
-    stop();
+    m_stream->stop();
+    report();
 }
 
 void NotificationAudio::status(QString const message)
 {
-    if (message == "Idle") stop();
+    // The mixer never runs dry, so the stream should never go idle; if it
+    // does, the device has likely gone away underneath us.
+
+    if (message == "Idle") qDebug() << "notification stream unexpectedly idle";
 }
 
 void NotificationAudio::error(QString const message)
@@ -30,57 +54,189 @@ void NotificationAudio::error(QString const message)
     qDebug() << "notification error:" << message;
 }
 
+// Open the stream on the device, once, in the device's preferred format,
+// limited to at most 2 channels. We mix in float, so use that if we can,
+// and 16-bit integer otherwise. Anything already loaded is rendered again
+// to suit.
+
 void
 NotificationAudio::setDevice(QAudioDevice const & device,
                              unsigned     const   msBuffer)
 {
+    m_stream->stop();
+    m_mixer->setFormat({});
+
+    report();
+
     m_device   = device;
-    m_msBuffer = msBuffer;
+    m_msBuffer = msBuffer ? msBuffer : DEFAULT_MS_BUFFER;
+    m_format   = {};
+
+    if (m_device.isNull()) return;
+
+    auto format = m_device.preferredFormat();
+
+    format.setChannelCount(std::clamp(format.channelCount(), 1, 2));
+    format.setSampleFormat(QAudioFormat::Float);
+
+    if (!m_device.isFormatSupported(format)) format.setSampleFormat(QAudioFormat::Int16);
+
+    m_format = format;
+
+    for (auto & entry : m_cache) entry.sound = render(entry);
+
+    m_mixer->setFormat(m_format);
+    m_stream->setDeviceFormat(m_device, m_format, m_msBuffer);
+    m_stream->restart(m_mixer.data());
 }
 
+// Load and render, ahead of time, the sounds we expect to be asked to play.
+
 void
-NotificationAudio::play(QString const & filePath)
+NotificationAudio::prepare(QStringList const & filePaths)
 {
-    if (auto const it  = m_cache.constFind(filePath);
-                   it != m_cache.constEnd())
+    for (auto const & filePath : filePaths)
     {
-        playEntry(it);
-    }
-    else if (auto file = BWFFile(QAudioFormat{}, filePath);
-                  file.open(QIODevice::ReadOnly))
-    {
-        if (auto data = file.readAll();
-                !data.isEmpty())
-        {
-            playEntry(m_cache.emplace(filePath, file.format(), data));
-        }
+        if (!m_cache.contains(filePath)) load(filePath);
     }
 }
 
+void
+NotificationAudio::play(QString const & filePath)
+{
+    auto it = m_cache.find(filePath);
+
+    if (it == m_cache.end()) it = load(filePath);
+
+    if (it != m_cache.end() && it->sound) m_mixer->add(it->sound);
+}
+
 void
 NotificationAudio::stop()
 {
-    m_stream->stop();
+    m_mixer->clear();
 }
 
 /******************************************************************************/
 // Private Implementation
 /******************************************************************************/
 
+// Summarize the time from trigger to mix of the sounds played since we last
+// looked; the mixer only keeps the tally, since it runs on the thread that
+// feeds the device.
+
 void
-NotificationAudio::playEntry(Cache::const_iterator const it)
+NotificationAudio::report()
 {
-    if (m_buffer.isOpen()) m_buffer.close();
+    if (auto const latency = m_mixer->latency(); latency.count)
+    {
+        qDebug() << "notification latency:" << latency.count << "sounds, mean"
+                 << latency.totalNs / latency.count / 1000 << "us, max"
+                 << latency.maxNs / 1000 << "us";
+    }
+}
 
-    auto const & [format, data] = *it;
+NotificationAudio::Cache::iterator
+NotificationAudio::load(QString const & filePath)
+{
+    if (auto file = BWFFile(QAudioFormat{}, filePath);
+             file.open(QIODevice::ReadOnly))
+    {
+        if (auto data = file.readAll();
+                !data.isEmpty())
+        {
+            auto entry = Entry{file.format(), data, {}};
+
+            entry.sound = render(entry);
+
+            return m_cache.insert(filePath, entry);
+        }
+    }
+
+    qDebug() << "notification unable to load:" << filePath;
 
-    m_buffer.setData(data);
+    return m_cache.end();
+}
+
+// Decode a sound to interleaved float samples in the output format; map
+// channels, downmixing to mono or duplicating mono as required, and then
+// resample to the output rate by linear interpolation, which is adequate
+// for alert tones.
+
+NotificationAudio::Sound
+NotificationAudio::render(Entry const & entry) const
+{
+    auto const & in = entry.format;
+
+    if (!m_format.isValid() || !in.isValid() || in.bytesPerFrame() <= 0) return {};
 
-    if (m_buffer.open(QIODevice::ReadOnly))
+    auto const inChannels    = in.channelCount();
+    auto const outChannels   = m_format.channelCount();
+    auto const bytesPerFrame = in.bytesPerFrame();
+    auto const bytesPerSamp  = in.bytesPerSample();
+    auto const frames        = entry.data.size() / bytesPerFrame;
+
+    if (frames == 0) return {};
+
+    // 16-bit samples, by far the most common, are converted in one go;
+    // anything else, a sample at a time.
+
+    std::vector<float> converted;
+
+    if (in.sampleFormat() == QAudioFormat::Int16)
     {
-        m_stream->setDeviceFormat(m_device, format, m_msBuffer);
-        m_stream->restart(&m_buffer);
+        converted.resize(frames * inChannels);
+        AudioKernels::toFloat(reinterpret_cast<qint16 const *>(entry.data.constData()),
+                              converted.size(),
+                              converted.data());
     }
+
+    auto const sample = [&](qsizetype const frame,
+                            int       const channel)
+    {
+        if (!converted.empty()) return converted[frame * inChannels + channel];
+
+        return in.normalizedSampleValue(entry.data.constData() + frame   * bytesPerFrame
+                                                               + channel * bytesPerSamp);
+    };
+
+    // Channel mapping at the input rate.
+
+    std::vector<float> mapped(frames * outChannels);
+
+    for (qsizetype frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < outChannels; ++channel)
+        {
+            mapped[frame * outChannels + channel] =
+                (outChannels == 1 && inChannels > 1) ? (sample(frame, 0) + sample(frame, 1)) / 2.0f
+                                                     :  sample(frame, std::min(channel, inChannels - 1));
+        }
+    }
+
+    // Rate conversion.
+
+    auto const ratio     = static_cast<double>(in.sampleRate()) / m_format.sampleRate();
+    auto const outFrames = static_cast<qsizetype>((frames - 1) / ratio) + 1;
+    auto       sound     = QSharedPointer<QVector<float>>::create(outFrames * outChannels);
+
+    for (qsizetype frame = 0; frame < outFrames; ++frame)
+    {
+        auto const position = frame * ratio;
+        auto const f0       = std::min(static_cast<qsizetype>(position), frames - 1);
+        auto const f1       = std::min(f0 + 1, frames - 1);
+        auto const fraction = static_cast<float>(position - f0);
+
+        for (int channel = 0; channel < outChannels; ++channel)
+        {
+            auto const a = mapped[f0 * outChannels + channel];
+            auto const b = mapped[f1 * outChannels + channel];
+
+            (*sound)[frame * outChannels + channel] = a + (b - a) * fraction;
+        }
+    }
+
+    return sound;
 }
 
 /******************************************************************************/
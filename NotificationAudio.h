@@ -2,14 +2,22 @@
 #define NOTIFICATIONAUDIO_H
 
 #include <QAudioDevice>
-#include <QBuffer>
+#include <QAudioFormat>
 #include <QByteArray>
 #include <QHash>
-#include <QPair>
 #include <QScopedPointer>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include "NotificationMixer.hpp"
 
 class SoundOutput;
 
+// Plays notification sounds through a single output stream that's opened
+// once per device and left running. Sounds are decoded and converted to
+// the stream's format ahead of time, and any that overlap are mixed, so
+// triggering an alert costs no more than adding it to the mix.
+
 class NotificationAudio :
     public QObject
 {
@@ -23,21 +31,33 @@ public slots:
     void status(QString message);
     void error(QString message);
     void setDevice(const QAudioDevice &device, unsigned msBuffer=0);
+    void prepare(const QStringList &filePaths);
     void play(const QString &filePath);
     void stop();
 
 private:
 
-    using Entry = QPair<QAudioFormat, QByteArray>;
-    using Cache = QHash<QString,      Entry>;
+    using Sound = NotificationMixer::Sound;
+
+    struct Entry
+    {
+        QAudioFormat format;
+        QByteArray   data;
+        Sound        sound;
+    };
+
+    using Cache = QHash<QString, Entry>;
 
-    void playEntry(Cache::const_iterator);
+    Cache::iterator load(QString const &);
+    Sound           render(Entry const &) const;
+    void            report();
 
-    QScopedPointer<SoundOutput> m_stream;
-    Cache                       m_cache;
-    QAudioDevice                m_device;
-    QBuffer                     m_buffer;
-    unsigned                    m_msBuffer;
+    QScopedPointer<SoundOutput>       m_stream;
+    QScopedPointer<NotificationMixer> m_mixer;
+    Cache                             m_cache;
+    QAudioDevice                      m_device;
+    QAudioFormat                      m_format;
+    unsigned                          m_msBuffer;
 };
 
 #endif // NOTIFICATIONAUDIO_H
@@ -0,0 +1,185 @@
+#include "NotificationMixer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <QMutexLocker>
+#include "AudioKernels.hpp"
+
+/******************************************************************************/
+// Public Implementation
+/******************************************************************************/
+
+NotificationMixer::NotificationMixer()
+{
+    m_clock.start();
+
+    // Unbuffered, else QIODevice would read ahead in chunks much larger
+    // than the stream asks for, and a triggered sound would wait behind
+    // however much silence had been read ahead.
+
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void
+NotificationMixer::setFormat(QAudioFormat const & format)
+{
+    QMutexLocker lock(&m_mutex);
+
+    m_format = format;
+    m_voices.clear();
+}
+
+void
+NotificationMixer::add(Sound sound)
+{
+    QMutexLocker lock(&m_mutex);
+
+    m_voices.push_back({std::move(sound), 0, m_clock.nsecsElapsed()});
+}
+
+void
+NotificationMixer::clear()
+{
+    QMutexLocker lock(&m_mutex);
+
+    m_voices.clear();
+}
+
+NotificationMixer::Latency
+NotificationMixer::latency()
+{
+    QMutexLocker lock(&m_mutex);
+
+    return std::exchange(m_latency, {});
+}
+
+bool
+NotificationMixer::isSequential() const
+{
+    return true;
+}
+
+qint64
+NotificationMixer::bytesAvailable() const
+{
+    return std::numeric_limits<int>::max() + QIODevice::bytesAvailable();
+}
+
+/******************************************************************************/
+// Protected Implementation
+/******************************************************************************/
+
+qint64
+NotificationMixer::readData(char * const data,
+                            qint64 const maxlen)
+{
+    QMutexLocker lock(&m_mutex);
+
+    auto const bytesPerFrame = m_format.bytesPerFrame();
+
+    if (bytesPerFrame <= 0) return 0;
+
+    auto const frames  = maxlen / bytesPerFrame;
+    auto const samples = static_cast<std::size_t>(frames * m_format.channelCount());
+
+    m_mix.assign(samples, 0.0f);
+
+    for (auto & voice : m_voices)
+    {
+        auto const & sound = *voice.sound;
+        auto const   count = std::min(samples, static_cast<std::size_t>(sound.size() - voice.position));
+
+        // Time from trigger to the sound entering the output buffer; at most
+        // one buffer's worth of audio, already queued, lies ahead of it.
+
+        if (voice.position == 0)
+        {
+            auto const latency = m_clock.nsecsElapsed() - voice.triggered;
+
+            m_latency.count   += 1;
+            m_latency.totalNs += latency;
+            m_latency.maxNs    = std::max(m_latency.maxNs, latency);
+        }
+
+        std::transform(m_mix.begin(),
+                       m_mix.begin() + count,
+                       sound.begin() + voice.position,
+                       m_mix.begin(),
+                       std::plus<>{});
+
+        voice.position += count;
+    }
+
+    m_voices.erase(std::remove_if(m_voices.begin(),
+                                  m_voices.end(),
+                                  [](auto const & voice)
+                                  {
+                                      return voice.position >= voice.sound->size();
+                                  }),
+                   m_voices.end());
+
+    convert(data);
+
+    return frames * bytesPerFrame;
+}
+
+qint64
+NotificationMixer::writeData(char const *,
+                             qint64)
+{
+    return -1;
+}
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+// Convert the mix to the output sample format, clamping as we go;
+// overlapping sounds can sum beyond full scale.
+
+void
+NotificationMixer::convert(char * const data) const
+{
+    auto const clamp = [](float const value) { return std::clamp(value, -1.0f, 1.0f); };
+
+    switch (m_format.sampleFormat())
+    {
+        case QAudioFormat::Float:
+        {
+            auto out = reinterpret_cast<float *>(data);
+            std::transform(m_mix.begin(), m_mix.end(), out, clamp);
+            break;
+        }
+        case QAudioFormat::Int16:
+        {
+            AudioKernels::toInt16(m_mix.data(), m_mix.size(), reinterpret_cast<qint16 *>(data));
+            break;
+        }
+        case QAudioFormat::Int32:
+        {
+            auto out = reinterpret_cast<qint32 *>(data);
+            std::transform(m_mix.begin(), m_mix.end(), out, [&clamp](float const value)
+            {
+                return static_cast<qint32>(std::lround(clamp(value) * double(std::numeric_limits<qint32>::max())));
+            });
+            break;
+        }
+        case QAudioFormat::UInt8:
+        {
+            auto out = reinterpret_cast<quint8 *>(data);
+            std::transform(m_mix.begin(), m_mix.end(), out, [&clamp](float const value)
+            {
+                return static_cast<quint8>(std::lround(clamp(value) * 127.0f + 128.0f));
+            });
+            break;
+        }
+        default:
+            std::memset(data, 0, m_mix.size() * m_format.bytesPerSample());
+            break;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,80 @@
+#ifndef NOTIFICATION_MIXER_HPP__
+#define NOTIFICATION_MIXER_HPP__
+
+#include <vector>
+#include <QAudioFormat>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+// Endless source for the notification output stream; sums whatever sounds
+// are playing and pads with silence, so the stream never goes idle and
+// never needs to be restarted. Sounds are pre-rendered in the output format,
+// so all we need to do here is add, clamp, and convert to the output sample
+// format.
+//
+// The output stream pulls from this device on its own schedule, so voices
+// are protected by a mutex; contention is limited to the moment at which
+// a sound is triggered. Nothing done while reading allocates, blocks other
+// than on that mutex, or logs; the time from a sound being triggered to it
+// being mixed is accumulated for the owner to report from its own thread.
+
+class NotificationMixer final
+    : public QIODevice
+{
+public:
+
+    // Interleaved float samples in the output format.
+
+    using Sound = QSharedPointer<QVector<float> const>;
+
+    // Time from sounds being added to their first samples being handed to
+    // the output stream.
+
+    struct Latency
+    {
+        qint64 count   = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs   = 0;
+    };
+
+    NotificationMixer();
+
+    void setFormat(QAudioFormat const &);
+    void add(Sound);
+    void clear();
+
+    // Latency of the sounds mixed since the last call; resets the tally.
+
+    Latency latency();
+
+    bool   isSequential()   const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+
+    qint64 readData(char *, qint64)        override;
+    qint64 writeData(char const *, qint64) override;
+
+private:
+
+    struct Voice
+    {
+        Sound     sound;
+        qsizetype position;
+        qint64    triggered;
+    };
+
+    void convert(char *) const;
+
+    QMutex             m_mutex;
+    QAudioFormat       m_format;
+    QElapsedTimer      m_clock;
+    Latency            m_latency;
+    std::vector<Voice> m_voices;
+    std::vector<float> m_mix;
+};
+
+#endif
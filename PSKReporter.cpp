@@ -8,6 +8,7 @@
 // Reports will be sent in batch mode every 5 minutes.
 
 #include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <cstddef>
 #include <QByteArray>
@@ -285,6 +286,8 @@ public:
   unsigned                        send_descriptors_ = 0u;
   unsigned                        flush_counter_    = 0u;
   bool                            once_             = false;
+  std::atomic<qsizetype>          usage_count_      = 0;   // as of the last
+  std::atomic<qsizetype>          usage_bytes_      = 0;   // call to account()
   
   // Constructor
 
@@ -395,6 +398,7 @@ public:
 
       default:
         spots_.clear();
+        account();
         Q_EMIT self_->errorOccurred(socket_->errorString ());
         break;
     }
@@ -607,6 +611,34 @@ public:
       }
       qDebug() << "[PSK]remaining spots:" << spots_.size();
     }
+
+    account();
+  }
+
+  // Record the spots waiting to be sent, the call cache and the buffers in
+  // which datagrams are built, for the benefit of other threads asking.
+
+  void
+  account()
+  {
+    qsizetype bytes = MemoryAccounting::heap(payload_)
+                    + MemoryAccounting::heap(tx_data_)
+                    + MemoryAccounting::heap(tx_residue_);
+
+    for (auto const & spot : spots_)
+    {
+      bytes += sizeof(Spot) + MemoryAccounting::heap(spot.call_)
+                            + MemoryAccounting::heap(spot.grid_)
+                            + MemoryAccounting::heap(spot.mode_);
+    }
+
+    for (auto it = calls_.cbegin(); it != calls_.cend(); ++it)
+    {
+      bytes += sizeof(QString) + sizeof(std::time_t) + MemoryAccounting::HASH_NODE + MemoryAccounting::heap(it.key());
+    }
+
+    usage_count_ = spots_.size() + calls_.size();
+    usage_bytes_ = bytes;
   }
 
   bool
@@ -718,6 +750,8 @@ PSKReporter::addRemoteStation(QString           const & call,
     {
       return now - it.value() > (CACHE_TIMEOUT * 2);
     });
+
+    m_->account();
   }
 }
 
@@ -737,4 +771,10 @@ PSKReporter::sendReport(bool const last)
   }
 }
 
+MemoryAccounting::Usage
+PSKReporter::usage() const
+{
+  return {m_->usage_count_, m_->usage_bytes_};
+}
+
 /******************************************************************************/
@@ -2,6 +2,7 @@
 #define PSK_REPORTER_HPP_
 
 #include <QObject>
+#include "MemoryAccounting.hpp"
 #include "Radio.hpp"
 #include "pimpl_h.hpp"
 
@@ -38,6 +39,12 @@ public:
   //
   void sendReport(bool last = false);
 
+  //
+  // Spots queued and calls cached, as of the last change to either; safe to
+  // call from any thread
+  //
+  MemoryAccounting::Usage usage() const;
+
   Q_SIGNAL void errorOccurred (QString const& reason);
 
 private:
@@ -0,0 +1,254 @@
+#include "StartupTimeline.hpp"
+#include <algorithm>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaObject>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QThread>
+#include <QDebug>
+
+namespace
+{
+  QString
+  runnerName(StartupTimeline::Runner const runner)
+  {
+    return runner == StartupTimeline::Runner::GUI ? QStringLiteral("gui")
+                                                  : QStringLiteral("worker");
+  }
+}
+
+StartupTimeline::StartupTimeline(QElapsedTimer const & clock,
+                                 QObject             * parent)
+  : QObject(parent)
+  , m_timer(clock)
+{
+  if (!m_timer.isValid()) m_timer.start();
+
+  m_created = m_timer.elapsed();
+
+  if (m_created) mark("application", 0);
+}
+
+void
+StartupTimeline::add(QString                const & name,
+                     Runner                 const   runner,
+                     QStringList            const & depends,
+                     std::function<void()>          work)
+{
+  Q_ASSERT(!m_started);
+
+  m_stages.push_back({name, runner, depends, std::move(work)});
+}
+
+void
+StartupTimeline::mark(QString const & name,
+                      qint64  const   start)
+{
+  m_entries.push_back({name, Runner::GUI, start, m_timer.elapsed()});
+}
+
+void
+StartupTimeline::start()
+{
+  if (m_started) return;
+
+  m_started = true;
+
+  // Anything that depends on a stage we've never heard of would wait
+  // forever; warn about it and drop the dependency instead.
+
+  for (auto & stage : m_stages)
+  {
+    stage.depends.removeIf([this, &stage](QString const & name)
+    {
+      auto const known = std::any_of(m_stages.begin(),
+                                     m_stages.end(),
+                                     [&name](auto const & other) { return other.name == name; });
+      if (!known) qWarning() << "startup stage" << stage.name << "depends on unknown stage" << name;
+      return !known;
+    });
+  }
+
+  if (m_stages.empty())
+  {
+    emit done(m_timer.elapsed());
+    return;
+  }
+
+  dispatch();
+}
+
+bool
+StartupTimeline::ready(Stage const & stage) const
+{
+  return std::all_of(stage.depends.begin(),
+                     stage.depends.end(),
+                     [this](QString const & name)
+                     {
+                       return std::all_of(m_stages.begin(),
+                                          m_stages.end(),
+                                          [&name](auto const & other)
+                                          {
+                                            return other.name != name || other.complete;
+                                          });
+                     });
+}
+
+void
+StartupTimeline::dispatch()
+{
+  for (std::size_t index = 0; index < m_stages.size(); ++index)
+  {
+    auto & stage = m_stages[index];
+
+    if (stage.dispatched || !ready(stage)) continue;
+
+    stage.dispatched = true;
+
+    // GUI stages are posted rather than called directly, so that the
+    // event loop gets to paint and process input between stages.
+
+    if (stage.runner == Runner::Worker)
+    {
+      m_pool.start([this, index]() { run(index); });
+    }
+    else
+    {
+      QMetaObject::invokeMethod(this, [this, index]() { run(index); }, Qt::QueuedConnection);
+    }
+  }
+}
+
+void
+StartupTimeline::run(std::size_t const index)
+{
+  auto const start = m_timer.elapsed();
+
+  try
+  {
+    if (m_stages[index].work) m_stages[index].work();
+  }
+  catch (std::exception const & e)
+  {
+    qWarning() << "startup stage" << m_stages[index].name << "failed:" << e.what();
+  }
+
+  // Completion bookkeeping always happens on our own thread.
+
+  if (QThread::currentThread() == thread())
+  {
+    complete(index, start);
+  }
+  else
+  {
+    QMetaObject::invokeMethod(this, [this, index, start]() { complete(index, start); }, Qt::QueuedConnection);
+  }
+}
+
+void
+StartupTimeline::complete(std::size_t const index,
+                          qint64      const start)
+{
+  auto & stage = m_stages[index];
+
+  stage.complete = true;
+  m_entries.push_back({stage.name, stage.runner, start, m_timer.elapsed()});
+
+  emit progress(static_cast<int>(++m_completed),
+                static_cast<int>(m_stages.size()),
+                stage.name);
+
+  if (finished())
+  {
+    emit done(m_timer.elapsed());
+  }
+  else
+  {
+    dispatch();
+  }
+}
+
+QString
+StartupTimeline::toText() const
+{
+  auto entries = m_entries;
+
+  std::stable_sort(entries.begin(), entries.end(), [](auto const & a, auto const & b)
+  {
+    return a.start < b.start;
+  });
+
+  QString text;
+
+  text += QString("%1 %2 %3 %4\n").arg("Stage", -24).arg("Thread", -8).arg("Start", 8).arg("Duration", 10);
+
+  for (auto const & entry : entries)
+  {
+    text += QString("%1 %2 %3 %4\n").arg(entry.name, -24)
+                                    .arg(runnerName(entry.runner), -8)
+                                    .arg(QString("%1 ms").arg(entry.start), 8)
+                                    .arg(QString("%1 ms").arg(entry.finish - entry.start), 10);
+  }
+
+  if (finished())
+  {
+    auto const last = std::max_element(entries.begin(), entries.end(), [](auto const & a, auto const & b)
+    {
+      return a.finish < b.finish;
+    });
+
+    text += QString("\nStartup complete after %1 ms\n").arg(last != entries.end() ? last->finish : 0);
+  }
+  else
+  {
+    text += QString("\nStartup in progress, %1 of %2 stages complete\n").arg(m_completed).arg(m_stages.size());
+  }
+
+  return text;
+}
+
+QByteArray
+StartupTimeline::toJson() const
+{
+  QJsonArray stages;
+
+  for (auto const & entry : m_entries)
+  {
+    stages.append(QJsonObject
+    {
+      {"name",     entry.name},
+      {"thread",   runnerName(entry.runner)},
+      {"start",    entry.start},
+      {"finish",   entry.finish},
+      {"duration", entry.finish - entry.start}
+    });
+  }
+
+  return QJsonDocument(QJsonObject
+  {
+    {"cpu",      QSysInfo::currentCpuArchitecture()},
+    {"os",       QSysInfo::prettyProductName()},
+    {"threads",  QThread::idealThreadCount()},
+    {"complete", finished()},
+    {"stages",   stages}
+  }).toJson();
+}
+
+bool
+StartupTimeline::save(QString const & path) const
+{
+  QSaveFile file(path);
+
+  if (!file.open(QIODevice::WriteOnly)) return false;
+
+  file.write(toJson());
+
+  return file.commit();
+}
+
+/******************************************************************************/
+
+#include "moc_StartupTimeline.cpp"
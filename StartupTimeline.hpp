@@ -0,0 +1,111 @@
+#ifndef STARTUP_TIMELINE_HPP__
+#define STARTUP_TIMELINE_HPP__
+
+#include <functional>
+#include <vector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+// Dependency-ordered startup task graph. Stages are registered with the
+// names of the stages they depend on, and with the thread on which they
+// must run; once started, every stage whose dependencies are complete is
+// dispatched, worker stages to a private thread pool and GUI stages to
+// the event loop of the thread that owns the timeline, so independent
+// stages run in parallel while the main window is already visible.
+//
+// Each stage, along with any synchronous work measured via mark(), is
+// recorded in a timeline relative to the clock given at construction,
+// which main() starts at process start; everything up until construction
+// of this object, i.e., application setup, is recorded as the first entry.
+// The timeline can be rendered as text for display or exported as JSON
+// for tracking startup regressions across releases.
+
+class StartupTimeline final
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  enum class Runner
+  {
+    GUI,
+    Worker
+  };
+
+  struct Entry
+  {
+    QString name;
+    Runner  runner;
+    qint64  start;   // ms since the clock started
+    qint64  finish;  // ms since the clock started
+  };
+
+  // Constructor; the timeline runs on the clock given, or, if it's not
+  // been started, one that starts here.
+  explicit StartupTimeline(QElapsedTimer const & clock,
+                           QObject             * parent = nullptr);
+
+  // Register a stage; must be called before start().
+  void add(QString                const & name,
+           Runner                         runner,
+           QStringList            const & depends,
+           std::function<void()>          work);
+
+  // Record synchronous work that ran on the GUI thread from the given
+  // start time, as returned by elapsed(), up until now.
+  void mark(QString const & name,
+            qint64          start);
+
+  // Dispatch all stages that are ready to run; stages with unknown
+  // dependencies are run as if they had none.
+  void start();
+
+  qint64 elapsed()  const { return m_timer.elapsed(); }
+  qint64 created()  const { return m_created; }
+  bool   finished() const { return m_completed == m_stages.size(); }
+
+  std::vector<Entry> entries() const { return m_entries; }
+  QString            toText()  const;
+  QByteArray         toJson()  const;
+  bool               save(QString const & path) const;
+
+  Q_SIGNAL void progress(int completed, int total, QString const & stage);
+  Q_SIGNAL void done(qint64 elapsed);
+
+private:
+
+  struct Stage
+  {
+    QString               name;
+    Runner                runner;
+    QStringList           depends;
+    std::function<void()> work;
+    bool                  dispatched = false;
+    bool                  complete   = false;
+  };
+
+  bool ready(Stage const &) const;
+  void dispatch();
+  void run(std::size_t index);
+  void complete(std::size_t index,
+                qint64      start);
+
+  QElapsedTimer      m_timer;
+  qint64             m_created   = 0;   // ms since the clock started
+  std::vector<Stage> m_stages;
+  std::vector<Entry> m_entries;
+  std::size_t        m_completed = 0;
+  bool               m_started   = false;
+
+  // Declared last so that it's destroyed first, waiting for any worker
+  // stages still in flight before the rest of the timeline goes away.
+
+  QThreadPool        m_pool;
+};
+
+#endif
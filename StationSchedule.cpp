@@ -0,0 +1,214 @@
+#include "StationSchedule.hpp"
+#include <algorithm>
+#include <iterator>
+#include <QTimeZone>
+
+/******************************************************************************/
+// Local Utilities
+/******************************************************************************/
+
+namespace
+{
+  constexpr int DAY = 24 * 60 * 60 * 1000;
+
+  // Time of day in ms; comparisons are only ever made by time of day, so
+  // whatever date happens to be attached to the time is irrelevant.
+
+  int
+  msecs(QDateTime const & dateTime)
+  {
+    return dateTime.toUTC().time().msecsSinceStartOfDay();
+  }
+
+  // Half-open intervals [start, end) of the day covered by a station; the
+  // until time is inclusive, so the interval ends 1 ms past it. A window
+  // that wraps through midnight covers two intervals.
+
+  QList<QPair<int, int>>
+  intervals(StationList::Station const & station)
+  {
+    auto const at    = msecs(station.switch_at_);
+    auto const until = std::min(msecs(station.switch_until_) + 1, DAY);
+
+    if (at < until) return {{at, until}};
+
+    return {{at, DAY}, {0, until}};
+  }
+
+  bool
+  contains(QList<QPair<int, int>> const & intervals,
+           int                    const   ms)
+  {
+    return std::any_of(intervals.begin(), intervals.end(), [ms](auto const & interval)
+    {
+      return interval.first <= ms && ms < interval.second;
+    });
+  }
+
+  bool
+  overlaps(QList<QPair<int, int>> const & a,
+           QList<QPair<int, int>> const & b)
+  {
+    return std::any_of(a.begin(), a.end(), [&b](auto const & x)
+    {
+      return std::any_of(b.begin(), b.end(), [&x](auto const & y)
+      {
+        return x.first < y.second && y.first < x.second;
+      });
+    });
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+void
+StationSchedule::compile(StationList::Stations stations)
+{
+  m_stations = std::move(stations);
+  m_segments.clear();
+  m_conflicts.clear();
+
+  if (m_stations.isEmpty()) return;
+
+  // Order stations by (switch at, switch until) time of day; with windows
+  // that overlap, the last one in this order wins.
+
+  std::stable_sort(m_stations.begin(), m_stations.end(), [](auto const & a,
+                                                            auto const & b)
+  {
+    return std::make_pair(msecs(a.switch_at_), msecs(a.switch_until_)) <
+           std::make_pair(msecs(b.switch_at_), msecs(b.switch_until_));
+  });
+
+  QList<QList<QPair<int, int>>> covered;
+  std::vector<int>              bounds = {0};
+
+  for (auto const & station : m_stations)
+  {
+    covered.append(intervals(station));
+
+    for (auto const & [start, end] : covered.last())
+    {
+      bounds.push_back(start);
+      if (end < DAY) bounds.push_back(end);
+    }
+  }
+
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  // The station active over a segment is the last one covering its start;
+  // adjacent segments with the same station are coalesced. We always keep
+  // a segment starting at midnight so that lookups have a floor.
+
+  for (auto const start : bounds)
+  {
+    int station = -1;
+
+    for (int i = covered.size() - 1; i >= 0; --i)
+    {
+      if (contains(covered[i], start))
+      {
+        station = i;
+        break;
+      }
+    }
+
+    if (m_segments.empty() || m_segments.back().station != station)
+    {
+      m_segments.push_back({start, station});
+    }
+  }
+
+  // Overlapping windows are fine if they agree on frequency, e.g., an
+  // all-day window with a shorter one inside it; if they don't, one of
+  // them is going to be ignored for at least part of its window, which
+  // is probably not what was intended.
+
+  for (int i = 0; i < m_stations.size(); ++i)
+  {
+    for (int j = i + 1; j < m_stations.size(); ++j)
+    {
+      if (m_stations[i].frequency_ != m_stations[j].frequency_ &&
+          overlaps(covered[i], covered[j]))
+      {
+        m_conflicts.append({i, j});
+      }
+    }
+  }
+}
+
+std::vector<StationSchedule::Segment>::const_iterator
+StationSchedule::find(QDateTime const & at) const
+{
+  auto const ms = msecs(at);
+
+  return std::prev(std::upper_bound(m_segments.begin(),
+                                    m_segments.end(),
+                                    ms,
+                                    [](int const value, Segment const & segment)
+                                    {
+                                      return value < segment.start;
+                                    }));
+}
+
+std::optional<StationList::Station>
+StationSchedule::station(QDateTime const & at) const
+{
+  if (m_segments.empty()) return std::nullopt;
+
+  if (auto const it = find(at); it->station >= 0)
+  {
+    return m_stations[it->station];
+  }
+
+  return std::nullopt;
+}
+
+std::optional<QDateTime>
+StationSchedule::next(QDateTime const & at) const
+{
+  if (m_segments.empty()) return std::nullopt;
+
+  auto const midnight = QDateTime(at.toUTC().date(), QTime(0, 0), QTimeZone::utc());
+  auto const current  = find(at);
+  auto       it       = current;
+  qint64     offset   = 0;
+
+  // Walk forward, wrapping through midnight, until the active station
+  // changes; a segment that ends at midnight and continues into the one
+  // that starts at midnight isn't a transition.
+
+  for (std::size_t i = 0; i < m_segments.size(); ++i)
+  {
+    if (++it == m_segments.end())
+    {
+      it      = m_segments.begin();
+      offset += DAY;
+    }
+
+    if (it->station != current->station) return midnight.addMSecs(offset + it->start);
+  }
+
+  return std::nullopt;
+}
+
+int
+StationSchedule::segment(QDateTime const & at) const
+{
+  if (m_segments.empty()) return -1;
+
+  auto const index = static_cast<int>(std::distance(m_segments.begin(), find(at)));
+
+  // The last segment of the day may continue into the first.
+
+  if (index == static_cast<int>(m_segments.size()) - 1 &&
+      m_segments.back().station == m_segments.front().station)
+  {
+    return 0;
+  }
+
+  return index;
+}
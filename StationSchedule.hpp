@@ -0,0 +1,66 @@
+#ifndef STATION_SCHEDULE_HPP__
+#define STATION_SCHEDULE_HPP__
+
+#include <optional>
+#include <vector>
+#include <QDateTime>
+#include <QList>
+#include <QPair>
+#include "StationList.hpp"
+
+class StationSchedule
+{
+  // The station list describes daily windows, each from a switch at time
+  // through a switch until time, inclusive, wrapping through midnight if
+  // the until time is the earlier of the two. Where windows overlap, the
+  // one that sorts last by (switch at, switch until) wins.
+  //
+  // Rather than walk the whole of the list every period to figure out
+  // which station, if any, should be active, we compile it once, when the
+  // list changes, into a timeline of the transitions in a day; for each
+  // segment of the day between transitions, we know the station to be
+  // active. Finding the active station is then a binary search, and the
+  // caller need only look again when the next transition arrives.
+
+  struct Segment
+  {
+    int start;    // ms since midnight UTC, inclusive
+    int station;  // index of active station, or -1 if none
+  };
+
+  StationList::Stations      m_stations;
+  std::vector<Segment>       m_segments;
+  QList<QPair<int, int>>     m_conflicts;
+
+  std::vector<Segment>::const_iterator find(QDateTime const &) const;
+
+public:
+
+  // Compile a station list into a timeline.
+
+  void compile(StationList::Stations stations);
+
+  bool empty() const { return m_stations.isEmpty(); }
+
+  // Returns the station that should be active at the provided time, if
+  // any, and the time of the next transition after the provided time.
+  // If the schedule is empty, there are no transitions.
+
+  std::optional<StationList::Station> station(QDateTime const & at) const;
+  std::optional<QDateTime>            next   (QDateTime const & at) const;
+
+  // Returns the identity of the segment active at the provided time; this
+  // changes only at a transition, so it's suitable for determining if one
+  // has been crossed since the last time we looked.
+
+  int segment(QDateTime const & at) const;
+
+  // Pairs of stations, by index into the sorted list, whose windows
+  // overlap while specifying different frequencies; the second of each
+  // pair will be the one that wins.
+
+  StationList::Stations  const & stations()  const { return m_stations;  }
+  QList<QPair<int, int>> const & conflicts() const { return m_conflicts; }
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "StringPool.hpp"
+#include <algorithm>
+#include <utility>
+
+QString
+StringPool::intern(QString const & string)
+{
+  if (string.isEmpty()) return string;
+
+  if (auto const it = m_recent.constFind(string);
+                 it != m_recent.cend())
+  {
+    return *it;
+  }
+
+  auto pooled = string;
+
+  if (auto const it = m_older.constFind(string);
+                 it != m_older.cend())
+  {
+    pooled = *it;
+    m_older.erase(it);
+  }
+
+  if (m_recent.size() >= std::max(m_limit / 2, qsizetype {1}))
+  {
+    m_older = std::exchange(m_recent, {});
+  }
+
+  m_recent.insert(pooled);
+
+  return pooled;
+}
+
+MemoryAccounting::Usage
+StringPool::usage() const
+{
+  MemoryAccounting::Usage usage;
+
+  for (auto const & strings : {&m_recent, &m_older})
+  {
+    for (auto const & string : *strings)
+    {
+      usage.count += 1;
+      usage.bytes += MemoryAccounting::HASH_NODE + sizeof(QString) + MemoryAccounting::heap(string);
+    }
+  }
+
+  return usage;
+}
+
+/******************************************************************************/
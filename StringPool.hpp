@@ -0,0 +1,43 @@
+#ifndef STRING_POOL_HPP__
+#define STRING_POOL_HPP__
+
+#include <QSet>
+#include <QString>
+#include "MemoryAccounting.hpp"
+
+// Pool of the strings that recur from one decode to the next; callsigns,
+// grids, commands and the like. Interning a string returns the pooled copy
+// of it, so that every record referring to, say, a given callsign shares
+// a single copy of its data, rather than each decode holding its own.
+//
+// Strings handed out are ordinary implicitly shared strings; the pool can
+// be cleared at any time without affecting them. It's bounded by aging its
+// strings out, a generation at a time: those interned recently, and those
+// interned before that. A string interned again from the older generation
+// moves to the recent one, still the same copy; once the recent one holds
+// half the limit, it becomes the older, and whatever's in the older one
+// then, not having been interned for a whole generation, is dropped. Calls
+// still being heard stay shared, and only those that have gone quiet go.
+
+class StringPool final
+{
+public:
+
+  explicit StringPool(qsizetype limit = 16384)
+    : m_limit {limit}
+  {}
+
+  QString intern(QString const &);
+
+  void clear() { m_recent.clear(); m_older.clear(); }
+
+  MemoryAccounting::Usage usage() const;
+
+private:
+
+  qsizetype     m_limit;
+  QSet<QString> m_recent;
+  QSet<QString> m_older;
+};
+
+#endif
@@ -1,6 +1,16 @@
 #include "TraceFile.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <QDebug>
 #include <QString>
@@ -8,20 +18,152 @@
 #include <QTextStream>
 #include <QMessageLogContext>
 #include <QDateTime>
-#include <QMutex>
-#include <QMutexLocker>
+#include <QThread>
+#include <QTimeZone>
 
 #include "pimpl_impl.hpp"
 
 namespace
 {
-  QMutex lock;
+  using Clock = std::chrono::steady_clock;
+
+  // number of messages retained in flight recorder mode
+  std::size_t constexpr flight_recorder_depth {4096};
+
+  // how often the writer drains the thread buffers when not woken early
+  auto constexpr drain_interval = std::chrono::milliseconds {50};
+
+  // A captured message; formatting is left to the writer thread. The
+  // context file name comes from __FILE__ and so has static storage.
+  struct Record
+  {
+    quint64 sequence;
+    qint64 utc;                 // ms since epoch
+    qint64 monotonic;           // ns since the trace clock started
+    qint64 delta;               // ns since last message on this thread
+    quintptr thread;
+    QtMsgType type;
+    char const * file;
+    int line;
+    QString message;
+  };
+
+  // Single producer, single consumer ring of records; the producer is
+  // the owning thread, the consumer is whichever thread is draining,
+  // serialized by the drain mutex. If the ring is full, the record is
+  // counted and dropped rather than making the producer wait.
+  class Buffer
+  {
+  public:
+    static std::size_t constexpr capacity {1024};
+
+    explicit Buffer (quintptr thread)
+      : thread_ {thread}
+    {
+    }
+
+    bool push (Record&& record)
+    {
+      auto const head = head_.load (std::memory_order_relaxed);
+      if (head - tail_.load (std::memory_order_acquire) == capacity)
+        {
+          dropped_.fetch_add (1, std::memory_order_relaxed);
+          return false;
+        }
+      records_[head % capacity] = std::move (record);
+      head_.store (head + 1, std::memory_order_release);
+      return true;
+    }
+
+    template<typename Sink>
+    void drain (Sink&& sink)
+    {
+      auto tail = tail_.load (std::memory_order_relaxed);
+      auto const head = head_.load (std::memory_order_acquire);
+      for (; tail != head; ++tail)
+        {
+          sink (std::move (records_[tail % capacity]));
+        }
+      tail_.store (tail, std::memory_order_release);
+    }
+
+    std::size_t take_dropped () {return dropped_.exchange (0, std::memory_order_relaxed);}
+    bool empty () const {return head_.load (std::memory_order_acquire) == tail_.load (std::memory_order_acquire);}
+    void close () {closed_.store (true, std::memory_order_release);}
+    bool closed () const {return closed_.load (std::memory_order_acquire);}
+
+    quintptr thread () const {return thread_;}
+    qint64 last {-1};           // producer only
+
+  private:
+    quintptr thread_;
+    std::array<Record, capacity> records_;
+    std::atomic<std::size_t> head_ {0};
+    std::atomic<std::size_t> tail_ {0};
+    std::atomic<std::size_t> dropped_ {0};
+    std::atomic<bool> closed_ {false};
+  };
+
+  // Registry of per-thread buffers; the mutex is taken only when a thread
+  // logs for the first time and when draining, never on the message path.
+  // Deliberately leaked so that it outlives any thread that logs during
+  // static destruction.
+  struct Registry
+  {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    std::atomic<quint64> sequence {0};
+    Clock::time_point const epoch {Clock::now ()};
+  };
+
+  Registry& registry ()
+  {
+    static auto * registry = new Registry;
+    return *registry;
+  }
+
+  // A thread's buffer, registered on first use and marked closed when the
+  // thread exits, whereupon the writer will discard it once drained.
+  struct Handle
+  {
+    Handle ()
+      : buffer {std::make_shared<Buffer> (reinterpret_cast<quintptr> (QThread::currentThreadId ()))}
+    {
+      auto& r = registry ();
+      std::lock_guard<std::mutex> lock {r.mutex};
+      r.buffers.push_back (buffer);
+    }
+
+    ~Handle ()
+    {
+      buffer->close ();
+    }
+
+    std::shared_ptr<Buffer> buffer;
+  };
+
+  char const * severity (QtMsgType type)
+  {
+    switch (type)
+      {
+      case QtDebugMsg: return "Debug";
+      case QtInfoMsg: return "Info";
+      case QtWarningMsg: return "Warning";
+      case QtFatalMsg: return "Fatal";
+      default: return "Critical";
+      }
+  }
+
+  bool is_error (QtMsgType type)
+  {
+    return QtDebugMsg != type && QtInfoMsg != type;
+  }
 }
 
 class TraceFile::impl
 {
 public:
-  impl (QString const& trace_file_path);
+  impl (QString const& trace_file_path, bool flight_recorder);
   ~impl ();
 
   // no copying
@@ -32,19 +174,37 @@ private:
   // write Qt messages to the diagnostic log file
   static void message_handler (QtMsgType type, QMessageLogContext const& context, QString const& msg);
 
+  // drain all thread buffers to the current trace file
+  static void drain ();
+
+  void run ();
+  void write (Record const&);
+  void consume (std::vector<Record>&);
+
   QFile file_;
   QTextStream stream_;
-  QTextStream * original_stream_;
+  bool flight_recorder_;
+  std::deque<Record> recorder_;
+  impl * original_impl_;
   QtMessageHandler original_handler_;
-  static QTextStream * current_stream_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  bool wake_pending_ {false};
+  bool stop_ {false};
+  std::thread writer_;
+
+  static std::atomic<impl *> current_;
+  static std::mutex drain_mutex_;
 };
 
-QTextStream * TraceFile::impl::current_stream_;
+std::atomic<TraceFile::impl *> TraceFile::impl::current_ {nullptr};
+std::mutex TraceFile::impl::drain_mutex_;
 
 
 // delegate to implementation class
-TraceFile::TraceFile (QString const& trace_file_path)
-  : m_ {trace_file_path}
+TraceFile::TraceFile (QString const& trace_file_path, bool flight_recorder)
+  : m_ {trace_file_path, flight_recorder}
 {
 }
 
@@ -53,9 +213,10 @@ TraceFile::~TraceFile ()
 }
 
 
-TraceFile::impl::impl (QString const& trace_file_path)
+TraceFile::impl::impl (QString const& trace_file_path, bool flight_recorder)
   : file_ {trace_file_path}
-  , original_stream_ {current_stream_}
+  , flight_recorder_ {flight_recorder}
+  , original_impl_ {current_.load ()}
   , original_handler_ {nullptr}
 {
   // if the log file is writeable; initialise diagnostic logging to it
@@ -63,7 +224,8 @@ TraceFile::impl::impl (QString const& trace_file_path)
   if (file_.open (QFile::WriteOnly | QFile::Append | QFile::Text))
     {
       stream_.setDevice (&file_);
-      current_stream_ = &stream_;
+      writer_ = std::thread {&impl::run, this};
+      current_ = this;
       original_handler_ = qInstallMessageHandler (message_handler);
     }
 }
@@ -75,44 +237,162 @@ TraceFile::impl::~impl ()
     {
       qInstallMessageHandler (original_handler_);
     }
-  current_stream_ = original_stream_; // revert to prior stream
-}
 
-// write Qt messages to the diagnostic log file
-void TraceFile::impl::message_handler (QtMsgType type, QMessageLogContext const& context, QString const& msg)
-{
-  char const * severity;
-  switch (type)
+  if (writer_.joinable ())
     {
-    case QtDebugMsg:
-      severity = "Debug";
-      break;
+      {
+        std::lock_guard<std::mutex> lock {wake_mutex_};
+        stop_ = true;
+      }
+      wake_.notify_one ();
+      writer_.join ();
 
-    case QtWarningMsg:
-      severity = "Warning";
-      break;
+      // anything still queued belongs to us
+      drain ();
 
-    case QtFatalMsg:
-      severity = "Fatal";
-      break;
+      std::lock_guard<std::mutex> guard {drain_mutex_};
+      current_ = original_impl_; // revert to prior trace file
+    }
+}
 
-    default:
-      severity = "Critical";
-      break;
+void TraceFile::impl::run ()
+{
+  std::unique_lock<std::mutex> lock {wake_mutex_};
+  while (!stop_)
+    {
+      wake_.wait_for (lock, drain_interval, [this] {return stop_ || wake_pending_;});
+      wake_pending_ = false;
+      lock.unlock ();
+      drain ();
+      lock.lock ();
     }
+}
+
+void TraceFile::impl::drain ()
+{
+  std::lock_guard<std::mutex> guard {drain_mutex_};
 
+  auto * self = current_.load ();
+  if (!self) return;
+
+  std::vector<Record> batch;
+  std::vector<std::pair<quintptr, std::size_t>> dropped;
   {
-    // guard against multiple threads with overlapping messages
-    QMutexLocker guard (&lock);
-    Q_ASSERT_X (current_stream_, "TraceFile:message_handler", "no stream to write to");
-    *current_stream_
-      << QDateTime::currentDateTimeUtc ().toString ("yyyy-MM-ddTHH:mm:ss.zzzZ")
-      << '(' << context.file << ':' << context.line /* << ", " << context.function */ << ')'
-      << severity << ": " << msg.trimmed () << Qt::endl;
+    auto& r = registry ();
+    std::lock_guard<std::mutex> lock {r.mutex};
+    for (auto const& buffer : r.buffers)
+      {
+        buffer->drain ([&batch] (Record&& record) {batch.push_back (std::move (record));});
+        if (auto const count = buffer->take_dropped ())
+          {
+            dropped.emplace_back (buffer->thread (), count);
+          }
+      }
+
+    // forget threads that have exited and been fully drained
+    r.buffers.erase (std::remove_if (r.buffers.begin (), r.buffers.end (), [] (auto const& buffer) {
+          return buffer->closed () && buffer->empty ();
+        }), r.buffers.end ());
   }
 
+  // merge threads back into the order in which messages were logged
+  std::sort (batch.begin (), batch.end (), [] (Record const& a, Record const& b) {
+      return a.sequence < b.sequence;
+    });
+
+  for (auto const& [thread, count] : dropped)
+    {
+      self->stream_ << QDateTime::currentDateTimeUtc ().toString ("yyyy-MM-ddTHH:mm:ss.zzzZ")
+                    << " Warning: " << count << " trace messages dropped from thread 0x"
+                    << QString::number (thread, 16) << Qt::endl;
+    }
+
+  self->consume (batch);
+  self->stream_.flush ();
+}
+
+void TraceFile::impl::consume (std::vector<Record>& batch)
+{
+  for (auto& record : batch)
+    {
+      if (!flight_recorder_)
+        {
+          write (record);
+          continue;
+        }
+
+      // flight recorder mode; keep the most recent messages, and dump them
+      // all, oldest first, when something goes wrong
+      auto const error = is_error (record.type);
+      recorder_.push_back (std::move (record));
+      if (recorder_.size () > flight_recorder_depth)
+        {
+          recorder_.pop_front ();
+        }
+      if (error)
+        {
+          stream_ << "---------------------------- Flight recorder ("
+                  << recorder_.size () << " messages) ----------------------------" << Qt::endl;
+          for (auto const& retained : recorder_)
+            {
+              write (retained);
+            }
+          recorder_.clear ();
+        }
+    }
+}
+
+void TraceFile::impl::write (Record const& record)
+{
+  // seconds on the monotonic clock, then ms since the previous message
+  // from the same thread, which is what's wanted for CAT timing
+  stream_
+    << QDateTime::fromMSecsSinceEpoch (record.utc, QTimeZone::utc ()).toString ("yyyy-MM-ddTHH:mm:ss.zzzZ")
+    << " [" << QString::number (record.monotonic / 1e9, 'f', 6)
+    << (record.delta < 0 ? QString {" +-"} : " +" + QString::number (record.delta / 1e6, 'f', 3))
+    << "ms 0x" << QString::number (record.thread, 16) << ']'
+    << '(' << record.file << ':' << record.line << ')'
+    << severity (record.type) << ": " << record.message.trimmed () << Qt::endl;
+}
+
+// queue Qt messages for the diagnostic log file
+void TraceFile::impl::message_handler (QtMsgType type, QMessageLogContext const& context, QString const& msg)
+{
+  thread_local Handle handle;
+
+  auto& r = registry ();
+  auto& buffer = *handle.buffer;
+  auto const monotonic = std::chrono::duration_cast<std::chrono::nanoseconds> (Clock::now () - r.epoch).count ();
+
+  buffer.push ({r.sequence.fetch_add (1, std::memory_order_relaxed),
+        QDateTime::currentMSecsSinceEpoch (),
+        monotonic,
+        buffer.last < 0 ? -1 : monotonic - buffer.last,
+        buffer.thread (),
+        type,
+        context.file ? context.file : "",
+        context.line,
+        msg});
+  buffer.last = monotonic;
+
   if (QtFatalMsg == type)
     {
+      // we're about to go down; get everything onto the disk first
+      drain ();
       throw std::runtime_error {"Fatal Qt Error"};
     }
+
+  if (is_error (type))
+    {
+      // errors are written promptly, or in flight recorder mode trigger a
+      // dump; wake the writer rather than waiting for the next interval
+      if (auto * self = current_.load ())
+        {
+          {
+            std::lock_guard<std::mutex> lock {self->wake_mutex_};
+            self->wake_pending_ = true;
+          }
+          self->wake_.notify_one ();
+        }
+    }
 }
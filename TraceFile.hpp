@@ -5,10 +5,24 @@
 
 class QString;
 
+//
+// Class TraceFile
+//
+//  Redirects Qt  messages to a file  for the lifetime of  the object.
+//  Messages are queued to a per-thread lock-free buffer and written by
+//  a background thread, so that logging from  time critical threads,
+//  e.g. CAT  traffic, doesn't wait  on the disk.  Each line carries a
+//  UTC  timestamp,  a monotonic timestamp  and the time elapsed since
+//  the previous message from the same thread.
+//
+//  In flight recorder mode only the most recent messages are retained,
+//  in memory,  and they're written  to the file  only when a warning,
+//  critical or fatal message is logged.
+//
 class TraceFile final
 {
 public:
-  explicit TraceFile (QString const& TraceFile_file_path);
+  explicit TraceFile (QString const& TraceFile_file_path, bool flight_recorder = false);
   ~TraceFile ();
 
   // copying not allowed
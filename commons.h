@@ -19,6 +19,15 @@
 #define JS8_DECODE_THREAD  1       // use a separate thread for decode process handling
 #define JS8_ALLOW_EXTENDED 1       // allow extended latin-1 capital charset
 #define JS8_AUTO_SYNC      1       // enable the experimental auto sync feature
+#define JS8_ENERGY_GATE    0       // restrict the sync search to occupied sub-bands; off, as it loses decodes on a busy band
+#define JS8_GATE_RECALL    0       // also run a full sync search, reporting energy gate recall
+#define JS8_SYNC_PRUNE     1       // skip fine sync offsets that can't better the best found
+#define JS8_BP_EARLY_ABORT 1       // abandon belief propagation attempts that aren't converging, and triage erasure passes
+#define JS8_BP_RECALL      0       // run BP attempts to completion, reporting iterations and decodes lost to early abort
+#define JS8_OSD_DEPTH      0       // ordered statistics fallback decoding depth; 0 (off), 1, or 2
+#define JS8_OSD_BUDGET     50      // per-cycle ordered statistics decoding time budget, in ms
+#define JS8_AP_DECODE      1       // try a priori hints for stations we're working near their offsets
+#define JS8_AP_MAX_HINTS   8       // most a priori hints provided per decode
 
 #ifdef QT_DEBUG
 #define JS8_DEBUG_DECODE   0       // emit debug statements for the decode pipeline
@@ -56,7 +65,7 @@
 extern struct dec_data
 {
   std::int16_t d2[JS8_RX_SAMPLE_SIZE]; // sample frame buffer for sample collection
-  struct
+  struct dec_params
   {
     int nutc;                   // UTC as integer. See code_time() below for details.
     int nfqso;                  // User-selected QSO freq (kHz)
@@ -64,6 +73,13 @@ extern struct dec_data
     int nfa;                    // Low decode limit (Hz) (filter min)
     int nfb;                    // High decode limit (Hz) (filter max)
     bool syncStats;              // only compute sync candidates
+    bool energyGate;            // restrict sync search to occupied sub-bands
+    bool gateRecall;            // measure energy gate recall against a full search
+    bool syncPrune;             // prune the fine sync timing search
+    bool bpEarlyAbort;          // abandon BP attempts that aren't converging
+    bool bpRecall;              // measure BP iterations and early abort losses
+    int osdDepth;               // ordered statistics fallback decoding depth
+    int osdBudget;              // per-cycle ordered statistics decoding budget (ms)
     int kin;                    // number of frames written to d2
     int kposA;                  // starting position of decode for submode A
     int kposB;                  // starting position of decode for submode B
@@ -76,6 +92,14 @@ extern struct dec_data
     int kszE;                   // number of frames for decode for submode E
     int kszI;                   // number of frames for decode for submode I
     int nsubmodes;              // which submodes to decode
+    int nhints;                 // number of a priori hints provided
+    struct dec_hint
+    {
+      int submode;              // submode in which it's expected
+      int freq;                 // offset (Hz) at which it's expected
+      std::uint64_t mask;       // known bits among the first 64 message bits, msb first
+      std::uint64_t bits;       // and their expected values
+    } hints[JS8_AP_MAX_HINTS];  // messages we're expecting, in part
   } params;
 } dec_data;
 
@@ -193,6 +193,17 @@ quint32 JSC::lookup(QString w, bool * ok){
     return result;
 }
 
+MemoryAccounting::Usage JSC::lookupCacheUsage(){
+    MemoryAccounting::Usage usage;
+
+    for(auto it = LOOKUP_CACHE.constBegin(); it != LOOKUP_CACHE.constEnd(); ++it){
+        usage.count++;
+        usage.bytes += MemoryAccounting::MAP_NODE + sizeof(QString) + sizeof(quint32) + MemoryAccounting::heap(it.key());
+    }
+
+    return usage;
+}
+
 quint32 JSC::lookup(char const* b, bool *ok){
     quint32 index = 0;
     quint32 count = 0;
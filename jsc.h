@@ -12,6 +12,8 @@
 #include <QPair>
 #include <QVector>
 
+#include "MemoryAccounting.hpp"
+
 typedef QPair<QVector<bool>, quint32> CodewordPair;        // Tuple(Codeword, N) where N = number of characters
 typedef QVector<bool> Codeword;                        // Codeword bit vector
 
@@ -36,6 +38,9 @@ public:
     static quint32 lookup(QString w, bool *ok);
     static quint32 lookup(char const* b, bool *ok);
 
+    // words looked up so far, and what they're holding on to
+    static MemoryAccounting::Usage lookupCacheUsage();
+
     static const quint32 size = 262144;
     static const Tuple map[262144];
     static const Tuple list[262144];
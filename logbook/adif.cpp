@@ -1,6 +1,9 @@
 #include "adif.h"
 
+#include <QDataStream>
 #include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QDateTime>
 #include <QDebug>
@@ -172,6 +175,8 @@ void ADIF::init(QString const& filename)
 {
     _filename = filename;
     _data.clear();
+    _snapshotStamp = {};
+    _loadStamp = {};
 }
 
 
@@ -212,6 +217,7 @@ QString ADIF::extractField(QString const& record, QString const& fieldName) cons
 void ADIF::load()
 {
     _data.clear();
+    _loadStamp = stamp();
     QFile inputFile(_filename);
     if (inputFile.open(QIODevice::ReadOnly))
     {
@@ -329,73 +335,329 @@ qsizetype ADIF::getCount() const
 {
     return _data.size();
 }   
-    
+
+namespace
+{
+  // Snapshot header; a magic number and version, then the stamp of the log
+  // it reflects, at a fixed offset so it can be rewritten in place. QSOs
+  // follow, each as its fields in UTF-8, until the end of the file.
+
+  constexpr quint32 SNAPSHOT_MAGIC   = 0x4a53384c;   // "JS8L"
+  constexpr quint32 SNAPSHOT_VERSION = 1;
+  constexpr qint64  SNAPSHOT_STAMP   = 2 * sizeof(quint32);
+
+  // What addQSOToFile() writes around the record; the header only to a
+  // new file.
+
+  constexpr char ADIF_HEADER[]  = "JS8Call ADIF Export<eoh>\n";
+  constexpr char ADIF_TRAILER[] = " <eor>\n";
+
+  // Bytes that writing these to the log in text mode adds to it; newlines
+  // become CR LF on Windows.
+
+  qint64 fileBytes(QByteArray const& bytes)
+  {
+#if defined(Q_OS_WIN)
+    return bytes.size() + bytes.count('\n');
+#else
+    return bytes.size();
+#endif
+  }
+
+  QDataStream & operator<<(QDataStream & out, ADIF::QSO const& q)
+  {
+    return out << q.call.toUtf8()
+               << q.band.toUtf8()
+               << q.mode.toUtf8()
+               << q.submode.toUtf8()
+               << q.grid.toUtf8()
+               << q.date.toUtf8()
+               << q.name.toUtf8()
+               << q.comment.toUtf8();
+  }
+
+  QDataStream & operator>>(QDataStream & in, ADIF::QSO & q)
+  {
+    for (auto field : {&q.call, &q.band, &q.mode, &q.submode, &q.grid, &q.date, &q.name, &q.comment})
+    {
+      QByteArray utf8;
+      in >> utf8;
+      *field = QString::fromUtf8(utf8);
+    }
+    return in;
+  }
+}
+
+ADIF::Stamp ADIF::stamp() const
+{
+    QFileInfo const info(_filename);
+
+    if (!info.exists()) return {0, 0};    // as good as empty
+
+    return {info.size(), info.lastModified().toMSecsSinceEpoch()};
+}
+
+QString ADIF::snapshotFilename() const
+{
+    return _filename + ".snapshot";
+}
+
+// replace what we have with the snapshot, if it reflects the log as it is
+// now; return true if it did
+bool ADIF::loadSnapshot()
+{
+    _data.clear();
+    _snapshotStamp = {};
+
+    QFile file(snapshotFilename());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic   = 0;
+    quint32 version = 0;
+    Stamp   was;
+
+    in >> magic >> version >> was.size >> was.modified;
+
+    if (in.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION
+        || was.size < 0 || was != stamp())
+        return false;
+
+    while (!in.atEnd())
+    {
+        QSO q;
+        in >> q;
+
+        if (in.status() != QDataStream::Ok)
+        {
+            _data.clear();
+            return false;
+        }
+
+        if (q.call.size ())
+            _data.insert(q.call, q);
+    }
+
+    _snapshotStamp = was;
+    return true;
+}
+
+// write the snapshot afresh from what load() read; return true on success.
+// It's stamped with the log as it was before load() read it, not as it is
+// now; a record appended in between may or may not have been read, so the
+// snapshot mustn't match the log with it. If it wasn't read, and was ours,
+// addToSnapshot() can still add it, as the log will have grown by just that
+bool ADIF::saveSnapshot()
+{
+    auto const loaded = _loadStamp;
+
+    QSaveFile file(snapshotFilename());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << loaded.size << loaded.modified;
+    for (auto const& q : _data) out << q;
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+    {
+        qDebug() << "ADIF unable to save snapshot:" << file.errorString();
+        return false;
+    }
+
+    _snapshotStamp = loaded;
+    return true;
+}
+
+// append a QSO that's just been added to the log, and restamp; the snapshot
+// is left alone unless it's the one we last read or wrote, i.e., unless it
+// was current up until this QSO was logged. The log must have grown by the
+// record and nothing else; if anything else has been written to it since,
+// the snapshot is no longer ours to keep current, and is left to be
+// rewritten by the next full parse, which it no longer matches
+bool ADIF::addToSnapshot(QSO const& qso, QByteArray const& record)
+{
+    if (_snapshotStamp.size < 0)
+        return false;
+
+    QFile file(snapshotFilename());
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic   = 0;
+    quint32 version = 0;
+    Stamp   was;
+
+    stream >> magic >> version >> was.size >> was.modified;
+
+    if (stream.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION
+        || was != _snapshotStamp)
+        return false;
+
+    auto const now   = stamp();
+    auto const grown = (was.size ? 0 : fileBytes(ADIF_HEADER))
+                     + fileBytes(record)
+                     + fileBytes(ADIF_TRAILER);
+
+    if (now.size != was.size + grown)
+    {
+        _snapshotStamp = {};
+        return false;
+    }
+
+    file.seek(file.size());
+    stream << qso;
+
+    file.seek(SNAPSHOT_STAMP);
+    stream << now.size << now.modified;
+
+    if (stream.status() != QDataStream::Ok || !file.flush())
+    {
+        _snapshotStamp = {};
+        return false;
+    }
+
+    _snapshotStamp = now;
+    return true;
+}
+
+namespace
+{
+  // Append a non-negative number, zero padded to at least the width given.
+  void appendNumber(QByteArray & out, qsizetype value, int width = 0)
+  {
+    char digits[20];
+    int  count = 0;
+
+    do
+    {
+      digits[count++] = char('0' + value % 10);
+      value /= 10;
+    }
+    while (value && count < int(sizeof digits));
+
+    while (count < width && count < int(sizeof digits)) digits[count++] = '0';
+    while (count) out += digits[--count];
+  }
+
+  // Append as Latin-1, as QString::toLatin1() would, without the temporary.
+  void appendLatin1(QByteArray & out, QStringView text)
+  {
+    auto const at = out.size();
+
+    out.resize(at + text.size());
+
+    auto data = out.data() + at;
+    for (auto const c : text) *data++ = c.unicode() < 0x100 ? char(c.unicode()) : '?';
+  }
+}
+
+void ADIF::appendField(QStringView name, QStringView value)
+{
+  if (!_record.isEmpty()) _record += ' ';
+  _record += '<';
+  appendLatin1(_record, name);
+  _record += ':';
+  appendNumber(_record, value.size());
+  _record += '>';
+  appendLatin1(_record, value);
+}
+
+void ADIF::appendField(QStringView name, QDate const& date)
+{
+  if (!_record.isEmpty()) _record += ' ';
+  _record += '<';
+  appendLatin1(_record, name);
+  _record += ":8>";
+  appendNumber(_record, date.year(), 4);
+  appendNumber(_record, date.month(), 2);
+  appendNumber(_record, date.day(), 2);
+}
+
+void ADIF::appendField(QStringView name, QTime const& time)
+{
+  if (!_record.isEmpty()) _record += ' ';
+  _record += '<';
+  appendLatin1(_record, name);
+  _record += ":6>";
+  appendNumber(_record, time.hour(), 2);
+  appendNumber(_record, time.minute(), 2);
+  appendNumber(_record, time.second(), 2);
+}
+
 QByteArray ADIF::QSOToADIF(QString const& hisCall, QString const& hisGrid, QString const& mode, QString const& submode
                            , QString const& rptSent, QString const& rptRcvd, QDateTime const& dateTimeOn
                            , QDateTime const& dateTimeOff, QString const& band, QString const& comments
                            , QString const& name, QString const& strDialFreq, QString const& m_myCall
                            , QString const& m_myGrid, QString const& operator_call, QMap<QString, QVariant> const &additionalFields)
 {
-  QString t;
-  t = "<call:" + QString::number(hisCall.length()) + ">" + hisCall;
-  t += " <gridsquare:" + QString::number(hisGrid.length()) + ">" + hisGrid;
-  t += " <mode:" + QString::number(mode.length()) + ">" + mode;
+  // keeps its capacity, so only the first record or two need allocate
+  _record.resize(0);
+
+  appendField(u"call", hisCall);
+  appendField(u"gridsquare", hisGrid);
+  appendField(u"mode", mode);
   if(!submode.isEmpty()){
-    t += " <submode:" + QString::number(submode.length()) + ">" + submode;
+    appendField(u"submode", submode);
   }
-  t += " <rst_sent:" + QString::number(rptSent.length()) + ">" + rptSent;
-  t += " <rst_rcvd:" + QString::number(rptRcvd.length()) + ">" + rptRcvd;
-  t += " <qso_date:8>" + dateTimeOn.date().toString("yyyyMMdd");
-  t += " <time_on:6>" + dateTimeOn.time().toString("hhmmss");
-  t += " <qso_date_off:8>" + dateTimeOff.date().toString("yyyyMMdd");
-  t += " <time_off:6>" + dateTimeOff.time().toString("hhmmss");
-  t += " <band:" + QString::number(band.length()) + ">" + band;
-  t += " <freq:" + QString::number(strDialFreq.length()) + ">" + strDialFreq;
-  t += " <station_callsign:" + QString::number(m_myCall.length()) + ">" +
-      m_myCall;
-  t += " <my_gridsquare:" + QString::number(m_myGrid.length()) + ">" +
-      m_myGrid;
-  if (comments != "")
-    t += " <comment:" + QString::number(comments.length()) +
-        ">" + comments;
-  if (name != "")
-    t += " <name:" + QString::number(name.length()) +
-        ">" + name;
-  if (operator_call!="")
-      t+=" <operator:" + QString::number(operator_call.length()) +
-              ">" + operator_call;
-
-  foreach(auto key, additionalFields.keys()){
+  appendField(u"rst_sent", rptSent);
+  appendField(u"rst_rcvd", rptRcvd);
+  appendField(u"qso_date", dateTimeOn.date());
+  appendField(u"time_on", dateTimeOn.time());
+  appendField(u"qso_date_off", dateTimeOff.date());
+  appendField(u"time_off", dateTimeOff.time());
+  appendField(u"band", band);
+  appendField(u"freq", strDialFreq);
+  appendField(u"station_callsign", m_myCall);
+  appendField(u"my_gridsquare", m_myGrid);
+  if (!comments.isEmpty())
+    appendField(u"comment", comments);
+  if (!name.isEmpty())
+    appendField(u"name", name);
+  if (!operator_call.isEmpty())
+    appendField(u"operator", operator_call);
+
+  for (auto const [key, value] : additionalFields.asKeyValueRange()){
       auto k = key.toUpper();
-      auto value = additionalFields[k].toString();
 
       if(ADIF_FIELDS.contains(k)){
-        t += QString(" <%1:%2>%3").arg(k).arg(value.length()).arg(value);
+        appendField(k, value.toString());
       } else {
-        t += QString(" <APP_JS8CALL_%1:%2>%3").arg(k).arg(value.length()).arg(value);
+        appendField(QString("APP_JS8CALL_%1").arg(k), value.toString());
       }
   }
 
-  return t.toLatin1 ();
+  return QByteArray(_record.constData(), _record.size());
 }
 
 
-// open ADIF file and append the QSO details. Return true on success
+// open ADIF file and append the QSO details. Return true on success; the
+// record is written as it is, rather than through a text stream that would
+// decode and encode it again
 bool ADIF::addQSOToFile(QByteArray const& ADIF_record)
 {
     QFile f2(_filename);
     if (!f2.open(QIODevice::Text | QIODevice::Append))
         return false;
-    else
-    {
-        QTextStream out(&f2);
-        if (f2.size()==0)
-            out << "JS8Call ADIF Export<eoh>" << Qt::endl;  // new file
-
-        out << ADIF_record << " <eor>" << Qt::endl;
-        out.flush();
-        flushFileBuffer(f2);
-        f2.close();
-    }
-    return true;
+
+    bool ok = true;
+
+    if (f2.size()==0)
+        ok = f2.write(ADIF_HEADER) > 0;  // new file
+
+    ok = ok && f2.write(ADIF_record) == ADIF_record.size()
+            && f2.write(ADIF_TRAILER) > 0
+            && f2.flush();
+    flushFileBuffer(f2);
+    f2.close();
+
+    return ok;
 }
@@ -20,7 +20,9 @@
 
 #include "fileutils.h"
 
+class QDate;
 class QDateTime;
+class QTime;
 
 extern const QStringList ADIF_FIELDS;
 
@@ -37,10 +39,26 @@ class ADIF
     QList<ADIF::QSO> find(QString const& call) const;
 	QList<QString> getCallList() const;
 	qsizetype getCount() const;
+	QString const& filename() const { return _filename; }
+
+        // a compact binary copy of what load() reads from the log, kept next
+        // to it and stamped with the size and modification time of the log
+        // it reflects; it's good for as long as the stamp matches, and is
+        // kept that way a QSO at a time, so the log needn't be parsed again;
+        // a QSO is added along with the record that was written to the log.
+        // saveSnapshot() stamps it with the log as load() found it, before
+        // reading it, so anything written to the log while it was being read
+        // leaves the snapshot stale, rather than current and missing a QSO
+	bool loadSnapshot();
+	bool saveSnapshot();
+	bool addToSnapshot(QSO const& qso, QByteArray const& record);
 		
         // open ADIF file and append the QSO details. Return true on success
 	bool addQSOToFile(QByteArray const& ADIF_record);
 
+        // the record is built in place, a field at a time, in a buffer that's
+        // reused from one record to the next; what's returned is the one copy
+        // of it that the log file, the API and N1MM all share
     QByteArray QSOToADIF(QString const& hisCall, QString const& hisGrid, QString const& mode, QString const& submode, QString const& rptSent
                                              , QString const& rptRcvd, QDateTime const& dateTimeOn, QDateTime const& dateTimeOff
                                              , QString const& band, QString const& comments, QString const& name
@@ -51,13 +69,32 @@ class ADIF
     struct QSO
     {
       QString call,band,mode,submode,grid,date,name,comment;
+
+      bool operator==(QSO const&) const = default;
     };
 
     private:
+    struct Stamp
+    {
+      qint64 size = -1;
+      qint64 modified = -1;
+
+      bool operator==(Stamp const&) const = default;
+    };
+
 		QMultiHash<QString, QSO> _data;
 		QString _filename;
+		QByteArray _record;
+		Stamp _snapshotStamp;    // of the log, as the snapshot on disk reflects it
+		Stamp _loadStamp;        // of the log, as load() found it before reading it
+
+		Stamp stamp() const;
+		QString snapshotFilename() const;
 		
 		QString extractField(QString const& line, QString const& fieldName) const;
+		void appendField(QStringView name, QStringView value);
+		void appendField(QStringView name, QDate const& date);
+		void appendField(QStringView name, QTime const& time);
 };
 
 
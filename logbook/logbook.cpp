@@ -1,4 +1,5 @@
 #include "logbook.h"
+#include <utility>
 #include <QDebug>
 #include <QFontMetrics>
 #include <QStandardPaths>
@@ -29,10 +30,39 @@ void LogBook::init()
 
   _worked.init(_countries.getCountryNames());
 
-  _log.init(dataPath.absoluteFilePath (logFileName));
+  _log.init(_logFilename ());
   _log.load();
+  _log.saveSnapshot();
 
   _setAlreadyWorkedFromLog();
+
+  _loaded = true;
+}
+
+bool LogBook::initFromSnapshot()
+{
+  _log.init(_logFilename ());
+  return _log.loadSnapshot();
+}
+
+void LogBook::replaceWith(LogBook && loaded)
+{
+  auto const added = std::move(_added);
+
+  *this = std::move(loaded);
+
+  for (auto const & [q, record] : added)
+    {
+      if (!_log.find(q.call).contains(q))
+        {
+          addAsWorked(q.call, q.band, q.mode, q.submode, q.grid, q.date, q.name, q.comment, record);
+        }
+    }
+}
+
+QString LogBook::_logFilename() const
+{
+  return QDir {QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation)}.absoluteFilePath (logFileName);
 }
 
 
@@ -103,9 +133,14 @@ bool LogBook::findCallDetails(
     return true;
 }
 
-void LogBook::addAsWorked(const QString call, const QString band, const QString mode, const QString submode, const QString grid, const QString date, const QString name, const QString comment)
+void LogBook::addAsWorked(const QString call, const QString band, const QString mode, const QString submode, const QString grid, const QString date, const QString name, const QString comment, QByteArray const& record)
 {
+  ADIF::QSO const q {call,band,mode,submode,grid,date,name,comment};
+
   _log.add(call,band,mode,submode,grid,date,name,comment);
+  _log.addToSnapshot(q, record);
+  _added.append({q, record});
+
   QString countryName = _countries.find(call);
   if (countryName.length() > 0)
     _worked.setAsWorked(countryName);
@@ -20,7 +20,23 @@ class QDir;
 class LogBook
 {
 public:
+    // read cty.dat and the whole of the log, and write the log's snapshot
+    // afresh; slow for a big log, so it's meant to be run to the side
     void init();
+
+    // read only the log's snapshot, if it's current; enough to answer the
+    // worked before and call detail queries while init() runs elsewhere,
+    // though not those needing cty.dat. Return true if it was current
+    bool initFromSnapshot();
+
+    // true once init() has run, rather than only initFromSnapshot()
+    bool isLoaded() const { return _loaded; }
+
+    // take on a log book loaded in the background, along with any QSOs
+    // added to this one that it doesn't have, i.e., that were logged
+    // after it read the log
+    void replaceWith(LogBook && loaded);
+
     bool hasWorkedBefore(const QString &call, const QString &band);
     void match(/*in*/ const QString call,
               /*out*/ QString &countryName,
@@ -33,14 +49,25 @@ public:
                         QString &date,
                         QString &name,
                         QString &comment) const;
-    void addAsWorked(const QString call, const QString band, const QString mode, const QString submode, const QString grid, const QString date, const QString name, const QString comment);
+    // the record is the one written to the log for the QSO, by which the
+    // log's snapshot is kept current
+    void addAsWorked(const QString call, const QString band, const QString mode, const QString submode, const QString grid, const QString date, const QString name, const QString comment, QByteArray const& record);
 
 private:
    CountryDat _countries;
    CountriesWorked _worked;
    ADIF _log;
+   struct Added
+   {
+     ADIF::QSO qso;
+     QByteArray record;
+   };
+
+   QList<Added> _added;   // by addAsWorked(), since we were loaded
+   bool _loaded = false;
 
    void _setAlreadyWorkedFromLog();
+   QString _logFilename() const;
 
 };
 
@@ -30,6 +30,9 @@ LogQSO::LogQSO(QString const& programTitle, QSettings * settings
   setWindowTitle(programTitle + " - Log QSO");
   ui->grid->setValidator (new Maidenhead::StandardValidator{this});
 
+  //Log QSOs to ADIF file "js8call_log.adi"
+  m_log.init(QDir {QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation)}.absoluteFilePath ("js8call_log.adi"));  // TODO allow user to set
+
   auto b = ui->buttonBox->button(QDialogButtonBox::Save);
   if(b){
       b->setText("Add to Log");
@@ -258,20 +261,15 @@ void LogQSO::accept()
   QString strDialFreq(QString::number(m_dialFreq / 1.e6,'f',6));
   operator_call = ui->loggedOperator->text();
   //Log this QSO to ADIF file "js8call_log.adi"
-  QString filename = "js8call_log.adi";  // TODO allow user to set
-  ADIF adifile;
-  auto adifilePath = QDir {QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation)}.absoluteFilePath (filename);
-  adifile.init(adifilePath);
-
   auto additionalFields = collectAdditionalFields();
 
-  QByteArray ADIF {adifile.QSOToADIF (hisCall, hisGrid, mode, submode, rptSent, rptRcvd, m_dateTimeOn, m_dateTimeOff, band
-                                      , comments, name, strDialFreq, m_myCall, m_myGrid, operator_call, additionalFields)};
+  QByteArray ADIF {m_log.QSOToADIF (hisCall, hisGrid, mode, submode, rptSent, rptRcvd, m_dateTimeOn, m_dateTimeOff, band
+                                    , comments, name, strDialFreq, m_myCall, m_myGrid, operator_call, additionalFields)};
 
-  if (!adifile.addQSOToFile (ADIF))
+  if (!m_log.addQSOToFile (ADIF))
   {
     MessageBox::warning_message (this, tr ("Log file error"),
-                                 tr ("Cannot open \"%1\"").arg (adifilePath));
+                                 tr ("Cannot open \"%1\"").arg (m_log.filename ()));
   }
 
   //Log this QSO to file "js8call.log"
@@ -15,6 +15,7 @@
 #include <QLineEdit>
 
 #include "Radio.hpp"
+#include "logbook/adif.h"
 
 namespace Ui {
   class LogQSO;
@@ -68,6 +69,7 @@ private:
   QScopedPointer<Ui::LogQSO> ui;
   QSettings * m_settings;
   Configuration const * m_config;
+  ADIF m_log;   // held on to, so that its record buffer is reused
   QString m_comments;
   Radio::Frequency m_dialFreq;
   QString m_myCall;
@@ -7,6 +7,7 @@
 #include <fftw3.h>
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QApplication>
 #include <QRegularExpression>
 #include <QObject>
@@ -68,6 +69,11 @@ namespace
 
 int main(int argc, char *argv[])
 {
+  // Startup timeline clock; from here, for the first main window, and from
+  // the restart for any that follow.
+  QElapsedTimer startup_clock;
+  startup_clock.start ();
+
   // Add timestamps to all debug messages
   MessageTimestamper message_timestamper;
 
@@ -202,7 +208,7 @@ int main(int argc, char *argv[])
 
 #if WSJT_QDEBUG_TO_FILE
       // Open a trace file
-      TraceFile trace_file {temp_dir.absoluteFilePath (a.applicationName () + "_trace.log")};
+      TraceFile trace_file {temp_dir.absoluteFilePath (a.applicationName () + "_trace.log"), WSJT_TRACE_FLIGHT_RECORDER};
       qDebug () << program_title () + " - Program startup";
 #endif
 
@@ -262,9 +268,10 @@ int main(int argc, char *argv[])
 #endif
 
           // run the application UI
-          MainWindow w(program_version(), temp_dir, multiple, &multi_settings);
+          MainWindow w(program_version(), temp_dir, multiple, &multi_settings, startup_clock);
           w.show();
           result = a.exec();
+          startup_clock.start ();
         }
       while (!result && !multi_settings.exit ());
 
@@ -38,7 +38,6 @@
 #include <QAction>
 #include <QActionGroup>
 #include <QSoundEffect>
-#include <QUdpSocket>
 #include <QVariant>
 #include <QPixmap>
 #include <QMdiSubWindow>
@@ -50,6 +49,11 @@
 #include <QByteArrayView>
 #include <QElapsedTimer>
 #include <QStringBuilder>
+#include <QDialogButtonBox>
+#include <QFontDatabase>
+#include <QPlainTextEdit>
+#include <QVBoxLayout>
+#include <QWindow>
 
 #include "revision_utils.hpp"
 #include "qt_helpers.hpp"
@@ -58,6 +62,7 @@
 #include "soundin.h"
 #include "Modulator.hpp"
 #include "Detector.hpp"
+#include "AudioKernels.hpp"
 #include "plotter.h"
 #include "about.h"
 #include "widegraph.h"
@@ -88,6 +93,12 @@
 #include "ui_mainwindow.h"
 #include "moc_mainwindow.cpp"
 
+#if defined(Q_OS_WIN)
+#include <QtCore/qt_windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
 int volatile    itone[JS8_NUM_SYMBOLS];  // Audio tones for all Tx symbols
 struct dec_data dec_data;                // for sharing with Fortran
 struct specData specData;                // Used by plotter
@@ -108,6 +119,162 @@ namespace
     constexpr auto TX = 2;
   }
 
+  namespace Backlog
+  {
+    // Number of decode windows skipped while the decoder was busy that we'll
+    // hold on to, and how close we'll let one get to being overwritten in the
+    // sample buffer before giving up on it.
+
+    constexpr qsizetype SIZE      = 8;
+    constexpr qint64    MARGIN_MS = 1000;
+  }
+
+  namespace Hints
+  {
+    // How recently we must have heard from a station that's been sending to
+    // us for the decoder to be told to expect more of the same.
+
+    constexpr qint64 MAX_AGE_SECS = 120;
+  }
+
+  namespace Compaction
+  {
+    // Retention limits are applied to the activity maps by a wheel of slots,
+    // one map to a slot, turned a slot per tick. Each visit examines no more
+    // than a budget's worth of entries, resuming where the last visit to the
+    // map left off, so that no one tick takes long, however large the maps
+    // have grown.
+
+    constexpr int       SLOTS   = 5;
+    constexpr int       TICK_MS = 250;
+    constexpr qsizetype BUDGET  = 256;
+  }
+
+  namespace Memory
+  {
+    // How often memory accounting is sampled, to keep its high-water marks;
+    // the logging interval, if any, is a whole number of these.
+
+    constexpr int SAMPLE_MS = 60 * 1000;
+
+    // Rough overhead of a block in a text document, beyond its characters;
+    // block data, layout and formats.
+
+    constexpr qsizetype TEXT_BLOCK = 128;
+  }
+
+  // CPU time, user and system, consumed by the process so far, in ms.
+
+  qint64
+  processCpuMs()
+  {
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+
+    auto const ms = [](FILETIME const & time)
+    {
+      return (qint64(time.dwHighDateTime) << 32 | time.dwLowDateTime) / 10000;
+    };
+
+    return ms(kernel) + ms(user);
+#else
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+
+    return (usage.ru_utime.tv_sec  + usage.ru_stime.tv_sec)  * 1000LL +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#endif
+  }
+
+  // Examine no more than budget entries of a map, starting at the cursor,
+  // removing those for which the predicate holds. The cursor's left at the
+  // entry to resume from, or reset once the end of the map is reached.
+  // Returns the number of entries removed.
+
+  template<typename Map,
+           typename Predicate>
+  qsizetype
+  sweep(Map                                   & map,
+        std::optional<typename Map::key_type> & cursor,
+        qsizetype                               budget,
+        Predicate                            && remove)
+  {
+    qsizetype removed = 0;
+    auto      it      = cursor ? map.lowerBound(*cursor) : map.begin();
+
+    for (; it != map.end() && budget > 0; --budget)
+    {
+      if (remove(it.key(), it.value()))
+      {
+        it = map.erase(it);
+        ++removed;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    cursor = it == map.end() ? std::nullopt : std::make_optional(it.key());
+
+    return removed;
+  }
+
+  // Whether there are more entries than a count limit allows, if any.
+
+  bool
+  overCount(qsizetype const size,
+            qsizetype const count)
+  {
+    return count && size > count;
+  }
+
+  // Timestamp, in ms since the epoch, at or before which entries must go in
+  // order for no more than count of them to remain across the maps, oldest
+  // first, or the earliest possible time, if there's no need for any to go.
+  // Walks every entry, so it's taken once a pass, not once a visit.
+
+  template<typename Stamp,
+           typename... Maps>
+  qint64
+  countCutoff(qsizetype const     count,
+              Stamp          &&    stamp,
+              Maps      const &... maps)
+  {
+    auto const size = (maps.size() + ...);
+
+    if (!overCount(size, count)) return std::numeric_limits<qint64>::min();
+
+    std::vector<qint64> stamps;
+    stamps.reserve(size);
+
+    auto const collect = [&](auto const & map)
+    {
+      for (auto it = map.cbegin(); it != map.cend(); ++it) stamps.push_back(stamp(it.key(), it.value()));
+    };
+
+    (collect(maps), ...);
+
+    auto const nth = stamps.begin() + (size - count - 1);
+    std::nth_element(stamps.begin(), nth, stamps.end());
+
+    return *nth;
+  }
+
+  // Timestamp, in ms since the epoch, before which entries are too old to be
+  // kept, or the earliest possible time, if they can be kept forever.
+
+  qint64
+  ageCutoff(qint64 const now,
+            int    const maxAgeMins)
+  {
+    return maxAgeMins ? now - maxAgeMins * 60000LL
+                      : std::numeric_limits<qint64>::min();
+  }
+
   int ms_minute_error ()
   {
     auto const now    = DriftingDateTime::currentDateTime();
@@ -118,9 +285,10 @@ namespace
   }
 
   QString
-  since(QDateTime const & time)
+  since(UtcTime const time,
+        UtcTime const now = DriftingDateTime::currentUtc())
   {
-      auto const delta = time.secsTo(DriftingDateTime::currentDateTimeUtc());
+      auto const delta = time.secsTo(now);
 
       if      (delta >= 60 * 60 * 24) return QString("%1d").arg(delta / (60 * 60 * 24));
       else if (delta >= 60 * 60     ) return QString("%1h").arg(delta / (60 * 60     ));
@@ -307,8 +475,10 @@ MainWindow::MainWindow(QString  const & program_info,
                        QDir     const & temp_directory,
                        bool     const   multiple,
                        MultiSettings  * multi_settings,
+                       QElapsedTimer const & startupClock,
                        QWidget        * parent) :
   QMainWindow(parent),
+  m_startup {startupClock, this},
   m_network_manager {this},
   m_valid {true},
   m_multiple {multiple},
@@ -367,6 +537,8 @@ MainWindow::MainWindow(QString  const & program_info,
   m_driftMsMMA { 0 },
   m_driftMsMMA_N { 0 },
   m_previousFreq {0},
+  m_bandHopSegment {-1},
+  m_bandHopPending {false},
   m_hbInterval {0},
   m_cqInterval {0},
   m_hbPaused { false },
@@ -386,14 +558,23 @@ MainWindow::MainWindow(QString  const & program_info,
   m_lastMonitoredFrequency {Default::DIAL_FREQUENCY},
   m_messageClient {new MessageClient {m_config.udp_server_name(), m_config.udp_server_port(), this}},
   m_messageServer {new MessageServer()},
-  m_n3fjpClient {new TCPClient{this}},
+  m_logDispatcher {new LogDispatcher {QDir {QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation)}.absoluteFilePath ("log_queue.json")}},
   m_pskReporter {new PSKReporter {&m_config, program_info}},     // UR
   m_spotClient {new SpotClient   {"spot.js8call.com", 50000, program_info}},
   m_aprsClient {new APRSISClient {"rotate.aprs2.net", 14580}},
   m_manual {&m_network_manager}
 {
+  // Everything up to here, notably the configuration, with its audio
+  // device and rig enumeration, has happened in member construction.
+
+  m_startup.mark("members", m_startup.created());
+
+  auto const uiStart = m_startup.elapsed();
+
   ui->setupUi(this);
 
+  m_startup.mark("ui", uiStart);
+
   createStatusBar();
   add_child_to_event_filter (this);
 
@@ -418,13 +599,14 @@ MainWindow::MainWindow(QString  const & program_info,
   // notification audio operates in its own thread at a lower priority
   m_notification->moveToThread(&m_notificationAudioThread);
 
-  // Move the aprs client message server, psk reporter, and spot client
-  // to the network thread at a lower priority.
+  // Move the aprs client message server, psk reporter, spot client, and
+  // log dispatcher to the network thread at a lower priority.
 
   m_aprsClient->moveToThread(&m_networkThread);
   m_messageServer->moveToThread(&m_networkThread);
   m_pskReporter->moveToThread(&m_networkThread);
   m_spotClient->moveToThread(&m_networkThread);
+  m_logDispatcher->moveToThread(&m_networkThread);
 
   // hook up the message server slots and signals and disposal
   connect (m_messageServer, &MessageServer::message, this, &MainWindow::tcpNetworkMessage);
@@ -437,6 +619,9 @@ MainWindow::MainWindow(QString  const & program_info,
   connect (&m_config, &Configuration::tcp_max_connections_changed, m_messageServer, &MessageServer::setMaxConnections);
   connect (&m_networkThread, &QThread::finished, m_messageServer, &QObject::deleteLater);
 
+  // replies to the API queries answered off the GUI thread
+  connect (&m_apiQueries, &ApiQueries::ready, this, [this](Message const &reply){ sendNetworkMessage(reply); });
+
   // hook up the aprs client slots and signals and disposal
   connect (this, &MainWindow::aprsClientEnqueueSpot,       m_aprsClient, &APRSISClient::enqueueSpot);
   connect (this, &MainWindow::aprsClientEnqueueThirdParty, m_aprsClient, &APRSISClient::enqueueThirdParty);
@@ -462,6 +647,12 @@ MainWindow::MainWindow(QString  const & program_info,
   connect (&m_networkThread, &QThread::started,  m_spotClient, &SpotClient::start);
   connect (&m_networkThread, &QThread::finished, m_spotClient, &QObject::deleteLater);
 
+  // hook up the log dispatcher slots and signals and disposal
+  connect (m_logDispatcher, &LogDispatcher::status, this, &MainWindow::logDispatcherStatus);
+  connect (this, &MainWindow::logDispatcherEnqueue, m_logDispatcher, &LogDispatcher::enqueue);
+  connect (&m_networkThread, &QThread::started,  m_logDispatcher, &LogDispatcher::start);
+  connect (&m_networkThread, &QThread::finished, m_logDispatcher, &QObject::deleteLater);
+
   // hook up sound output stream slots & signals and disposal
   connect (this, &MainWindow::initializeAudioOutputStream, m_soundOutput, &SoundOutput::setFormat);
   connect (m_soundOutput, &SoundOutput::error, this, &MainWindow::showSoundOutError);
@@ -471,6 +662,7 @@ MainWindow::MainWindow(QString  const & program_info,
 
   connect (this, &MainWindow::initializeNotificationAudioOutputStream, m_notification, &NotificationAudio::setDevice);
   connect (&m_config, &Configuration::test_notify, this, &MainWindow::tryNotify);
+  connect (this, &MainWindow::prepareNotifications, m_notification, &NotificationAudio::prepare);
   connect (this, &MainWindow::playNotification, m_notification, &NotificationAudio::play);
   connect (&m_notificationAudioThread, &QThread::finished, m_notification, &QObject::deleteLater);
 
@@ -598,9 +790,11 @@ MainWindow::MainWindow(QString  const & program_info,
   connect (&m_config, &Configuration::udp_server_port_changed, m_messageClient, &MessageClient::set_server_port);
   connect (&m_config, &Configuration::band_schedule_changed, this, [this](){
     this->m_bandHopped = true;
+    updateBandHopSchedule();
   });
   connect (&m_config, &Configuration::auto_switch_bands_changed, this, [this](bool auto_switch_bands){
 	this->m_bandHopped = this->m_bandHopped || auto_switch_bands;
+    updateBandHopSchedule();
   });
   connect (&m_config, &Configuration::manual_band_hop_requested, this, &MainWindow::manualBandHop);
   connect (&m_config, &Configuration::enumerating_audio_devices, [this]()
@@ -653,6 +847,23 @@ MainWindow::MainWindow(QString  const & program_info,
   repeatTimer.setInterval(1000);
   connect(&repeatTimer, &QTimer::timeout, this, &MainWindow::checkRepeat);
 
+  // band hop timer fires at the next transition in the station schedule; the
+  // timer may fire a touch early, in which case we just wait for it again.
+  m_bandHopTimer.setSingleShot(true);
+  m_bandHopTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_bandHopTimer, &QTimer::timeout, this, [this](){
+    if(m_bandHopSchedule.segment(DriftingDateTime::currentDateTimeUtc()) != m_bandHopSegment){
+      m_bandHopPending = true;
+      tryBandHop();
+    }
+    scheduleBandHop();
+  });
+  updateBandHopSchedule();
+
+  // activity maps are compacted a little at a time, continuously
+  connect(&m_compactionTimer, &QTimer::timeout, this, &MainWindow::compactActivity);
+  m_compactionTimer.start(Compaction::TICK_MS);
+
   connect(m_wideGraph.data(), &WideGraph::changeFreq, this, &MainWindow::changeFreq);
   connect(m_wideGraph.data(), &WideGraph::qsy,        this, &MainWindow::qsy);
   connect(m_wideGraph.data(), &WideGraph::drifted,    this, &MainWindow::drifted);
@@ -662,25 +873,103 @@ MainWindow::MainWindow(QString  const & program_info,
   m_msg[0][0]=0;
 
   displayDialFrequency();
+
+  auto const settingsStart = m_startup.elapsed();
+
   readSettings();            //Restore user's setup params
 
+  m_startup.mark("settings", settingsStart);
+
+  // Staged startup; anything that doesn't have to hold up the window is
+  // run from here on, in dependency order, independent stages in parallel.
+  // FFTW wisdom must be in place before the decoder builds its plans; the
+  // logbook and cty.dat are parsed to the side and swapped in when ready,
+  // with the log's snapshot answering worked before queries until then.
+
+  using Runner = StartupTimeline::Runner;
+
+  auto const constructorStart = m_startup.elapsed();
+  auto const wisdom           = wisdomFileName();
+  auto const inbox            = inboxPath();
+  auto const logBook          = std::make_shared<LogBook>();
+  auto const logBookSnapshot  = std::make_shared<LogBook>();
+
+  m_logBookLoader.setMaxThreadCount(1);
+
+  m_startup.add("fftw.wisdom", Runner::Worker, {}, [wisdom]()
   {
     std::lock_guard<std::mutex> lock(fftw_mutex);
-    fftwf_import_wisdom_from_filename(wisdomFileName());
-  }
+    fftwf_import_wisdom_from_filename(wisdom);
+  });
+
+  m_startup.add("decoder", Runner::GUI, {"fftw.wisdom"}, [this]()
+  {
+    m_decoder.start(m_decoderThreadPriority);
+  });
+
+  m_startup.add("logbook.snapshot", Runner::Worker, {}, [logBookSnapshot]()
+  {
+    logBookSnapshot->initFromSnapshot();
+  });
+
+  m_startup.add("logbook.early", Runner::GUI, {"logbook.snapshot"}, [this, logBookSnapshot]()
+  {
+    if (m_logBook.isLoaded() || m_logBookLoads) return;
+
+    m_logBook.replaceWith(std::move(*logBookSnapshot));
+    displayCallActivity();
+  });
+
+  // Rewrites the snapshot, so it mustn't start until that's been read.
+
+  m_startup.add("logbook.load", Runner::Worker, {"logbook.snapshot"}, [logBook]()
+  {
+    logBook->init();
+  });
+
+  m_startup.add("logbook", Runner::GUI, {"logbook.load"}, [this, logBook]()
+  {
+    if (m_logBookLoads) return;   // overtaken by a reload
+
+    m_logBook.replaceWith(std::move(*logBook));
+    updateGeometry();
+    displayCallActivity();
+  });
+
+  m_startup.add("inbox", Runner::Worker, {}, [inbox]()
+  {
+    Inbox(inbox).open();     // creates schema and indices on first run
+  });
+
+  connect(&m_startup, &StartupTimeline::progress, this, [this](int const completed,
+                                                               int const total,
+                                                               QString const & stage)
+  {
+    showStatusMessage(tr("Starting: %1 (%2 of %3)").arg(stage).arg(completed).arg(total));
+  });
+
+  connect(&m_startup, &StartupTimeline::done, this, [this](qint64 const elapsed)
+  {
+    showStatusMessage(tr("Startup complete in %1 ms").arg(elapsed));
+
+    if (auto const path = qEnvironmentVariable("JS8CALL_STARTUP_TIMELINE"); !path.isEmpty())
+    {
+      if (!m_startup.save(path)) qWarning() << "unable to write startup timeline to" << path;
+    }
+  });
+
+  m_startup.start();
 
   m_networkThread.start(m_networkThreadPriority);
   m_audioThread.start (m_audioThreadPriority);
   m_notificationAudioThread.start(m_notificationAudioThreadPriority);
-  m_decoder.start(m_decoderThreadPriority);
 
   Q_EMIT startAudioInputStream (m_config.audio_input_device (), m_framesAudioInputBuffered, m_detector, m_config.audio_input_channel ());
   Q_EMIT initializeAudioOutputStream (m_config.audio_output_device (), AudioDevice::Mono == m_config.audio_output_channel () ? 1 : 2, m_msAudioOutputBuffered);
   Q_EMIT initializeNotificationAudioOutputStream(m_config.notification_audio_output_device(), m_msAudioOutputBuffered);
+  Q_EMIT prepareNotifications(m_config.notification_paths());
   Q_EMIT transmitFrequency (freq() - m_XIT);
 
-  enable_DXCC_entity (m_config.DXCC ());  // sets text window proportions and (re)inits the logbook
-
   // this must be done before initializing the mode as some modes need
   // to turn off split on the rig e.g. WSPR
   m_config.transceiver_online ();
@@ -1101,25 +1390,9 @@ MainWindow::MainWindow(QString  const & program_info,
           return;
       }
 
-      QList<QPair<int, Message> > msgs;
-
-      msgs.append(inbox.values("STORE", "$.params.TO", selectedCall, 0, 1000));
-
-      msgs.append(inbox.values("READ", "$.params.FROM", selectedCall, 0, 1000));
-
-      foreach(auto pair, inbox.values("UNREAD", "$.params.FROM", selectedCall, 0, 1000)){
-          msgs.append(pair);
-
-          // mark as read
-          auto msg = pair.second;
-          msg.setType("READ");
-          inbox.set(pair.first, msg);
-      }
-
-      std::stable_sort(msgs.begin(), msgs.end(), [](QPair<int, Message> const &a, QPair<int, Message> const &b){
-          return QVariant::compare(a.second.params().value("UTC"),
-                                   b.second.params().value("UTC")) == QPartialOrdering::Greater;
-      });
+      // anything unread is read once the window's shown, though we'll still
+      // flag it as unread while it is
+      auto unread = inbox.markReadFrom(selectedCall);
 
       auto mw = new MessageWindow(this);
       connect(mw, &MessageWindow::finished, this, [this](int){
@@ -1140,8 +1413,9 @@ MainWindow::MainWindow(QString  const & program_info,
           displayCallActivity();
           mw->close();
       });
+      connect(this, &MainWindow::inboxUpdated, mw, &MessageWindow::refresh);
       mw->setCall(selectedCall);
-      mw->populateMessages(msgs);
+      mw->showInbox(inboxPath(), unread);
       mw->show();
   });
 
@@ -1168,7 +1442,7 @@ MainWindow::MainWindow(QString  const & program_info,
       d.from = m_config.my_callsign();
       d.relayPath = d.from;
       d.text = m->textValue();
-      d.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+      d.utcTimestamp = DriftingDateTime::currentUtc();
       d.submode = m_nSubMode;
 
       addCommandToStorage("STORE", d);
@@ -1369,6 +1643,15 @@ MainWindow::MainWindow(QString  const & program_info,
   QTimer::singleShot(500, this, &MainWindow::initializeDummyData);
   QTimer::singleShot(500, this, &MainWindow::initializeGroupMessageDummyData);
 
+  connect(ui->menuHelp->addAction(tr("Startup Timeline...")), &QAction::triggered, this, &MainWindow::showStartupTimeline);
+  connect(ui->menuHelp->addAction(tr("Memory Usage...")), &QAction::triggered, this, &MainWindow::showMemoryUsage);
+
+  addMemoryAccounts();
+  connect(&m_memoryTimer, &QTimer::timeout, this, &MainWindow::sampleMemory);
+  m_memoryTimer.start(Memory::SAMPLE_MS);
+
+  m_startup.mark("constructor", constructorStart);
+
   // this must be the last statement of constructor
   if (!m_valid) throw std::runtime_error {"Fatal initialization exception"};
 }
@@ -1628,7 +1911,7 @@ void MainWindow::initializeDummyData(){
         "W0FW"
     };
 
-    auto dt = DriftingDateTime::currentDateTimeUtc().addSecs(-300);
+    auto dt = DriftingDateTime::currentUtc().addSecs(-300);
 
     int i = 0;
     foreach(auto call, calls){
@@ -1638,7 +1921,7 @@ void MainWindow::initializeDummyData(){
         cd.dial = 7078000;
         cd.offset = 500 + 100*i;
         cd.snr = i == 3 ? -100 : i;
-        cd.ackTimestamp = i == 1 ? dt.addSecs(-900) : QDateTime{};
+        cd.ackTimestamp = i == 1 ? dt.addSecs(-900) : UtcTime{};
         cd.utcTimestamp = dt;
         cd.grid = i == 5 ? "J042" : i == 6 ? " FN42FN42FN" : "";
         cd.tdrift = 0.1*i;
@@ -1666,7 +1949,7 @@ void MainWindow::initializeDummyData(){
     adHB1.dial = 7078000;
     adHB1.offset = 750;
     adHB1.text = QString("KN4CRD: HB AUTO EM73");
-    adHB1.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+    adHB1.utcTimestamp = DriftingDateTime::currentUtc();
     adHB1.submode = Varicode::JS8CallNormal;
     m_bandActivity[750].append(adHB1);
 
@@ -1676,7 +1959,7 @@ void MainWindow::initializeDummyData(){
     adHB2.dial = 7078000;
     adHB2.offset = 750;
     adHB2.text = QString(" MSG ID 1");
-    adHB2.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+    adHB2.utcTimestamp = DriftingDateTime::currentUtc();
     adHB2.submode = Varicode::JS8CallNormal;
     m_bandActivity[750].append(adHB2);
 
@@ -1719,7 +2002,7 @@ void MainWindow::initializeGroupMessageDummyData()
 		m_config.addGroup("@GROUP42");
 	}
 
-	auto dt = DriftingDateTime::currentDateTimeUtc().addSecs(-300);
+	auto dt = DriftingDateTime::currentUtc().addSecs(-300);
 
 	CommandDetail cmd = {};
 	cmd.cmd = " MSG TO:";
@@ -1737,7 +2020,7 @@ void MainWindow::initializeGroupMessageDummyData()
 	cmd2.cmd = " QUERY MSGS";
 	cmd2.from = "W1AW";
 	cmd2.to = "@GROUP42";
-	cmd2.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+	cmd2.utcTimestamp = DriftingDateTime::currentUtc();
 	cmd2.submode = Varicode::JS8CallNormal;
 
 	m_rxCommandQueue.append(cmd2);
@@ -1758,7 +2041,7 @@ void MainWindow::initializeGroupMessageDummyData()
 	cmd3.cmd = " QUERY";
 	cmd3.from = "W1AW";
 	cmd3.to = "@GROUP42";
-	cmd3.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+	cmd3.utcTimestamp = DriftingDateTime::currentUtc();
 	cmd3.submode = Varicode::JS8CallNormal;
 	cmd3.text = textString.c_str();
 
@@ -1809,60 +2092,29 @@ void MainWindow::on_the_minute ()
 void MainWindow::tryBandHop(){
   // see if we need to hop bands...
   if(!m_config.auto_switch_bands()){
+      m_bandHopPending = false;
       return;
   }
 
-  // make sure we're not transmitting
+  // make sure we're not transmitting; we'll try again next period
   if(isMessageQueuedForTransmit()){
       return;
   }
 
+  m_bandHopPending = false;
+
   // get the current band
   auto dialFreq = dialFrequency();
 
-  auto currentBand = m_config.bands()->find(dialFreq);
-
-  // get the stations list
-  auto stations = m_config.stations()->station_list();
-
-  // order stations by (switch_at, switch_until) time tuple
-  std::stable_sort(stations.begin(), stations.end(), [](StationList::Station const &a, StationList::Station const &b){
-    return (a.switch_at_ < b.switch_at_) || (a.switch_at_ == b.switch_at_ && a.switch_until_ < b.switch_until_);
-  });
+  // look up the station, if any, that the schedule has active right now; in
+  // the case of overlapping windows, the schedule has chosen the latest one
+  auto const now = DriftingDateTime::currentDateTimeUtc();
+  auto const hopStation = m_bandHopSchedule.station(now);
 
-  // we just set the date to a known y/m/d to make the comparisons easier
-  QDateTime d = DriftingDateTime::currentDateTimeUtc();
-  d.setDate(QDate(2000, 1, 1));
-
-  QDateTime startOfDay = QDateTime(QDate(2000, 1, 1), QTime(0, 0), QTimeZone::utc());
-  QDateTime endOfDay = QDateTime(QDate(2000, 1, 1), QTime(23, 59, 59, 999), QTimeZone::utc());
-
-  StationList::Station * hopStation = nullptr;
-
-  // See if we can find a needed band switch...
-  // In the case of overlapping windows, choose the latest one
-  foreach(auto station, stations){
-      // we can switch to this frequency if we're in the time range, inclusive of switch_at, exclusive of switch_until
-      // and if we are switching to a different frequency than the last hop. this allows us to switch bands at that time,
-      // but then later we can later switch to a different band if needed without the automatic band switching to take over
-      bool inTimeRange = (
-        (station.switch_at_ <= d && d <= station.switch_until_) ||          // <- normal range, 12-16 && 6-8, evaluated as 12 <= d <= 16 || 6 <= d <= 8
-
-        (station.switch_until_ < station.switch_at_ && (                    // <- say for a range of 12->2 & 2->12;  12->2,
-             (station.switch_at_ <= d && d <= endOfDay)         ||          //    should be evaluated as 12 <= d <= 23:59 || 00:00 <= d <= 2
-             (startOfDay <= d && d <= station.switch_until_)
-        ))
-      );
-
-	  if(inTimeRange)
-	  {
-		  delete hopStation;
-		  hopStation = new StationList::Station(station);
-	  }
-  }
+  m_bandHopSegment = m_bandHopSchedule.segment(now);
 
   // If we have a candidate station, see if the hop is valid, and if so, do it
-  if(hopStation != nullptr)
+  if(hopStation)
   {
 	  bool noOverride = (
 			  m_bandHopped || (!m_bandHopped && hopStation->frequency_ != m_bandHoppedFreq)
@@ -1918,8 +2170,43 @@ void MainWindow::tryBandHop(){
 
 		  return;
 	  }
+  }
+}
+
+void MainWindow::updateBandHopSchedule(){
+  // compile the station list into a timeline of transitions; from here on,
+  // nothing is looked at until the next transition arrives
+  m_bandHopSchedule.compile(m_config.stations()->station_list());
+
+  // evaluate at the next period boundary, as if a transition just occurred
+  m_bandHopSegment = -1;
+  m_bandHopPending = true;
+
+  auto const & stations = m_bandHopSchedule.stations();
+  auto const & conflicts = m_bandHopSchedule.conflicts();
+
+  for(auto const & [ignored, chosen] : conflicts){
+    qWarning() << "band hop schedule conflict:" << stations[ignored] << "overlaps" << stations[chosen] << "which takes precedence";
+  }
+
+  if(!conflicts.isEmpty() && m_config.auto_switch_bands()){
+    showStatusMessage(tr("Band hop schedule has %n overlapping window(s) with different frequencies", "", conflicts.size()));
+  }
+
+  scheduleBandHop();
+}
+
+void MainWindow::scheduleBandHop(){
+  m_bandHopTimer.stop();
+
+  if(!m_config.auto_switch_bands()){
+    return;
+  }
+
+  auto const now = DriftingDateTime::currentDateTimeUtc();
 
-	  delete hopStation;
+  if(auto const next = m_bandHopSchedule.next(now)){
+    m_bandHopTimer.start(static_cast<int>(std::max(0LL, now.msecsTo(*next))));
   }
 }
 
@@ -1993,6 +2280,7 @@ void MainWindow::writeSettings()
   m_settings->setValue("ShowColumns", QVariant(m_showColumnsCache));
   m_settings->setValue("HBInterval", m_hbInterval);
   m_settings->setValue("CQInterval", m_cqInterval);
+  m_settings->setValue("MemoryLogInterval", m_memoryLogInterval);
 
 
 
@@ -2008,13 +2296,19 @@ void MainWindow::writeSettings()
 
   m_settings->endGroup();
 
+  m_settings->beginGroup("Retention");
+  for(auto const &retention : m_retention){
+      m_settings->setValue(QString("%1MaxAge").arg(retention.name), retention.maxAgeMins);
+      m_settings->setValue(QString("%1MaxCount").arg(retention.name), qlonglong(retention.maxCount));
+  }
+  m_settings->endGroup();
 
-  auto now = DriftingDateTime::currentDateTimeUtc();
+  auto now = DriftingDateTime::currentUtc();
   int callsignAging = m_config.callsign_aging();
 
   m_settings->beginGroup("CallActivity");
   m_settings->remove(""); // remove all keys in current group
-  foreach(auto cd, m_callActivity.values()){
+  for(auto const &cd : std::as_const(m_callActivity)){
       if (cd.call.trimmed().isEmpty()){
           continue;
       }
@@ -2028,11 +2322,11 @@ void MainWindow::writeSettings()
         {"freq", QVariant(cd.offset)},
         {"tdrift", QVariant(cd.tdrift)},
 #if CACHE_CALL_DATETIME_AS_STRINGS
-        {"ackTimestamp", QVariant(cd.ackTimestamp.toString("yyyy-MM-dd hh:mm:ss"))},
-        {"utcTimestamp", QVariant(cd.utcTimestamp.toString("yyyy-MM-dd hh:mm:ss"))},
+        {"ackTimestamp", QVariant(cd.ackTimestamp.toDateTime().toString("yyyy-MM-dd hh:mm:ss"))},
+        {"utcTimestamp", QVariant(cd.utcTimestamp.toDateTime().toString("yyyy-MM-dd hh:mm:ss"))},
 #else
-        {"ackTimestamp", QVariant(cd.ackTimestamp)},
-        {"utcTimestamp", QVariant(cd.utcTimestamp)},
+        {"ackTimestamp", QVariant(cd.ackTimestamp.toDateTime())},
+        {"utcTimestamp", QVariant(cd.utcTimestamp.toDateTime())},
 #endif
         {"submode", QVariant(cd.submode)},
       });
@@ -2106,6 +2400,7 @@ void MainWindow::readSettings()
   m_showColumnsCache = m_settings->value("ShowColumns").toMap();
   m_hbInterval = m_settings->value("HBInterval", 0).toInt();
   m_cqInterval = m_settings->value("CQInterval", 0).toInt();
+  m_memoryLogInterval = m_settings->value("MemoryLogInterval", 0).toInt();
 
   // TODO: jsherer - any other customizations?
   //ui->mainSplitter->setSizes(m_settings->value("MainSplitter", QVariant::fromValue(ui->mainSplitter->sizes())).value<QList<int> >());
@@ -2122,6 +2417,13 @@ void MainWindow::readSettings()
 
   m_settings->endGroup();
 
+  m_settings->beginGroup("Retention");
+  for(auto &retention : m_retention){
+      retention.maxAgeMins = m_settings->value(QString("%1MaxAge").arg(retention.name), retention.maxAgeMins).toInt();
+      retention.maxCount = m_settings->value(QString("%1MaxCount").arg(retention.name), qlonglong(retention.maxCount)).toLongLong();
+  }
+  m_settings->endGroup();
+
   // use these initialisation settings to tune the audio o/p buffer
   // size and audio thread priority
   m_settings->beginGroup ("Tune");
@@ -2169,8 +2471,8 @@ void MainWindow::readSettings()
           cd.dial = dial;
           cd.offset = freq;
           cd.tdrift = tdrift;
-          cd.ackTimestamp = ackTimestamp;
-          cd.utcTimestamp = utcTimestamp;
+          cd.ackTimestamp = UtcTime::fromDateTime(ackTimestamp);
+          cd.utcTimestamp = UtcTime::fromDateTime(utcTimestamp);
           cd.submode = submode;
 
           logCallActivity(cd, false);
@@ -2251,18 +2553,10 @@ void MainWindow::dataSink(qint64 frames)
       }
 
       float gain  = pow(10.0f, 0.1f * m_inGain);
-      float sq    = 0.0f;
-      float pxmax = 0.0f;
+      auto  level = AudioKernels::level(dec_data.d2 + std::min(k0, k), std::max(k - k0, 0));
 
-      for (int i = k0; i < k; ++i)
-      {
-        float x1 = dec_data.d2[i];
-        pxmax    = std::max(pxmax, fabs(x1));
-        sq      += x1 * x1;
-      }
-
-      m_px    = sq    > 0.0f ? 10.0f * log10(sq / (k - k0)) : 0.0f;
-      m_pxmax = pxmax > 0.0f ? 20.0f * log10(pxmax)         : 0.0f;
+      m_px    = level.sumOfSquares ? 10.0f * log10(float(level.sumOfSquares) / (k - k0)) : 0.0f;
+      m_pxmax = level.peak         ? 20.0f * log10(float(level.peak))                   : 0.0f;
 
       k0  = k;
       ja += jstep;
@@ -2387,7 +2681,7 @@ void MainWindow::dataSink(qint64 frames)
 
     if(m_ihsym <= 0) return;
 
-    if(ui) ui->signal_meter_widget->setValue(m_px, m_pxmax); // Update thermometer
+    if(ui && m_displayState == DisplayState::Visible) ui->signal_meter_widget->setValue(m_px, m_pxmax); // Update thermometer
 
     if(m_monitoring) m_wideGraph->dataSink(s, m_df3);
 
@@ -2756,6 +3050,9 @@ void MainWindow::openSettings(int tab){
                 m_msAudioOutputBuffered);
         }
 
+        // Decode any newly configured sounds now, rather than on first use.
+        Q_EMIT prepareNotifications(m_config.notification_paths());
+
         displayDialFrequency ();
         displayActivity(true);
 
@@ -2836,7 +3133,11 @@ void MainWindow::monitor (bool state)
   m_wideGraph->setPaused(!state);
 
   if (state) {
-    if (!m_monitoring) Q_EMIT resumeAudioInputStream ();
+    if (!m_monitoring) {
+      m_decodeSchedule.reset();
+      decodeBacklogClear();
+      Q_EMIT resumeAudioInputStream ();
+    }
   } else {
     Q_EMIT suspendAudioInputStream ();
   }
@@ -3036,6 +3337,17 @@ void MainWindow::createStatusBar()                           //createStatusBar
   last_tx_label.setFrameStyle (QFrame::Panel | QFrame::Sunken);
   statusBar()->addWidget (&last_tx_label);
 
+  decoder_label.setAlignment (Qt::AlignCenter);
+  decoder_label.setMinimumSize (QSize {150, 18});
+  decoder_label.setFrameStyle (QFrame::Panel | QFrame::Sunken);
+  statusBar()->addWidget (&decoder_label);
+  decoder_label.hide ();        // only shown once the decoder has fallen behind
+
+  retention_label.setAlignment (Qt::AlignCenter);
+  retention_label.setMinimumSize (QSize {100, 18});
+  retention_label.setFrameStyle (QFrame::Panel | QFrame::Sunken);
+  statusBar()->addWidget (&retention_label);
+
   statusBar()->addPermanentWidget(&progressBar);
   progressBar.setMinimumSize (QSize {100, 18});
   progressBar.setFormat ("%v/%m");
@@ -3058,6 +3370,7 @@ void MainWindow::closeEvent(QCloseEvent * e)
   m_config.transceiver_offline ();
   writeSettings ();
   m_guiTimer.stop ();
+  m_memoryTimer.stop ();
   m_prefixes.reset ();
   m_shortcuts.reset ();
   m_mouseCmnds.reset ();
@@ -3095,96 +3408,6 @@ void MainWindow::on_actionCopyright_Notice_triggered()
   MessageBox::warning_message(this, message);
 }
 
-/**
- * @brief MainWindow::isDecodeReady
- *        determine if decoding is ready for a given submode
- * @param submode - submode to test
- * @param k - current frame count
- * @param k0 - previous frame count
- * @param pCurrentDecodeStart - input pointer to a static integer with the current decode start position
- * @param pNextDecodeStart - input pointer to a static integer with the next decode start position
- * @param pStart - output pointer to the next start position when decode is ready
- * @param pSz - output pointer to the next size when decode is ready
- * @param pCycle - output pointer to the next cycle when decode is ready
- * @return true if decode is ready for this submode, false otherwise
- */
-bool
-MainWindow::isDecodeReady(int    const submode,
-                          qint32 const k,
-                          qint32 const k0,
-                          qint32     * pCurrentDecodeStart,
-                          qint32     * pNextDecodeStart,
-                          qint32     * pStart,
-                          qint32     * pSz,
-                          qint32     * pCycle)
-{
-    if (pCurrentDecodeStart == nullptr ||
-        pNextDecodeStart    == nullptr)
-    {
-        return false;
-    }
-
-    qint32 const cycleFrames  = JS8::Submode::framesPerCycle(submode);
-    qint32 const framesNeeded = JS8::Submode::framesNeeded(submode);
-    qint32 const currentCycle = JS8::Submode::computeCycleForDecode(submode, k);
-    qint32 const delta        = qAbs(k - k0);
-
-    if(delta > cycleFrames){
-        if(JS8_DEBUG_DECODE) qDebug() << "-->" << JS8::Submode::name(submode) << "buffer advance delta" << delta;
-    }
-
-    // say, current decode start is 360000 and the next is 540000 (right before we loop)
-    // frames needed are 150000
-    // and then we turn off rx until k is 110000 and the cycle frames are 180000 and k0 is a proper 100000
-    // we need to still reset...
-    // so, if k is less than the last decode start - cycle frames (in this case 360000-180000, or 180000),
-    // then we should reset. but, what if k is now 182000??
-
-    // k=182000
-    // k < current (182000 < 360000) true
-    // k < max(0, current-cycleframes+framesNeeded) (k < 180000+150000) true
-
-    // k=6000
-    // k < current (6000<360000) true
-    // k < max(0, 360000-180000+150000) true
-
-    // k=350000
-    // k < current (350000<360000) true
-    // k < max(0, 360000-350000+150000) false
-
-    // are we in the space between the end of the last decode and the start of the next decode?
-    bool const deadAir = (k < *pCurrentDecodeStart &&
-                          k < qMax(0, *pCurrentDecodeStart-cycleFrames+framesNeeded));
-
-    // on buffer loop or init, prepare proper next decode start
-    if(
-        (deadAir)                    ||
-        (k < k0)                     ||
-        (delta > cycleFrames)        ||
-        (*pCurrentDecodeStart == -1) ||
-        (*pNextDecodeStart    == -1)
-    ){
-        *pCurrentDecodeStart = currentCycle * cycleFrames;
-        *pNextDecodeStart    = *pCurrentDecodeStart + cycleFrames;
-    }
-
-    bool const ready = *pCurrentDecodeStart + framesNeeded <= k;
-
-    if(ready){
-        if(JS8_DEBUG_DECODE) qDebug() << "-->" << JS8::Submode::name(submode) << "from" << *pCurrentDecodeStart << "to" << *pCurrentDecodeStart+framesNeeded << "k" << k << "k0" << k0;
-
-        if(pCycle) *pCycle = currentCycle;
-        if(pStart) *pStart = *pCurrentDecodeStart;
-        if(pSz)    *pSz    = qMax(framesNeeded, k-(*pCurrentDecodeStart));
-
-        *pCurrentDecodeStart = *pNextDecodeStart;
-        *pNextDecodeStart    = *pCurrentDecodeStart + cycleFrames;
-    }
-
-    return ready;
-}
-
-
 /**
  * @brief MainWindow::decode
  *        try decoding
@@ -3207,19 +3430,21 @@ bool MainWindow::decode(qint32 k){
         return false;
     }
 
-    bool ready = false;
+    // autosynced submodes are decoded every second rather than by cycle
+    for(auto submode : {Varicode::JS8CallSlow, Varicode::JS8CallNormal, Varicode::JS8CallFast, Varicode::JS8CallTurbo, Varicode::JS8CallUltra}){
+        m_decodeSchedule.setContinuous(submode, m_wideGraph->shouldAutoSyncSubmode(submode));
+    }
 
-#if JS8_USE_EXPERIMENTAL_DECODE_TIMING
-    ready = decodeEnqueueReady(k, kZero);
-    if(ready || !m_decoderQueue.isEmpty()){
-        if(JS8_DEBUG_DECODE) qDebug() << "--> decoder is ready to be run with" << m_decoderQueue.count() << "decode periods";
+    // nothing to do until the next decode window is due, unless we've
+    // windows waiting on the decoder
+    if(!m_decodeSchedule.due(k) && m_decoderQueue.isEmpty() && m_decoderBacklog.isEmpty()){
+        return false;
     }
-#else
-    ready = decodeEnqueueReadyExperiment(k, kZero);
+
+    bool ready = decodeEnqueueReady(k);
     if(ready || !m_decoderQueue.isEmpty()){
         if(JS8_DEBUG_DECODE) qDebug() << "--> decoder is ready to be run with" << m_decoderQueue.count() << "decode periods";
     }
-#endif
 
     //
     // TODO: what follows can likely be pulled out to an async process
@@ -3245,8 +3470,6 @@ bool MainWindow::decode(qint32 k){
         return false;
     }
 
-    // critical section (modifying dec_data)
-
     qint32 submode = -1;
     if(!decodeProcessQueue(&submode)){
         return false;
@@ -3259,235 +3482,406 @@ bool MainWindow::decode(qint32 k){
 
 /**
  * @brief MainWindow::decodeEnqueueReady
- *        compute the available decoder ranges that can be processed and
- *        place them in the decode queue
+ *        advance the decode schedule to the current frame count and
+ *        place any decoder ranges that have become ready in the decode
+ *        queue
  * @param k - the current frame count
- * @param k0 - the previous frame count
  * @return true if decoder ranges were queued, false otherwise
  */
-bool MainWindow::decodeEnqueueReady(qint32 k, qint32 k0){
-    // compute the next decode for each submode
-    // enqueue those decodes that are "ready"
-    // on an interval, issue a decode
+bool MainWindow::decodeEnqueueReady(qint32 k){
+    // do we have a better way to check this?
+    bool multi = ui->actionModeMultiDecoder->isChecked();
+
     int decodes = 0;
 
-    bool couldDecodeA = false;
-    qint32 startA = -1;
-    qint32 szA = -1;
-    qint32 cycleA = -1;
+    auto const now = DriftingDateTime::currentUtc();
 
-    bool couldDecodeB = false;
-    qint32 startB = -1;
-    qint32 szB = -1;
-    qint32 cycleB = -1;
+    foreach(auto const &window, m_decodeSchedule.advance(k)){
+        // skip if multi is disabled and this mode is not the current submode and we're not autosyncing this mode
+        if(!multi && window.submode != m_nSubMode && !m_wideGraph->shouldAutoSyncSubmode(window.submode)){
+            continue;
+        }
 
-    bool couldDecodeC = false;
-    qint32 startC = -1;
-    qint32 szC = -1;
-    qint32 cycleC = -1;
+        if(JS8_DEBUG_DECODE) qDebug() << JS8::Submode::name(window.submode) << "start" << window.start << "size" << window.sz << "k" << k;
 
-    bool couldDecodeE = false;
-    qint32 startE = -1;
-    qint32 szE = -1;
-    qint32 cycleE = -1;
+        DecodeParams d;
+        d.submode = window.submode;
+        d.start = window.start;
+        d.sz = window.sz;
+        d.utc = now;
+        m_decoderQueue.append(d);
+        decodes++;
+    }
 
-#if JS8_ENABLE_JS8I
-    bool couldDecodeI = false;
-    qint32 startI = -1;
-    qint32 szI = -1;
-    qint32 cycleI = -1;
-#endif
+    if(JS8_DEBUG_DECODE) qDebug() << "--> next decode due in" << m_decodeSchedule.framesUntilNext() << "frames";
 
-    static qint32 currentDecodeStartA = -1;
-    static qint32 nextDecodeStartA = -1;
-    if(JS8_DEBUG_DECODE) qDebug() << "? NORMAL   " << currentDecodeStartA << nextDecodeStartA;
-    couldDecodeA = isDecodeReady(Varicode::JS8CallNormal, k, k0, &currentDecodeStartA, &nextDecodeStartA, &startA, &szA, &cycleA);
+    return decodes > 0;
+}
 
-    static qint32 currentDecodeStartB = -1;
-    static qint32 nextDecodeStartB = -1;
-    if(JS8_DEBUG_DECODE) qDebug() << "? FAST     " << currentDecodeStartB << nextDecodeStartB;
-    couldDecodeB = isDecodeReady(Varicode::JS8CallFast, k, k0, &currentDecodeStartB, &nextDecodeStartB, &startB, &szB, &cycleB);
+/**
+ * @brief MainWindow::decodeBacklogAppend
+ *        hold on to a decode window that was skipped while the decoder
+ *        was busy, so that it can be decoded once the decoder catches up
+ * @param params - the skipped window
+ */
+void MainWindow::decodeBacklogAppend(DecodeParams const &params){
+    m_decodesSkipped++;
 
-    static qint32 currentDecodeStartC = -1;
-    static qint32 nextDecodeStartC = -1;
-    if(JS8_DEBUG_DECODE) qDebug() << "? TURBO    " << currentDecodeStartC << nextDecodeStartC;
-    couldDecodeC = isDecodeReady(Varicode::JS8CallTurbo, k, k0, &currentDecodeStartC, &nextDecodeStartC, &startC, &szC, &cycleC);
+    if(JS8_DEBUG_DECODE) qDebug() << "--> decoder skipped" << JS8::Submode::name(params.submode) << "window at" << params.start;
 
-    static qint32 currentDecodeStartE = -1;
-    static qint32 nextDecodeStartE = -1;
-    if(JS8_DEBUG_DECODE) qDebug() << "? SLOW     " << currentDecodeStartE << nextDecodeStartE;
-    couldDecodeE = isDecodeReady(Varicode::JS8CallSlow, k, k0, &currentDecodeStartE, &nextDecodeStartE, &startE, &szE, &cycleE);
+    // a later window for the same cycle covers an earlier one
+    m_decoderBacklog.removeIf([&params](auto const &backlogged){
+        return backlogged.submode == params.submode && backlogged.start == params.start;
+    });
 
-#if JS8_ENABLE_JS8I
-    static qint32 currentDecodeStartI = -1;
-    static qint32 nextDecodeStartI = -1;
-    if(JS8_DEBUG_DECODE) qDebug() << "? ULTRA    " << currentDecodeStartI << nextDecodeStartI;
-    couldDecodeI = isDecodeReady(Varicode::JS8CallUltra, k, k0, &currentDecodeStartI, &nextDecodeStartI, &startI, &szI, &cycleI);
-#endif
+    m_decoderBacklog.append(params);
 
-    if(couldDecodeA){
-        DecodeParams d;
-        d.submode = Varicode::JS8CallNormal;
-        d.start = startA;
-        d.sz = szA;
-        m_decoderQueue.append(d);
-        decodes++;
+    while(m_decoderBacklog.count() > Backlog::SIZE){
+        m_decoderBacklog.removeFirst();
+        m_decodesLost++;
     }
 
-    if(couldDecodeB){
-        DecodeParams d;
-        d.submode = Varicode::JS8CallFast;
-        d.start = startB;
-        d.sz = szB;
-        m_decoderQueue.append(d);
-        decodes++;
+    updateDecoderStatus();
+}
+
+/**
+ * @brief MainWindow::decodeBacklogTake
+ *        take the newest skipped decode window whose frames are still
+ *        held in the sample buffer, discarding any that are not
+ * @return the window, if there is one
+ */
+std::optional<MainWindow::DecodeParams> MainWindow::decodeBacklogTake(){
+    auto const now = DriftingDateTime::currentUtc();
+
+    // the buffer holds a minute; the frames of a window are overwritten once
+    // the detector comes back around to where it starts
+    auto const lost = m_decoderBacklog.removeIf([&now](auto const &backlogged){
+        auto const heldMs = qint64(JS8_RX_SAMPLE_SIZE - backlogged.sz) * 1000 / JS8_RX_SAMPLE_RATE;
+        return backlogged.utc.msecsTo(now) > heldMs - Backlog::MARGIN_MS;
+    });
+
+    m_decodesLost += static_cast<int>(lost);
+
+    std::optional<DecodeParams> params;
+
+    if(!m_decoderBacklog.isEmpty()){
+        params = m_decoderBacklog.takeLast();
+        m_decodesCaughtUp++;
     }
 
-    if(couldDecodeC){
-        DecodeParams d;
-        d.submode = Varicode::JS8CallTurbo;
-        d.start = startC;
-        d.sz = szC;
-        m_decoderQueue.append(d);
-        decodes++;
+    if(lost || params) updateDecoderStatus();
+
+    return params;
+}
+
+/**
+ * @brief MainWindow::decodeBacklogClear
+ *        discard skipped decode windows, which no longer refer to the
+ *        frames they did once the detector has been repositioned
+ */
+void MainWindow::decodeBacklogClear(){
+    if(m_decoderBacklog.isEmpty()) return;
+
+    m_decodesLost += m_decoderBacklog.count();
+    m_decoderBacklog.clear();
+
+    updateDecoderStatus();
+}
+
+/**
+ * @brief MainWindow::updateDecoderStatus
+ *        show the skipped and caught up decode window counts in the
+ *        status bar, once there's something to show
+ */
+void MainWindow::updateDecoderStatus(){
+    decoder_label.setText(QString("Skipped: %1 Caught up: %2").arg(m_decodesSkipped).arg(m_decodesCaughtUp));
+    decoder_label.setToolTip(QString("Decode windows skipped while the decoder was busy: %1\n"
+                                     "Skipped windows decoded later: %2\n"
+                                     "Skipped windows lost before they could be decoded: %3\n"
+                                     "Skipped windows waiting: %4")
+                             .arg(m_decodesSkipped)
+                             .arg(m_decodesCaughtUp)
+                             .arg(m_decodesLost)
+                             .arg(m_decoderBacklog.count()));
+    decoder_label.setVisible(m_decodesSkipped > 0);
+}
+
+/**
+ * @brief MainWindow::decodeHints
+ *        tell the decoder what we expect to hear, in part, and where; a
+ *        directed frame to us from the station we have selected, or from
+ *        any station that's recently sent to us, at the offset and in the
+ *        submode we last heard it
+ */
+void MainWindow::decodeHints(){
+    dec_data.params.nhints = 0;
+
+    if(!JS8_AP_DECODE) return;
+
+    // directed frames to a compound call carry a placeholder in its stead
+    auto const myCall = m_config.my_callsign();
+    bool portable = false;
+    auto const packedTo = Varicode::packCallsign(Varicode::isCompoundCallsign(myCall) ? "<....>" : myCall, &portable);
+    if(packedTo == 0) return;
+
+    auto const now = DriftingDateTime::currentUtc();
+    auto const selectedCall = callsignSelected();
+
+    for(auto const &cd : std::as_const(m_callActivity)){
+        if(dec_data.params.nhints == JS8_AP_MAX_HINTS) break;
+
+        bool const working = (cd.call == selectedCall) ||
+                             (cd.ackTimestamp.isValid() && cd.ackTimestamp.secsTo(now) <= Hints::MAX_AGE_SECS);
+
+        if(!working || cd.utcTimestamp.secsTo(now) > Hints::MAX_AGE_SECS) continue;
+        if(Varicode::isCompoundCallsign(cd.call)) continue;
+
+        auto const packedFrom = Varicode::packCallsign(cd.call, &portable);
+        if(packedFrom == 0) continue;
+
+        // [3][28][28] of the [3][28][28][5][8] directed frame
+        auto const bits = Varicode::intToBits(Varicode::FrameDirected, 3) +
+                          Varicode::intToBits(packedFrom, 28) +
+                          Varicode::intToBits(packedTo, 28);
+
+        auto &hint = dec_data.params.hints[dec_data.params.nhints++];
+        hint.submode = cd.submode;
+        hint.freq = cd.offset;
+        hint.mask = ~quint64{0} << (64 - bits.size());
+        hint.bits = Varicode::bitsToInt(bits) << (64 - bits.size());
     }
+}
 
-    if(couldDecodeE){
-        DecodeParams d;
-        d.submode = Varicode::JS8CallSlow;
-        d.start = startE;
-        d.sz = szE;
-        m_decoderQueue.append(d);
-        decodes++;
+/**
+ * @brief MainWindow::compactActivity
+ *        turn the compaction wheel a slot, applying the retention limits
+ *        to no more than a budget's worth of the map in that slot; the
+ *        selected call is always kept. The count cutoff is taken as a pass
+ *        over a map begins, and entries go by it only while the map is
+ *        still over its count limit
+ */
+void MainWindow::compactActivity(){
+    auto const now = DriftingDateTime::currentUtc().toMSecsSinceEpoch();
+    qsizetype removed = 0;
+
+    // an invalid time is the earliest there is, so anything without one goes first
+    auto const ms = [](UtcTime const utc){
+        return utc.toMSecsSinceEpoch();
+    };
+
+    switch(m_compactionSlot){
+    case 0: {
+        // by the most recent activity at an offset
+        auto &retention = m_retention[RetainedBandActivity];
+        auto &pass = m_bandActivityPass;
+        auto const last = [&ms](int, QList<ActivityDetail> const &activity){
+            return activity.isEmpty() ? std::numeric_limits<qint64>::min() : ms(activity.last().utcTimestamp);
+        };
+        auto const tooOld = ageCutoff(now, retainedAgeMins(RetainedBandActivity));
+        if(!pass.cursor) pass.tooMany = countCutoff(retention.maxCount, last, m_bandActivity);
+
+        removed = sweep(m_bandActivity, pass.cursor, Compaction::BUDGET, [&](int offset, QList<ActivityDetail> const &activity){
+            auto const stamp = last(offset, activity);
+            return stamp < tooOld || (stamp <= pass.tooMany && overCount(m_bandActivity.size(), retention.maxCount));
+        });
+        retention.dropped += removed;
+        break;
     }
 
-#if JS8_ENABLE_JS8I
-    if(couldDecodeI){
-        DecodeParams d;
-        d.submode = Varicode::JS8CallUltra;
-        d.start = startI;
-        d.sz = szI;
-        m_decoderQueue.append(d);
-        decodes++;
+    case 1: {
+        auto &retention = m_retention[RetainedCallActivity];
+        auto &pass = m_callActivityPass;
+        auto const last = [&ms](QString const &, CallDetail const &cd){ return ms(cd.utcTimestamp); };
+        auto const tooOld = ageCutoff(now, retainedAgeMins(RetainedCallActivity));
+        auto const selectedCall = callsignSelected();
+        if(!pass.cursor) pass.tooMany = countCutoff(retention.maxCount, last, m_callActivity);
+
+        removed = sweep(m_callActivity, pass.cursor, Compaction::BUDGET, [&](QString const &call, CallDetail const &cd){
+            auto const stamp = last(call, cd);
+            return call != selectedCall && (stamp < tooOld || (stamp <= pass.tooMany && overCount(m_callActivity.size(), retention.maxCount)));
+        });
+        retention.dropped += removed;
+        break;
+    }
+
+    case 2: {
+        // abandoned buffers are closed after a minute and a half regardless;
+        // this is a bound on how many can be open at once
+        auto &retention = m_retention[RetainedMessageBuffer];
+        auto &pass = m_messageBufferPass;
+        auto const last = [&ms](int, MessageBuffer const &buffer){
+            auto stamp = ms(buffer.cmd.utcTimestamp);
+            if(!buffer.compound.isEmpty()) stamp = std::max(stamp, ms(buffer.compound.last().utcTimestamp));
+            if(!buffer.msgs.isEmpty()) stamp = std::max(stamp, ms(buffer.msgs.last().utcTimestamp));
+            return stamp;
+        };
+        auto const tooOld = ageCutoff(now, retainedAgeMins(RetainedMessageBuffer));
+        if(!pass.cursor) pass.tooMany = countCutoff(retention.maxCount, last, m_messageBuffer);
+
+        removed = sweep(m_messageBuffer, pass.cursor, Compaction::BUDGET, [&](int freq, MessageBuffer const &buffer){
+            auto const stamp = last(freq, buffer);
+            return stamp < tooOld || (stamp <= pass.tooMany && overCount(m_messageBuffer.size(), retention.maxCount));
+        });
+        retention.dropped += removed;
+        break;
+    }
+
+    case 3:
+    case 4: {
+        // the heard graph isn't timestamped; calls go by the age of their
+        // call activity, those we've no activity for first, and the count
+        // limit is on both directions together
+        auto &retention = m_retention[RetainedHeardGraph];
+        auto &graph = m_compactionSlot == 3 ? m_heardGraphIncoming : m_heardGraphOutgoing;
+        auto &pass = m_compactionSlot == 3 ? m_heardGraphIncomingPass : m_heardGraphOutgoingPass;
+        auto const maxAgeMins = retainedAgeMins(RetainedHeardGraph);
+        auto const tooOld = ageCutoff(now, maxAgeMins);
+        auto const myCall = m_config.my_callsign();
+        auto const selectedCall = callsignSelected();
+        auto const last = [&](QString const &call, QSet<QString> const &){
+            if(call == myCall || call == selectedCall) return std::numeric_limits<qint64>::max();
+
+            auto const cd = m_callActivity.constFind(call);
+            return cd == m_callActivity.constEnd() ? std::numeric_limits<qint64>::min() : ms(cd->utcTimestamp);
+        };
+        if(!pass.cursor) pass.tooMany = countCutoff(retention.maxCount, last, m_heardGraphIncoming, m_heardGraphOutgoing);
+
+        removed = sweep(graph, pass.cursor, Compaction::BUDGET, [&](QString const &call, QSet<QString> const &heard){
+            if(call == myCall || call == selectedCall) return false;
+
+            auto const stamp = last(call, heard);
+            auto const tooMany = overCount(m_heardGraphIncoming.size() + m_heardGraphOutgoing.size(), retention.maxCount);
+
+            // without activity, a call's aged out of the call activity already
+            if(stamp == std::numeric_limits<qint64>::min() && maxAgeMins) return true;
+
+            return stamp < tooOld || (stamp <= pass.tooMany && tooMany);
+        });
+        retention.dropped += removed;
+        break;
+    }
     }
-#endif
 
-    return decodes > 0;
+    if(removed){
+        m_rxDisplayDirty = true;
+    }
+
+    m_compactionSlot = (m_compactionSlot + 1) % Compaction::SLOTS;
+
+    if(m_compactionSlot == 0){
+        updateRetentionStatus();
+    }
 }
 
 /**
- * @brief MainWindow::decodeEnqueueReadyExperiment
- *        compute the available decoder ranges that can be processed and
- *        place them in the decode queue
- *
- *        experiment with decoding on a much shorter interval than usual
- *
- * @param k - the current frame count
- * @param k0 - the previous frame count
- * @return true if decoder ranges were queued, false otherwise
+ * @brief MainWindow::retainedAgeMins
+ * @param retained
+ * @return the age, in minutes, beyond which entries go; that set in the
+ *         retention settings, or, for calls, the configured callsign
+ *         aging, past which they're neither shown, reported nor saved.
+ *         Band activity is reported whatever its age, so has no limit
+ *         by age unless one's set. 0 for no limit
+ */
+int MainWindow::retainedAgeMins(Retained retained) const {
+    if(auto const maxAgeMins = m_retention[retained].maxAgeMins) return maxAgeMins;
+
+    switch(retained){
+    case RetainedCallActivity:
+    case RetainedHeardGraph: return m_config.callsign_aging();
+    default:                 return 0;
+    }
+}
+
+/**
+ * @brief MainWindow::retainedSize
+ * @param retained
+ * @return the number of entries held in the structure
+ */
+qsizetype MainWindow::retainedSize(Retained retained) const {
+    switch(retained){
+    case RetainedBandActivity:  return m_bandActivity.size();
+    case RetainedCallActivity:  return m_callActivity.size();
+    case RetainedMessageBuffer: return m_messageBuffer.size();
+    case RetainedHeardGraph:    return m_heardGraphIncoming.size() + m_heardGraphOutgoing.size();
+    default:                    return 0;
+    }
+}
+
+/**
+ * @brief MainWindow::updateRetentionStatus
+ *        show the activity retained, and what's been dropped to stay
+ *        within the retention limits, in the status bar
  */
-bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
-    // TODO: make this non-static field of MainWindow?
-    // map of last decode positions for each submode
-    // static QMap<qint32, qint32> m_lastDecodeStartMap;
-
-    // TODO: make this non-static field of MainWindow?
-    // map of submodes to decode + optional alternate decode positions
-    static QMap<qint32, QList<qint32>> submodes = {
-        {Varicode::JS8CallSlow,   {0}},
-        {Varicode::JS8CallNormal, {0}},
-        {Varicode::JS8CallFast,   {0}}, // NORMAL: 0, 10, 20    --- ALT: 15, 25
-        {Varicode::JS8CallTurbo,  {0}}, // NORMAL: 0, 6, 12, 18 --- ALT: 15, 21, 27
-#if JS8_ENABLE_JS8I
-        {Varicode::JS8CallUltra,  {0}},
-#endif
+void MainWindow::updateRetentionStatus(){
+    static char const * const labels[RetainedCount] = {
+        "Band activity offsets",
+        "Calls heard",
+        "Open message buffers",
+        "Heard graph entries"
     };
 
-    static qint32 maxSamples       = JS8_RX_SAMPLE_SIZE;
-    static qint32 oneSecondSamples = JS8_RX_SAMPLE_RATE;
-
-    int decodes = 0;
-
-    // do we have a better way to check this?
-    bool multi = ui->actionModeMultiDecoder->isChecked();
+    qsizetype total = 0;
+    QStringList lines;
 
-    // do we need to process alternate positions?
-    bool skipAlt = true;
+    for(int i = 0; i < RetainedCount; i++){
+        auto const &retention = m_retention[i];
+        auto const size = retainedSize(static_cast<Retained>(i));
+        total += size;
 
-    foreach(auto submode, submodes.keys()){
-        // do we have a better way to check this?
-        bool everySecond = m_wideGraph->shouldAutoSyncSubmode(submode);
+        auto limits = QStringList{};
+        if(retention.maxCount) limits.append(QString("%1 max").arg(retention.maxCount));
+        if(auto const maxAgeMins = retainedAgeMins(static_cast<Retained>(i))) limits.append(QString("%1 min").arg(maxAgeMins));
 
-        // skip if multi is disabled and this mode is not the current submode and we're not autosyncing this mode
-        if(!everySecond && !multi && submode != m_nSubMode){
-            continue;
-        }
+        lines.append(QString("%1: %2 (%3), %4 dropped")
+                     .arg(labels[i])
+                     .arg(size)
+                     .arg(limits.isEmpty() ? QString("no limit") : limits.join(", "))
+                     .arg(retention.dropped));
+    }
 
-        // check all alternate decode positions
-        foreach(auto alt, submodes.value(submode)){
-            // skip alt decode positions if needed
-            if(skipAlt && alt != 0){
-                continue;
-            }
+    retention_label.setText(QString("Retained: %1").arg(total));
+    retention_label.setToolTip(lines.join("\n"));
+}
 
-            // skip alts if we are decoding every second
-            if(everySecond && alt != 0){
-                continue;
-            }
+/**
+ * @brief MainWindow::updateDisplayState
+ *        track whether the main window can be seen; while it can't, the
+ *        activity tables and signal meter are left alone, and on becoming
+ *        visible again the tables are brought up to date in one go. CPU
+ *        use in each state is logged as we leave it
+ */
+void MainWindow::updateDisplayState(){
+    auto const handle = windowHandle();
+    auto const state  = isMinimized()                                   ? DisplayState::Minimized
+                      : !isVisible() || !handle || !handle->isExposed() ? DisplayState::Hidden
+                      :                                                   DisplayState::Visible;
+
+    if(!m_displayStateTimer.isValid()){
+        m_displayStateTimer.start();
+        m_displayStateCpuMs = processCpuMs();
+        m_displayState = state;
+        return;
+    }
 
-            qint32 const cycle             = JS8::Submode::computeAltCycleForDecode(submode, k, alt*oneSecondSamples);
-            qint32 const cycleFrames       = JS8::Submode::framesPerCycle(submode);
-            qint32 const cycleFramesNeeded = JS8::Submode::framesForSymbols(submode); //computeFramesNeededForDecode(submode) - oneSecondSamples;
-            qint32       cycleFramesReady  = k - (cycle * cycleFrames);
-            if(cycleFramesReady < 0){
-                cycleFramesReady = k + (maxSamples - (cycle * cycleFrames));
-            }
+    if(state == m_displayState) return;
 
-            if(!m_lastDecodeStartMap.contains(submode)){
-                m_lastDecodeStartMap[submode] = cycle * cycleFrames;
-            }
+    auto const cpuMs  = processCpuMs();
+    auto const wallMs = m_displayStateTimer.restart();
 
-            qint32 lastDecodeStart = m_lastDecodeStartMap[submode];
-            qint32 incrementedBy = k - lastDecodeStart;
-            if(k < lastDecodeStart){
-                incrementedBy = maxSamples - lastDecodeStart + k;
-            }
+    if(wallMs > 0){
+        static char const * const names[] = { "visible", "hidden", "minimized" };
 
-            if(JS8_DEBUG_DECODE) qDebug() << JS8::Submode::name(submode) << "alt" << alt << "cycle" << cycle << "cycle frames" << cycleFrames << "cycle start" << cycle*cycleFrames << "cycle end" << (cycle+1)*cycleFrames << "k" << k << "frames ready" << cycleFramesReady << "incremeted by" << incrementedBy;
+        qDebug() << "display" << names[static_cast<int>(m_displayState)]
+                 << "for" << wallMs / 1000 << "s, cpu"
+                 << QString::number(100.0 * (cpuMs - m_displayStateCpuMs) / wallMs, 'f', 1) << "%";
+    }
 
-            if(everySecond && incrementedBy >= oneSecondSamples){
-                DecodeParams d;
-                d.submode = submode;
-                d.sz = cycleFrames;
-                d.start = k - d.sz;
-                if(d.start < 0){
-                    d.start += maxSamples;
-                }
-                m_decoderQueue.append(d);
-                decodes++;
+    m_displayStateCpuMs = cpuMs;
+    m_displayState = state;
 
-                // keep track of last decode position
-                m_lastDecodeStartMap[submode] = k;
-            }
-            else if(
-                (incrementedBy >= 1.5*oneSecondSamples && cycleFramesReady >= cycleFramesNeeded)                        || // within every 3/2 seconds for normal positions
-                (incrementedBy >= oneSecondSamples     && cycleFramesReady >= cycleFramesNeeded - 1.5*oneSecondSamples) || // within the last 3/2 seconds of a new cycle
-                (incrementedBy >= oneSecondSamples     && cycleFramesReady < 1.5*oneSecondSamples)                         // within the first 3/2 seconds of a new cycle
-            ){
-                DecodeParams d;
-                d.submode = submode;
-                d.start = cycle*cycleFrames;
-                d.sz = cycleFramesReady;
-                m_decoderQueue.append(d);
-                decodes++;
-
-                // keep track of last decode position
-                m_lastDecodeStartMap[submode] = k;
-            }
-        }
+    if(state == DisplayState::Visible){
+        displayActivity(true);
     }
-
-    return decodes > 0;
 }
 
 /**
@@ -3498,8 +3892,9 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
  * @return true if the decoder is ready to be run, false otherwise
  */
 bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
-    // critical section
-    QMutexLocker mutex(m_detector->getMutex());
+    // The detector only ever touches the frame buffer and the write position;
+    // the rest of the decode parameters are ours, so there's no need to hold
+    // up the audio thread while we fill them in.
 
     if(m_decoderBusy){
         int seconds = m_decoderBusyStartTime.secsTo(QDateTime::currentDateTimeUtc());
@@ -3514,26 +3909,21 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
         return false;
     }
 
-    if(m_decoderQueue.isEmpty()){
+    if(m_decoderQueue.isEmpty() && m_decoderBacklog.isEmpty()){
         if(JS8_DEBUG_DECODE) qDebug() << "--> decoder has nothing to process!";
         return false;
     }
 
     int submode = -1;
-    int maxDecodes = 1;
 
     bool multi = ui->actionModeMultiDecoder->isChecked();
-    if(multi){
-        maxDecodes = JS8_ENABLE_JS8I ? 5 : 4;
-    }
 
-    int count = m_decoderQueue.count();
-    if(count > maxDecodes){
-        if(JS8_DEBUG_DECODE) qDebug() << "--> decoder skipping at least 1 decode cycle" << "count" << count << "max" << maxDecodes;
-    }
-
-    // default to no submodes being decoded, then bitwise OR the modes together to decode them all at once
-    dec_data.params.nsubmodes = 0;
+    // a pass decodes one window per submode, so take the newest window for
+    // each; if the decoder was busy long enough for a submode to move on to
+    // a new cycle, the window for the cycle it left behind goes to the backlog
+    // rather than being lost. windows for the same cycle, and the windows of
+    // autosynced submodes, which overlap almost entirely, are superseded.
+    QMap<int, DecodeParams> pass;
 
     while(!m_decoderQueue.isEmpty()){
         auto params = m_decoderQueue.front();
@@ -3544,6 +3934,32 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
             continue;
         }
 
+        if(auto it = pass.constFind(params.submode); it != pass.constEnd()){
+            if(it->start != params.start && !m_wideGraph->shouldAutoSyncSubmode(params.submode)){
+                decodeBacklogAppend(*it);
+            }
+        }
+
+        pass.insert(params.submode, params);
+    }
+
+    // nothing new to decode, so catch up on a skipped window, if any; it's
+    // decoded on its own, as the results are reported as of when it was ready
+    m_decoderPassUtc = UtcTime{};
+
+    if(pass.isEmpty()){
+        if(auto params = decodeBacklogTake()){
+            if(JS8_DEBUG_DECODE) qDebug() << "--> decoder catching up" << JS8::Submode::name(params->submode) << "from" << params->utc;
+
+            m_decoderPassUtc = params->utc;
+            pass.insert(params->submode, *params);
+        }
+    }
+
+    // default to no submodes being decoded, then bitwise OR the modes together to decode them all at once
+    dec_data.params.nsubmodes = 0;
+
+    foreach(auto const &params, pass){
         if(submode == -1 || params.submode < submode){
             submode = params.submode;
         }
@@ -3585,16 +4001,25 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
     }
 
     dec_data.params.syncStats = (m_wideGraph->shouldDisplayDecodeAttempts() || m_wideGraph->isAutoSyncEnabled());
+    dec_data.params.energyGate = JS8_ENERGY_GATE;
+    dec_data.params.gateRecall = JS8_GATE_RECALL;
+    dec_data.params.syncPrune = JS8_SYNC_PRUNE;
+    dec_data.params.bpEarlyAbort = JS8_BP_EARLY_ABORT;
+    dec_data.params.bpRecall = JS8_BP_RECALL;
+    dec_data.params.osdDepth = JS8_OSD_DEPTH;
+    dec_data.params.osdBudget = JS8_OSD_BUDGET;
+    decodeHints();
     dec_data.params.newdat    = 1;
 
     auto const period_unsigned = JS8::Submode::period(submode);
     // Need to use a signed integer here,
     auto const period_signed = (int) period_unsigned;
     // as (2 - period_unsigned) results in an enourmeous number close to 2**32.
-    auto const t       = DriftingDateTime::currentDateTimeUtc().addSecs(2 - period_signed);
-    auto const ihr    = t.toString("hh").toInt();
-    auto const imin   = t.toString("mm").toInt();
-    auto const isec   = t.toString("ss").toInt();
+    auto const ready   = m_decoderPassUtc.isValid() ? m_decoderPassUtc : DriftingDateTime::currentUtc();
+    auto const t       = ready.addSecs(2 - period_signed);
+    auto const ihr    = t.hour();
+    auto const imin   = t.minute();
+    auto const isec   = t.second();
 
     dec_data.params.nutc = code_time(ihr, imin, isec - isec % period_unsigned);
     dec_data.params.nfqso = freq();
@@ -3612,14 +4037,11 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
 
 /**
  * @brief MainWindow::decodeStart
- *        copy the dec_data structure to shared memory and
- *        remove the lock file to start the decoding process
+ *        snapshot the decode parameters and hand them to the
+ *        decoder, which copies the frames to be decoded
  */
 void MainWindow::decodeStart()
 {
-  // critical section
-  QMutexLocker mutex(m_detector->getMutex());
-
   if (m_decoderBusy)
   {
     if(JS8_DEBUG_DECODE) qDebug() << "--> decoder cannot start...busy (busy flag)";
@@ -3631,17 +4053,28 @@ void MainWindow::decodeStart()
 
   decodeBusy(true);
 
+  // critical section; just long enough to take a consistent snapshot
+  // of the parameters, as the write position is the audio thread's
+
+  auto const params = [this]
+  {
+    QMutexLocker mutex(m_detector->getMutex());
+    return dec_data.params;
+  }();
+
   if(JS8_DEBUG_DECODE) qDebug() << "--> decoder starting";
-  if(JS8_DEBUG_DECODE) qDebug() << " --> kin:" << dec_data.params.kin;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> newdat:" << dec_data.params.newdat;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> nsubmodes:" << dec_data.params.nsubmodes;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> A:" << dec_data.params.kposA << dec_data.params.kposA + dec_data.params.kszA << QString("(%1)").arg(dec_data.params.kszA);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> B:" << dec_data.params.kposB << dec_data.params.kposB + dec_data.params.kszB << QString("(%1)").arg(dec_data.params.kszB);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> C:" << dec_data.params.kposC << dec_data.params.kposC + dec_data.params.kszC << QString("(%1)").arg(dec_data.params.kszC);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> E:" << dec_data.params.kposE << dec_data.params.kposE + dec_data.params.kszE << QString("(%1)").arg(dec_data.params.kszE);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> I:" << dec_data.params.kposI << dec_data.params.kposI + dec_data.params.kszI << QString("(%1)").arg(dec_data.params.kszI);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> kin:" << params.kin;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> newdat:" << params.newdat;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> nsubmodes:" << params.nsubmodes;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> A:" << params.kposA << params.kposA + params.kszA << QString("(%1)").arg(params.kszA);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> B:" << params.kposB << params.kposB + params.kszB << QString("(%1)").arg(params.kszB);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> C:" << params.kposC << params.kposC + params.kszC << QString("(%1)").arg(params.kszC);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> E:" << params.kposE << params.kposE + params.kszE << QString("(%1)").arg(params.kszE);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> I:" << params.kposI << params.kposI + params.kszI << QString("(%1)").arg(params.kszI);
 
-  m_decoder.decode();
+  // frames are copied outside of the critical section
+
+  m_decoder.decode(params);
 }
 
 /**
@@ -3671,17 +4104,16 @@ MainWindow::decodeBusy(bool b)                             //decodeBusy()
 void
 MainWindow::decodeDone()
 {
-  // critical section
-  QMutexLocker mutex(m_detector->getMutex());
-
   dec_data.params.newdat = false;
   m_RxLog                = 0;
 
   // cleanup old cached messages (messages > submode period old)
 
-  std::erase_if(m_messageDupeCache, [](auto const & it)
+  auto const now = UtcTime(QDateTime::currentMSecsSinceEpoch());
+
+  std::erase_if(m_messageDupeCache, [now](auto const & it)
   {
-    return it.second.secsTo(QDateTime::currentDateTimeUtc()) > JS8::Submode::period(it.first.submode);
+    return it.second.secsTo(now) > JS8::Submode::period(it.first.submode);
   });
 
   decodeBusy(false);
@@ -3842,16 +4274,19 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
         //       sorting the raw take from the initial selection pass.
 
         DecodedText   decodedtext(e);
+        auto const    decodedAt = m_decoderPassUtc.isValid()
+                                ? m_decoderPassUtc
+                                : DriftingDateTime::currentUtc();
         FrameCacheKey dedupeKey(decodedtext.submode(),
                                 decodedtext.frame());
 
         if (auto const it  = m_messageDupeCache.find(dedupeKey);
                        it != m_messageDupeCache.end())
         {
-            if (it->second.secsTo(QDateTime::currentDateTimeUtc()) < 0.5 * JS8::Submode::period(decodedtext.submode()))
+            if (it->second.secsTo(UtcTime(QDateTime::currentMSecsSinceEpoch())) < 0.5 * JS8::Submode::period(decodedtext.submode()))
             {
                 qDebug() << "duplicate frame at"
-                         << it->second
+                         << it->second.toDateTime()
                          << "using key"
                          << QString("%1:%2").arg(dedupeKey.submode)
                                             .arg(dedupeKey.frame);
@@ -3943,7 +4378,7 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
         }
 
         // if the frame is valid, cache it!
-        m_messageDupeCache.insert_or_assign(dedupeKey, QDateTime::currentDateTimeUtc());
+        m_messageDupeCache.insert_or_assign(dedupeKey, UtcTime(QDateTime::currentMSecsSinceEpoch()));
 
         // log valid frames to ALL.txt (and correct their timestamp format)
         auto freq = dialFrequency();
@@ -3953,7 +4388,7 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
             freq = m_decoderBusyFreq;
         }
 
-        auto date = DriftingDateTime::currentDateTimeUtc().toString("yyyy-MM-dd");
+        auto date = decodedAt.toDateTime().toString("yyyy-MM-dd");
         writeAllTxt(date + " " + decodedtext.string() + " " + decodedtext.message());
 
         ActivityDetail d = {};
@@ -3988,7 +4423,7 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
           d.dial = freq;
           d.offset = offset;
           d.text = decodedtext.message();
-          d.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+          d.utcTimestamp = decodedAt;
           d.snr = decodedtext.snr();
           d.isBuffered = false;
           d.submode = decodedtext.submode();
@@ -4022,26 +4457,21 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
         qDebug() << "decoded" << decodedtext.frameType() << decodedtext.isCompound() << decodedtext.isDirectedMessage() << decodedtext.isHeartbeat();
         bool shouldProcessCompound = true;
         if(shouldProcessCompound && decodedtext.isCompound() && !decodedtext.isDirectedMessage()){
-          cd.call = decodedtext.compoundCall();
-          cd.grid = decodedtext.extra(); // compound calls via pings may contain grid...
-          cd.snr = decodedtext.snr();
+          cd = Activity::compoundCall(decodedtext, m_strings);
           cd.dial = freq;
-          cd.offset = decodedtext.frequencyOffset();
-          cd.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
-          cd.bits = decodedtext.bits();
-          cd.submode = decodedtext.submode();
+          cd.utcTimestamp = decodedAt;
           cd.tdrift = m_wideGraph->shouldAutoSyncSubmode(d.submode) ? DriftingDateTime::drift()/1000.0 : decodedtext.dt();
 
           // Only respond to HEARTBEATS...remember that CQ messages are "Alt" pings
           if(decodedtext.isHeartbeat()){
               if(decodedtext.isAlt()){
                   // this is a cq with a standard or compound call, ala "KN4CRD/P: @ALLCALL CQ CQ CQ"
-                  cd.cqTimestamp = DriftingDateTime::currentDateTimeUtc();
+                  cd.cqTimestamp = decodedAt;
 
                   // convert CQ to a directed command and process...
                   cmd.from = cd.call;
-                  cmd.to = "@ALLCALL";
-                  cmd.cmd = " CQ";
+                  cmd.to = QStringLiteral("@ALLCALL");
+                  cmd.cmd = QStringLiteral(" CQ");
                   cmd.snr = cd.snr;
                   cmd.bits = cd.bits;
                   cmd.grid = cd.grid;
@@ -4065,8 +4495,8 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
               } else {
                   // convert HEARTBEAT to a directed command and process...
                   cmd.from = cd.call;
-                  cmd.to = "@HB";
-                  cmd.cmd = " HEARTBEAT";
+                  cmd.to = QStringLiteral("@HB");
+                  cmd.cmd = QStringLiteral(" HEARTBEAT");
                   cmd.snr = cd.snr;
                   cmd.bits = cd.bits;
                   cmd.grid = cd.grid;
@@ -4099,16 +4529,9 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
         if(shouldProcessDirected && decodedtext.isDirectedMessage()){
             auto parts = decodedtext.directedMessage();
 
-            cmd.from = parts.at(0);
-            cmd.to = parts.at(1);
-            cmd.cmd = parts.at(2);
+            cmd = Activity::directedCommand(decodedtext, m_strings);
             cmd.dial = freq;
-            cmd.offset = decodedtext.frequencyOffset();
-            cmd.snr = decodedtext.snr();
-            cmd.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
-            cmd.bits = decodedtext.bits();
-            cmd.extra = parts.length() > 2 ? parts.mid(3).join(" ") : "";
-            cmd.submode = decodedtext.submode();
+            cmd.utcTimestamp = decodedAt;
             cmd.tdrift = m_wideGraph->shouldAutoSyncSubmode(cmd.submode) ? DriftingDateTime::drift()/1000.0 : decodedtext.dt();
 
             // if the command is a buffered command and its not the last frame OR we have from or to in a separate message (compound call)
@@ -4117,16 +4540,8 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
 
               // log complete buffered callsigns immediately
               if(cmd.from != "<....>" && cmd.to != "<....>"){
-                  CallDetail cmdcd = {};
-                  cmdcd.call = cmd.from;
-                  cmdcd.bits = cmd.bits;
-                  cmdcd.snr = cmd.snr;
-                  cmdcd.dial = cmd.dial;
-                  cmdcd.offset = cmd.offset;
-                  cmdcd.utcTimestamp = cmd.utcTimestamp;
-                  cmdcd.ackTimestamp = cmd.to == m_config.my_callsign() ? cmd.utcTimestamp : QDateTime{};
-                  cmdcd.tdrift = cmd.tdrift;
-                  cmdcd.submode = cmd.submode;
+                  CallDetail cmdcd = Activity::caller(cmd);
+                  cmdcd.ackTimestamp = cmd.to == m_config.my_callsign() ? cmd.utcTimestamp : UtcTime{};
                   logCallActivity(cmdcd, false);
                   logHeardGraph(cmd.from, cmd.to);
               }
@@ -4244,23 +4659,7 @@ void MainWindow::logCallActivity(CallDetail d, bool spot){
         return;
     }
 
-    if(m_callActivity.contains(d.call)){
-        // update (keep grid)
-        CallDetail old = m_callActivity[d.call];
-        if(d.grid.isEmpty() && !old.grid.isEmpty()){
-            d.grid = old.grid;
-        }
-        if(!d.ackTimestamp.isValid() && old.ackTimestamp.isValid()){
-            d.ackTimestamp = old.ackTimestamp;
-        }
-        if(!d.cqTimestamp.isValid() && old.cqTimestamp.isValid()){
-            d.cqTimestamp = old.cqTimestamp;
-        }
-        m_callActivity[d.call] = d;
-    } else {
-        // create
-        m_callActivity[d.call] = d;
-
+    if(Activity::logCall(m_callActivity, d, m_strings)){
         // notification of old and new callsigns
         if(m_logBook.hasWorkedBefore(d.call, "")){
             tryNotify("call_old");
@@ -4705,8 +5104,8 @@ void MainWindow::guiUpdate()
 
     m_sec0=nsec;
 
-    // once per period
-    if(m_sec0 % m_TRperiod == 0){
+    // once per period, if a band hop is waiting on us
+    if(m_bandHopPending && m_sec0 % m_TRperiod == 0){
         tryBandHop();
     }
 
@@ -4736,8 +5135,14 @@ void MainWindow::guiUpdate()
         // process outgoing tx queue...
         processTxQueue();
 
-        // once processed, lets update the display...
-        displayActivity(forceDirty);
+        // once processed, lets update the display, if anyone can see it...
+        updateDisplayState();
+
+        if(m_displayState == DisplayState::Visible){
+            displayActivity(forceDirty);
+        } else if(forceDirty){
+            m_rxDisplayDirty = true;
+        }
         updateButtonDisplay();
         updateTextDisplay();
     }
@@ -4899,6 +5304,7 @@ void MainWindow::clearActivity(){
 
     m_callSeenHeartbeat.clear();
     m_compoundCallCache.clear();
+    m_strings.clear();
     m_rxCallCache.clear();
     m_rxCallQueue.clear();
     m_rxRecentCache.clear();
@@ -4958,12 +5364,12 @@ void MainWindow::clearCallActivity(){
 
 void MainWindow::createGroupCallsignTableRows(QTableWidget *table, QString const &selectedCall, bool &showIconColumn){
     int count = 0;
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
     int callsignAging = m_config.callsign_aging();
 
     int startCol = 1;
 
-    foreach(auto cd, m_callActivity.values()){
+    for(auto const &cd : std::as_const(m_callActivity)){
         if (cd.call.trimmed().isEmpty()){
             continue;
         }
@@ -5576,7 +5982,7 @@ MainWindow::isFreqOffsetFree(int const f,
   // it's free. If it's an occupied slot within the bandwidth of where
   // we'd like to transmit, then it's not free.
 
-  auto const now = DriftingDateTime::currentDateTimeUtc();
+  auto const now = DriftingDateTime::currentUtc();
 
   for (auto [offset, activity] : m_bandActivity.asKeyValueRange())
   {
@@ -5755,7 +6161,7 @@ void MainWindow::on_logQSOButton_clicked()                 //Log QSO button
 {
   QString call = callsignSelected();
   if(m_callSelectedTime.contains(call)){
-    m_dateTimeQSOOn = m_callSelectedTime[call];
+    m_dateTimeQSOOn = m_callSelectedTime[call].toDateTime();
   }
   if (!m_dateTimeQSOOn.isValid ()) {
     m_dateTimeQSOOn = DriftingDateTime::currentDateTimeUtc();
@@ -5797,7 +6203,7 @@ void MainWindow::acceptQSO (QDateTime const& QSO_date_off, QString const& call,
                             , QString const& my_call, QString const& my_grid, QByteArray const& ADIF, QVariantMap const &additionalFields)
 {
   QString date = QSO_date_on.toString("yyyyMMdd");
-  m_logBook.addAsWorked (m_hisCall, m_config.bands ()->find (m_freqNominal), mode, submode, grid, date, name, comments);
+  m_logBook.addAsWorked (m_hisCall, m_config.bands ()->find (m_freqNominal), mode, submode, grid, date, name, comments, ADIF);
 
   // Log to JS8Call API
   if(canSendNetworkMessage()){
@@ -5823,16 +6229,7 @@ void MainWindow::acceptQSO (QDateTime const& QSO_date_off, QString const& call,
 
   // Log to N1MM Logger
   if (m_config.broadcast_to_n1mm() && m_config.valid_n1mm_info())  {
-    const QHostAddress n1mmhost = QHostAddress(m_config.n1mm_server_name());
-    QUdpSocket _sock;
-    auto rzult = _sock.writeDatagram (ADIF + " <eor>", n1mmhost, quint16(m_config.n1mm_server_port()));
-    if (rzult == -1) {
-      bool hidden = m_logDlg->isHidden();
-      m_logDlg->setHidden(true);
-      MessageBox::warning_message (this, tr ("Error sending log to N1MM"),
-                                   tr ("Write returned \"%1\"").arg (rzult));
-      m_logDlg->setHidden(hidden);
-    }
+    Q_EMIT logDispatcherEnqueue(LogDispatcher::N1MM, m_config.n1mm_server_name(), quint16(m_config.n1mm_server_port()), ADIF + " <eor>");
   }
 
   // Log to N3FJP Logger
@@ -5890,26 +6287,9 @@ void MainWindow::acceptQSO (QDateTime const& QSO_date_off, QString const& call,
       }
       data = data.arg(additional.join(""));
 
-      auto host = m_config.n3fjp_server_name();
-      auto port = m_config.n3fjp_server_port();
-
-      if(m_n3fjpClient->sendNetworkMessage(host, port, data.toLocal8Bit(), true, 500)){
-          QTimer::singleShot(300, this, [this, host, port](){
-            m_n3fjpClient->sendNetworkMessage(host, port, "<CMD><CHECKLOG></CMD>", true, 100);
-            m_n3fjpClient->sendNetworkMessage(host, port, "\r\n", true, 100);
-          });
-      } else {
-          bool hidden = m_logDlg->isHidden();
-          m_logDlg->setHidden(true);
-          MessageBox::warning_message (this, tr ("Error sending log to N3FJP"),
-                                       tr ("Write failed for \"%1:%2\"").arg (host).arg(port));
-          m_logDlg->setHidden(hidden);
-      }
+      Q_EMIT logDispatcherEnqueue(LogDispatcher::N3FJP, m_config.n3fjp_server_name(), quint16(m_config.n3fjp_server_port()), data.toLocal8Bit());
   }
 
-  // reload the logbook data
-  m_logBook.init();
-
   clearCallsignSelected();
 
   displayCallActivity();
@@ -6049,7 +6429,6 @@ MainWindow::setupJS8()
   m_wideGraph->setFilterMinimumBandwidth(JS8::Submode::bandwidth(m_nSubMode) +
                                          JS8::Submode::rxThreshold(m_nSubMode) * 2);
 
-  enable_DXCC_entity (m_config.DXCC ());
   m_config.frequencies ()->filter (m_config.region (), Mode::JS8);
   m_FFTSize = JS8_NSPS / 2;
   Q_EMIT FFTSize (m_FFTSize);
@@ -6094,7 +6473,8 @@ void MainWindow::on_actionErase_js8call_log_adi_triggered()
     QFile f {m_config.writeable_data_dir ().absoluteFilePath ("js8call_log.adi")};
     f.remove();
 
-    m_logBook.init();
+    m_logBook = LogBook {};    // nothing's been worked now; cty.dat follows
+    loadLogBook();
   }
 }
 
@@ -6117,10 +6497,263 @@ void MainWindow::band_changed ()
 
 void MainWindow::enable_DXCC_entity (bool /*on*/)
 {
-  m_logBook.init();                        // re-read the log and cty.dat files
+  loadLogBook();                           // re-read the log and cty.dat files
   updateGeometry ();
 }
 
+/**
+ * @brief MainWindow::loadLogBook
+ *        Re-read the log and cty.dat to the side, and swap the result in
+ *        when it's ready; the log book we have answers queries until then.
+ *        A load that's been overtaken by another is discarded.
+ */
+void MainWindow::loadLogBook()
+{
+  auto const load = ++m_logBookLoads;
+
+  m_logBookLoader.start([this, load]()
+  {
+    auto const logBook = std::make_shared<LogBook>();
+
+    logBook->init();
+
+    QMetaObject::invokeMethod(this, [this, load, logBook]()
+    {
+      if (load != m_logBookLoads) return;
+
+      m_logBook.replaceWith(std::move(*logBook));
+      displayCallActivity();
+    }, Qt::QueuedConnection);
+  });
+}
+
+void MainWindow::showStartupTimeline()
+{
+  auto dialog = new QDialog(this);
+  auto text   = new QPlainTextEdit(m_startup.toText(), dialog);
+  auto box    = new QDialogButtonBox(QDialogButtonBox::Save | QDialogButtonBox::Close, dialog);
+  auto layout = new QVBoxLayout(dialog);
+
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->setWindowTitle(tr("Startup Timeline"));
+  text->setReadOnly(true);
+  text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  text->setMinimumWidth(text->fontMetrics().horizontalAdvance(QChar('0')) * 60);
+  layout->addWidget(text);
+  layout->addWidget(box);
+
+  connect(box, &QDialogButtonBox::rejected, dialog, &QDialog::close);
+  connect(box, &QDialogButtonBox::accepted, dialog, [this, dialog]()
+  {
+    auto const path = QFileDialog::getSaveFileName(dialog,
+                                                   tr("Export Startup Timeline"),
+                                                   m_config.writeable_data_dir().absoluteFilePath("startup-timeline.json"),
+                                                   tr("JSON files (*.json);; All files (*)"));
+    if (path.isEmpty()) return;
+
+    if (!m_startup.save(path))
+    {
+      MessageBox::warning_message(dialog, tr("Export Startup Timeline"),
+                                  tr("Unable to write \"%1\"").arg(path));
+    }
+  });
+
+  dialog->show();
+}
+
+/**
+ * @brief MainWindow::addMemoryAccounts
+ *        register the major caches and containers with memory accounting,
+ *        in the order in which they're to be listed
+ */
+void MainWindow::addMemoryAccounts(){
+    using Usage = MemoryAccounting::Usage;
+
+    auto constexpr MAP_NODE = MemoryAccounting::MAP_NODE;
+    auto constexpr HASH_NODE = MemoryAccounting::HASH_NODE;
+
+    auto const heap = [](QString const &string){
+        return MemoryAccounting::heap(string);
+    };
+
+    auto const activityBytes = [heap](ActivityDetail const &d) -> qsizetype {
+        return sizeof(ActivityDetail) + heap(d.text);
+    };
+
+    auto const callBytes = [heap](CallDetail const &cd) -> qsizetype {
+        return sizeof(CallDetail) + heap(cd.call) + heap(cd.through) + heap(cd.grid);
+    };
+
+    auto const commandBytes = [heap](CommandDetail const &cmd) -> qsizetype {
+        return sizeof(CommandDetail) + heap(cmd.from) + heap(cmd.to) + heap(cmd.cmd) + heap(cmd.grid)
+                                     + heap(cmd.text) + heap(cmd.extra) + heap(cmd.relayPath);
+    };
+
+    auto const bandActivityUsage = [activityBytes](BandActivity const &bandActivity){
+        Usage usage;
+        for(auto const &activity : bandActivity){
+            usage.bytes += MAP_NODE + sizeof(int) + sizeof(QList<ActivityDetail>);
+            for(auto const &d : activity){
+                usage.count++;
+                usage.bytes += activityBytes(d);
+            }
+        }
+        return usage;
+    };
+
+    auto const callActivityUsage = [heap, callBytes](QMap<QString, CallDetail> const &callActivity){
+        Usage usage;
+        for(auto it = callActivity.constBegin(); it != callActivity.constEnd(); ++it){
+            usage.count++;
+            usage.bytes += MAP_NODE + sizeof(QString) + heap(it.key()) + callBytes(it.value());
+        }
+        return usage;
+    };
+
+    auto const heardGraphUsage = [heap](QMap<QString, QSet<QString>> const &graph){
+        Usage usage;
+        for(auto it = graph.constBegin(); it != graph.constEnd(); ++it){
+            usage.count++;
+            usage.bytes += MAP_NODE + sizeof(QString) + sizeof(QSet<QString>) + heap(it.key());
+            for(auto const &call : it.value()){
+                usage.bytes += HASH_NODE + sizeof(QString) + heap(call);
+            }
+        }
+        return usage;
+    };
+
+    m_memory.add("Band activity", [this, bandActivityUsage](){
+        return bandActivityUsage(m_bandActivity);
+    });
+
+    m_memory.add("Call activity", [this, callActivityUsage](){
+        return callActivityUsage(m_callActivity);
+    });
+
+    m_memory.add("Heard graph", [this, heardGraphUsage](){
+        auto usage = heardGraphUsage(m_heardGraphIncoming);
+        usage += heardGraphUsage(m_heardGraphOutgoing);
+        return usage;
+    });
+
+    m_memory.add("Message buffers", [this, activityBytes, callBytes, commandBytes](){
+        Usage usage;
+        for(auto const &buffer : std::as_const(m_messageBuffer)){
+            usage.count += 1 + buffer.compound.size() + buffer.msgs.size();
+            usage.bytes += MAP_NODE + sizeof(int) + sizeof(MessageBuffer) - sizeof(CommandDetail) + commandBytes(buffer.cmd);
+            for(auto const &cd : buffer.compound) usage.bytes += callBytes(cd);
+            for(auto const &d : buffer.msgs) usage.bytes += activityBytes(d);
+        }
+        return usage;
+    });
+
+    m_memory.add("RX queues", [this, activityBytes, callBytes, commandBytes](){
+        Usage usage;
+        usage.count = m_rxActivityQueue.size() + m_rxCommandQueue.size() + m_rxCallQueue.size();
+        for(auto const &d : m_rxActivityQueue) usage.bytes += activityBytes(d);
+        for(auto const &cmd : m_rxCommandQueue) usage.bytes += commandBytes(cmd);
+        for(auto const &cd : m_rxCallQueue) usage.bytes += callBytes(cd);
+        return usage;
+    });
+
+    // activity set aside on changing bands, to be restored on returning
+    m_memory.add("Band caches", [this, heap, bandActivityUsage, callActivityUsage, heardGraphUsage](){
+        Usage usage;
+        for(auto const &bandActivity : std::as_const(m_bandActivityBandCache)) usage += bandActivityUsage(bandActivity);
+        for(auto const &callActivity : std::as_const(m_callActivityBandCache)) usage += callActivityUsage(callActivity);
+        for(auto const &graph : std::as_const(m_heardGraphIncomingBandCache)) usage += heardGraphUsage(graph);
+        for(auto const &graph : std::as_const(m_heardGraphOutgoingBandCache)) usage += heardGraphUsage(graph);
+        for(auto const &text : std::as_const(m_rxTextBandCache)) usage += Usage{1, heap(text)};
+        return usage;
+    });
+
+    m_memory.add("RX text", [this](){
+        auto const document = ui->textEditRX->document();
+        return Usage{document->blockCount(),
+                     document->characterCount() * qsizetype(sizeof(QChar)) + document->blockCount() * Memory::TEXT_BLOCK};
+    });
+
+    m_memory.add("Waterfall replot", [this](){
+        return m_wideGraph->replotUsage();
+    });
+
+    m_memory.add("Duplicate cache", [this, heap](){
+        Usage usage;
+        usage.count = m_messageDupeCache.size();
+        usage.bytes = m_messageDupeCache.bucket_count() * sizeof(void *);
+        for(auto const &[key, date] : m_messageDupeCache){
+            usage.bytes += 2 * sizeof(void *) + sizeof(FrameCacheKey) + sizeof(UtcTime) + heap(key.frame);
+        }
+        return usage;
+    });
+
+    m_memory.add("Inbox counts", [this, heap](){
+        Usage usage;
+        for(auto it = m_rxInboxCountCache.constBegin(); it != m_rxInboxCountCache.constEnd(); ++it){
+            usage.count++;
+            usage.bytes += MAP_NODE + sizeof(QString) + sizeof(int) + heap(it.key());
+        }
+        return usage;
+    });
+
+    m_memory.add("Interned strings", [this](){
+        return m_strings.usage();
+    });
+
+    m_memory.add("JSC lookup cache", &JSC::lookupCacheUsage);
+    m_memory.add("Geodesic cache", &Geodesic::cacheUsage);
+
+    // lives on the network thread; reports what it had as of its last change
+    m_memory.add("PSK Reporter", [this](){
+        return m_pskReporter->usage();
+    });
+
+    m_memory.sample();
+}
+
+/**
+ * @brief MainWindow::sampleMemory
+ *        sample memory accounting, keeping its high-water marks up to date,
+ *        and log it every so often, if we've been asked to
+ */
+void MainWindow::sampleMemory(){
+    m_memory.sample();
+    m_memorySamples++;
+
+    if(m_memoryLogInterval > 0 && m_memorySamples % std::max(1, m_memoryLogInterval * 60000 / Memory::SAMPLE_MS) == 0){
+        qDebug().noquote() << "memory usage after" << m_memorySamples * Memory::SAMPLE_MS / 60000 << "minutes\n" << m_memory.toText();
+    }
+}
+
+void MainWindow::showMemoryUsage()
+{
+  auto dialog  = new QDialog(this);
+  auto text    = new QPlainTextEdit(dialog);
+  auto box     = new QDialogButtonBox(QDialogButtonBox::Close, dialog);
+  auto refresh = box->addButton(tr("Refresh"), QDialogButtonBox::ActionRole);
+  auto layout  = new QVBoxLayout(dialog);
+
+  auto const update = [this, text]()
+  {
+    m_memory.sample();
+    text->setPlainText(m_memory.toText());
+  };
+
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->setWindowTitle(tr("Memory Usage"));
+  text->setReadOnly(true);
+  text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  text->setMinimumWidth(text->fontMetrics().horizontalAdvance(QChar('0')) * 76);
+  layout->addWidget(text);
+  layout->addWidget(box);
+
+  connect(box, &QDialogButtonBox::rejected, dialog, &QDialog::close);
+  connect(refresh, &QPushButton::clicked, dialog, update);
+
+  update();
+  dialog->show();
+}
+
 void MainWindow::buildFrequencyMenu(QMenu *menu){
     auto custom = menu->addAction("Set a Custom Frequency...");
 
@@ -6398,7 +7031,7 @@ void MainWindow::on_snrMacroButton_clicked(){
         return;
     }
 
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
     int callsignAging = m_config.callsign_aging();
     if(!m_callActivity.contains(call)){
         return;
@@ -6970,9 +7603,9 @@ void MainWindow::buildQueryMenu(QMenu * menu, QString call){
 }
 
 void MainWindow::buildRelayMenu(QMenu *menu){
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
     int callsignAging = m_config.callsign_aging();
-    foreach(auto cd, m_callActivity.values()){
+    for(auto const &cd : std::as_const(m_callActivity)){
         if (callsignAging && cd.utcTimestamp.secsTo(now) / 60 >= callsignAging) {
             continue;
         }
@@ -7015,7 +7648,7 @@ void MainWindow::buildEditMenu(QMenu *menu, QTextEdit *edit){
 }
 
 QMap<QString, QString> MainWindow::buildMacroValues(){
-    auto lastActive = DriftingDateTime::currentDateTimeUtc().addSecs(-m_idleMinutes*60);
+    auto lastActive = DriftingDateTime::currentUtc().addSecs(-m_idleMinutes*60);
     QString myIdle = since(lastActive).toUpper().replace("NOW", "0M");
     QString myVersion = version().replace("-devel", "").replace("-rc", "");
 
@@ -7184,8 +7817,8 @@ void MainWindow::on_tableWidgetRXAll_cellDoubleClicked(int row, int col){
 
     // print the history in the main window...
     int activityAging = m_config.activity_aging();
-    QDateTime now = DriftingDateTime::currentDateTimeUtc();
-    QDateTime firstActivity = now;
+    auto now = DriftingDateTime::currentUtc();
+    auto firstActivity = now;
     QString activityText;
     bool isLast = false;
     foreach(auto d, m_bandActivity[offset]){
@@ -7203,7 +7836,7 @@ void MainWindow::on_tableWidgetRXAll_cellDoubleClicked(int row, int col){
         }
     }
     if(!activityText.isEmpty()){
-        displayTextForFreq(activityText, offset, firstActivity, false, true, isLast);
+        displayTextForFreq(activityText, offset, firstActivity.toDateTime(), false, true, isLast);
     }
 }
 
@@ -7249,13 +7882,9 @@ void MainWindow::on_tableWidgetCalls_cellDoubleClicked(int row, int col){
 
         Inbox i(inboxPath());
         if(i.open()){
-            QList<Message> msgs;
-            foreach(auto pair, i.values("UNREAD", "$.params.FROM", call, 0, 1000)){
-                msgs.append(pair.second);
-            }
-
             auto mw = new MessageWindow(this);
-            mw->populateMessages(msgs);
+            mw->setCall(call);
+            mw->showInbox(inboxPath(), {});
             mw->show();
 
             auto pair = i.firstUnreadFrom(call);
@@ -7274,8 +7903,9 @@ void MainWindow::on_tableWidgetCalls_cellDoubleClicked(int row, int col){
             d.tdrift = params.value("TDRIFT").toFloat();
             d.text = params.value("TEXT").toString();
             d.to = params.value("TO").toString();
-            d.utcTimestamp = QDateTime::fromString(params.value("UTC").toString(), "yyyy-MM-dd hh:mm:ss");
-            d.utcTimestamp.setUtcOffset(0);
+            auto utc = QDateTime::fromString(params.value("UTC").toString(), "yyyy-MM-dd hh:mm:ss");
+            utc.setUtcOffset(0);
+            d.utcTimestamp = UtcTime::fromDateTime(utc);
 
             msg.setType("READ");
             i.set(id, msg);
@@ -7472,6 +8102,8 @@ void MainWindow::drifted(int /*prev*/, int /*cur*/){
     // here we reset the buffer position without clearing the buffer
     // this makes the detected emit the correct k when drifting time
     m_detector->resetBufferPosition();
+    m_decodeSchedule.reset();
+    decodeBacklogClear();
 }
 
 void MainWindow::setFreqOffsetForRestore(int freq, bool shouldRestore){
@@ -8049,7 +8681,7 @@ void MainWindow::callsignSelectedChanged(QString /*old*/, QString selectedCall){
 
         // when we select a callsign, use it as the qso start time
         if(!m_callSelectedTime.contains(selectedCall)){
-            m_callSelectedTime[selectedCall] = DriftingDateTime::currentDateTimeUtc();
+            m_callSelectedTime[selectedCall] = DriftingDateTime::currentUtc();
         }
 
         if(m_config.heartbeat_qso_pause()){
@@ -8097,19 +8729,20 @@ bool MainWindow::isRecentOffset(int submode, int offset){
     }
     return (
         m_rxRecentCache.contains(offset/10*10) &&
-        m_rxRecentCache[offset/10*10]->secsTo(DriftingDateTime::currentDateTimeUtc()) < 120
+        m_rxRecentCache[offset/10*10]->secsTo(DriftingDateTime::currentUtc()) < 120
     );
 }
 
 void MainWindow::markOffsetRecent(int offset){
-    m_rxRecentCache.insert(offset/10*10, new QDateTime(DriftingDateTime::currentDateTimeUtc()), 10);
-    m_rxRecentCache.insert(offset/10*10+10, new QDateTime(DriftingDateTime::currentDateTimeUtc()), 10);
+    auto const now = DriftingDateTime::currentUtc();
+    m_rxRecentCache.insert(offset/10*10, new UtcTime(now), 10);
+    m_rxRecentCache.insert(offset/10*10+10, new UtcTime(now), 10);
 }
 
 bool MainWindow::isDirectedOffset(int offset, bool *pIsAllCall){
     bool isDirected = (
         m_rxDirectedCache.contains(offset/10*10) &&
-        m_rxDirectedCache[offset/10*10]->date.secsTo(DriftingDateTime::currentDateTimeUtc()) < 120
+        m_rxDirectedCache[offset/10*10]->date.secsTo(DriftingDateTime::currentUtc()) < 120
     );
 
     if (isDirected && pIsAllCall) {
@@ -8120,8 +8753,9 @@ bool MainWindow::isDirectedOffset(int offset, bool *pIsAllCall){
 }
 
 void MainWindow::markOffsetDirected(int offset, bool isAllCall){
-    CachedDirectedType *d1 = new CachedDirectedType{ isAllCall, DriftingDateTime::currentDateTimeUtc() };
-    CachedDirectedType *d2 = new CachedDirectedType{ isAllCall, DriftingDateTime::currentDateTimeUtc() };
+    auto const now = DriftingDateTime::currentUtc();
+    CachedDirectedType *d1 = new CachedDirectedType{ isAllCall, now };
+    CachedDirectedType *d2 = new CachedDirectedType{ isAllCall, now };
     m_rxDirectedCache.insert(offset/10*10,    d1, 10);
     m_rxDirectedCache.insert(offset/10*10+10, d2, 10);
 }
@@ -8192,7 +8826,7 @@ void MainWindow::setDrift(int n){
 void
 MainWindow::processIdleActivity()
 {
-  auto const now = DriftingDateTime::currentDateTimeUtc();
+  auto const now = DriftingDateTime::currentUtc();
 
   // if we detect an idle offset, insert an ellipsis into the activity queue and band activity
 
@@ -8327,7 +8961,7 @@ void MainWindow::processRxActivity() {
         }
 
         // log it to the display!
-        displayTextForFreq(d.text, d.offset, d.utcTimestamp, false, isFirst, isLast);
+        displayTextForFreq(d.text, d.offset, d.utcTimestamp.toDateTime(), false, isFirst, isLast);
 
         // if we've received a message to be displayed, we should bump the repeat buttons...
         resetAutomaticIntervalTransmissions(true, false);
@@ -8359,7 +8993,7 @@ void MainWindow::processRxActivity() {
             continue;
         }
 
-        auto now = DriftingDateTime::currentDateTimeUtc();
+        auto now = DriftingDateTime::currentUtc();
         if(last.utcTimestamp.secsTo(now) < m_TRperiod){
             continue;
         }
@@ -8477,7 +9111,8 @@ MainWindow::processBufferedActivity()
 
         // check to make sure we empty old buffers by getting the latest timestamp
         // and checking to see if it's older than one minute.
-        auto dt = DriftingDateTime::currentDateTimeUtc().addDays(-1);
+        auto const now = DriftingDateTime::currentUtc();
+        auto dt = now.addSecs(-24 * 60 * 60);
         if(buffer.cmd.utcTimestamp.isValid()){
             dt = qMax(dt, buffer.cmd.utcTimestamp);
         }
@@ -8489,12 +9124,12 @@ MainWindow::processBufferedActivity()
         }
 
         // if the buffer has messages older than 1 minute, and we still haven't closed it, let's mark it as the last frame
-        if(dt.secsTo(DriftingDateTime::currentDateTimeUtc()) > 60 && !buffer.msgs.isEmpty()){
+        if(dt.secsTo(now) > 60 && !buffer.msgs.isEmpty()){
             buffer.msgs.last().bits |= Varicode::JS8CallLast;
         }
 
         // but, if the buffer is older than 1.5 minutes, and we still haven't closed it, just remove it and skip
-        if(dt.secsTo(DriftingDateTime::currentDateTimeUtc()) > 90){
+        if(dt.secsTo(now) > 90){
             m_messageBuffer.remove(freq);
             continue;
         }
@@ -8574,7 +9209,7 @@ void MainWindow::processCommandActivity() {
     int f = currentFreq();
 #endif
 
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
 
     while (!m_rxCommandQueue.isEmpty()) {
         auto d = m_rxCommandQueue.dequeue();
@@ -8599,17 +9234,8 @@ void MainWindow::processCommandActivity() {
         bool toMe = d.to == m_config.my_callsign().trimmed() || d.to == Radio::base_callsign(m_config.my_callsign()).trimmed();
 
         // log call activity...
-        CallDetail cd = {};
-        cd.call = d.from;
-        cd.grid = d.grid;
-        cd.snr = d.snr;
-        cd.dial = d.dial;
-        cd.offset = d.offset;
-        cd.bits = d.bits;
-        cd.ackTimestamp = d.text.contains(": ACK") || toMe ? d.utcTimestamp : QDateTime{};
-        cd.utcTimestamp = d.utcTimestamp;
-        cd.tdrift = d.tdrift;
-        cd.submode = d.submode;
+        CallDetail cd = Activity::caller(d);
+        cd.ackTimestamp = d.text.contains(": ACK") || toMe ? d.utcTimestamp : UtcTime{};
         logCallActivity(cd, true);
         logHeardGraph(d.from, d.to);
 
@@ -8743,7 +9369,7 @@ void MainWindow::processCommandActivity() {
             // so don't overwrite those (i.e., print each on a new line)
             bool shouldOverwrite = (!d.cmd.contains(" ACK") && !d.cmd.contains(" SNR")); /* && isRecentOffset(d.freq);*/
 
-            if(shouldOverwrite && ui->textEditRX->find(d.utcTimestamp.time().toString(), QTextDocument::FindBackward)){
+            if(shouldOverwrite && ui->textEditRX->find(d.utcTimestamp.toDateTime().time().toString(), QTextDocument::FindBackward)){
                 // ... maybe we could delete the last line that had this message on this frequency...
                 c = ui->textEditRX->textCursor();
                 c.movePosition(QTextCursor::StartOfBlock);
@@ -8759,7 +9385,7 @@ void MainWindow::processCommandActivity() {
             }
 
             // log it to the display!
-            displayTextForFreq(ad.text, ad.offset, ad.utcTimestamp, false, true, false);
+            displayTextForFreq(ad.text, ad.offset, ad.utcTimestamp.toDateTime(), false, true, false);
 
             /*
             // and send it to the network in case we want to interact with it from an external app...
@@ -8938,7 +9564,7 @@ void MainWindow::processCommandActivity() {
                     cd.dial = d.dial;
                     cd.offset = d.offset;
                     cd.through = d.from;
-                    cd.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+                    cd.utcTimestamp = DriftingDateTime::currentUtc();
                     cd.tdrift = d.tdrift;
                     cd.submode = d.submode;
                     logCallActivity(cd, false);
@@ -9099,7 +9725,7 @@ void MainWindow::processCommandActivity() {
 
             if(isAllCall){
                 // since all pings are technically @ALLCALL, let's bump the allcall cache here...
-                m_txAllcallCommandCache.insert(d.from, new QDateTime(now), 5);
+                m_txAllcallCommandCache.insert(d.from, new UtcTime(now), 5);
             }
 
             continue;
@@ -9142,7 +9768,7 @@ void MainWindow::processCommandActivity() {
 #if SHOW_ALERT_FOR_MSG
             SelfDestructMessageBox * m = new SelfDestructMessageBox(300,
               "New Message Received",
-              QString("A new message was received at %1 UTC from %2").arg(d.utcTimestamp.time().toString()).arg(d.from),
+              QString("A new message was received at %1 UTC from %2").arg(d.utcTimestamp.toDateTime().time().toString()).arg(d.from),
               QMessageBox::Information,
               QMessageBox::Ok,
               QMessageBox::Ok,
@@ -9306,13 +9932,13 @@ void MainWindow::processCommandActivity() {
             QStringList replies;
             int callsignAging = m_config.callsign_aging();
             auto baseCall = callsigns.first();
-            foreach(auto cd, m_callActivity.values()){
+            for(auto const &cd : std::as_const(m_callActivity)){
                 if (callsignAging && cd.utcTimestamp.secsTo(now) / 60 >= callsignAging) {
                     continue;
                 }
 
                 if(baseCall == cd.call || baseCall == Radio::base_callsign(cd.call)){
-                    auto r = QString("%1 (%2)").arg(Varicode::formatSNR(cd.snr)).arg(since(cd.utcTimestamp)).trimmed();
+                    auto r = QString("%1 (%2)").arg(Varicode::formatSNR(cd.snr)).arg(since(cd.utcTimestamp, now)).trimmed();
                     replies.append(r);
                     break;
                 }
@@ -9326,7 +9952,7 @@ void MainWindow::processCommandActivity() {
 
             if(!reply.isEmpty()){
                 if(isAllCall){
-                    m_txAllcallCommandCache.insert(d.from, new QDateTime(now), 25);
+                    m_txAllcallCommandCache.insert(d.from, new UtcTime(now), 25);
                 }
             }
         }
@@ -9375,7 +10001,7 @@ void MainWindow::processCommandActivity() {
 
         // add @ALLCALLs to the @ALLCALL cache
         if(isAllCall){
-            m_txAllcallCommandCache.insert(d.from, new QDateTime(now), 25);
+            m_txAllcallCommandCache.insert(d.from, new UtcTime(now), 25);
         }
 
         // queue the reply here to be sent when a free interval is available on the frequency that was sent
@@ -9424,14 +10050,16 @@ void MainWindow::refreshInboxCounts(){
                 auto const tdrift  = params.value("TDRIFT").toInt();
                 auto const submode = params.value("SUBMODE").toInt();
 
+                auto stamp = QDateTime::fromString(utc, "yyyy-MM-dd hh:mm:ss");
+                stamp.setTimeZone(QTimeZone::utc());
+
                 CallDetail cd;
                 cd.call         = from;
                 cd.snr          = snr;
                 cd.dial         = dial;
                 cd.offset       = offset;
                 cd.tdrift       = tdrift;
-                cd.utcTimestamp = QDateTime::fromString(utc, "yyyy-MM-dd hh:mm:ss");
-                cd.utcTimestamp.setTimeZone(QTimeZone::utc());
+                cd.utcTimestamp = UtcTime::fromDateTime(stamp);
                 cd.ackTimestamp = cd.utcTimestamp;
                 cd.submode      = submode;
                 logCallActivity(cd, false);
@@ -9475,7 +10103,7 @@ int MainWindow::addCommandToStorage(QString type, CommandDetail d){
     }
 
     QVariantMap v = {
-        {"UTC", QVariant(d.utcTimestamp.toString("yyyy-MM-dd hh:mm:ss"))},
+        {"UTC", QVariant(d.utcTimestamp.toDateTime().toString("yyyy-MM-dd hh:mm:ss"))},
         {"TO", QVariant(d.to)},
         {"FROM", QVariant(d.from)},
         {"PATH", QVariant(d.relayPath)},
@@ -9502,7 +10130,12 @@ int MainWindow::addCommandToStorage(QString type, CommandDetail d){
 
     auto m = Message(type, "", v);
 
-    return inbox.append(m);
+    auto id = inbox.append(m);
+    if(id > 0){
+        Q_EMIT inboxUpdated();
+    }
+
+    return id;
 }
 
 int MainWindow::getNextMessageIdForCallsign(QString callsign){
@@ -9705,7 +10338,7 @@ void MainWindow::displayActivity(bool force) {
 
 // updateBandActivity
 void MainWindow::displayBandActivity() {
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
 
     ui->tableWidgetRXAll->setFont(m_config.table_font());
 
@@ -9835,7 +10468,7 @@ void MainWindow::displayBandActivity() {
 
             QList < ActivityDetail > items = m_bandActivity[offset];
             if (items.length() > 0) {
-                QDateTime timestamp;
+                UtcTime timestamp;
                 QStringList text;
                 QString age;
                 int snr = 0;
@@ -9902,7 +10535,7 @@ void MainWindow::displayBandActivity() {
                     }
                     text.append(item.text);
                     snr = item.snr;
-                    age = since(item.utcTimestamp);
+                    age = since(item.utcTimestamp, now);
                     timestamp = item.utcTimestamp;
                     tdrift = item.tdrift;
                     submode = item.submode;
@@ -9924,7 +10557,7 @@ void MainWindow::displayBandActivity() {
 
                 auto ageItem = new QTableWidgetItem(age);
                 ageItem->setTextAlignment(Qt::AlignCenter);
-                ageItem->setToolTip(timestamp.toString());
+                ageItem->setToolTip(timestamp.toDateTime().toString());
                 ui->tableWidgetRXAll->setItem(row, col++, ageItem);
 
                 auto snrText = Varicode::formatSNR(snr);
@@ -10056,7 +10689,7 @@ void MainWindow::displayBandActivity() {
 
 // updateCallActivity
 void MainWindow::displayCallActivity() {
-    auto now = DriftingDateTime::currentDateTimeUtc();
+    auto now = DriftingDateTime::currentUtc();
 
     ui->tableWidgetCalls->setFont(m_config.table_font());
 
@@ -10247,8 +10880,8 @@ void MainWindow::displayCallActivity() {
             iconItem->setData(Qt::UserRole, QVariant(d.call));
             iconItem->setToolTip(
                 hasMessage ? "Message Available" :
-                hasACK ? QString("Hearing Your Station (%1)").arg(since(d.ackTimestamp)) :
-                hasCQ ? QString("Calling CQ (%1)").arg(since(d.cqTimestamp)) :
+                hasACK ? QString("Hearing Your Station (%1)").arg(since(d.ackTimestamp, now)) :
+                hasCQ ? QString("Calling CQ (%1)").arg(since(d.cqTimestamp, now)) :
                 hasThrough ? QString("Heard Through Relay (%1)").arg(d.through) :
                 "");
             iconItem->setTextAlignment(Qt::AlignCenter);
@@ -10267,9 +10900,9 @@ void MainWindow::displayCallActivity() {
 #else
             if(true){
 #endif
-                auto ageItem = new QTableWidgetItem(since(d.utcTimestamp));
+                auto ageItem = new QTableWidgetItem(since(d.utcTimestamp, now));
                 ageItem->setTextAlignment(Qt::AlignCenter);
-                ageItem->setToolTip(d.utcTimestamp.toString());
+                ageItem->setToolTip(d.utcTimestamp.toDateTime().toString());
                 ui->tableWidgetCalls->setItem(row, col++, ageItem);
 
                 auto snrText = Varicode::formatSNR(d.snr);
@@ -10477,7 +11110,7 @@ void MainWindow::emitPTT(bool on){
     sendNetworkMessage("RIG.PTT", on ? "on" : "off", {
         {"_ID", QVariant(-1)},
         {"PTT", QVariant(on)},
-        {"UTC", QVariant(DriftingDateTime::currentDateTimeUtc().toMSecsSinceEpoch())},
+        {"UTC", QVariant(DriftingDateTime::currentMSecsSinceEpoch())},
     });
 }
 
@@ -10509,10 +11142,10 @@ void MainWindow::udpNetworkMessage(Message const &message)
         return;
     }
 
-    networkMessage(message);
+    networkMessage(message, QStringLiteral("udp"));
 }
 
-void MainWindow::tcpNetworkMessage(Message const &message)
+void MainWindow::tcpNetworkMessage(Message const &message, QString const &client)
 {
     if(!m_config.tcpEnabled()){
         return;
@@ -10522,10 +11155,30 @@ void MainWindow::tcpNetworkMessage(Message const &message)
         return;
     }
 
-    networkMessage(message);
+    networkMessage(message, client);
+}
+
+/**
+ * @brief MainWindow::networkQuery
+ *        answer a read-only request on the query worker, from a snapshot
+ *        captured by the query, telling the client to back off instead
+ *        if it's asking more often than it's allowed
+ * @param request - the request being answered
+ * @param client - who's asking
+ * @param query - builds the reply, off the GUI thread
+ */
+void MainWindow::networkQuery(Message const &request, QString const &client, ApiQueries::Query query){
+    if(auto const retry = m_apiQueries.submit(client, request, std::move(query))){
+        qDebug() << "rate limiting" << request.type() << "for" << client << "for" << retry << "ms";
+
+        sendNetworkMessage("API.ERROR", "Too many requests", {
+            {"_ID", request.id()},
+            {"RETRY_MS", QVariant(retry)},
+        });
+    }
 }
 
-void MainWindow::networkMessage(Message const &message)
+void MainWindow::networkMessage(Message const &message, QString const &client)
 {
     auto type = message.type();
 
@@ -10639,26 +11292,31 @@ void MainWindow::networkMessage(Message const &message)
     // RX.GET_CALL_SELECTED
     // RX.GET_BAND_ACTIVITY
     // RX.GET_TEXT
+    // RX.GET_DECODER_STATS
+    // RX.GET_RETENTION
 
     if(type == "RX.GET_CALL_ACTIVITY"){
-        auto now = DriftingDateTime::currentDateTimeUtc();
+        auto now = DriftingDateTime::currentUtc();
         int callsignAging = m_config.callsign_aging();
-        QVariantMap calls = {
-            {"_ID", id},
-        };
 
-        foreach(auto cd, m_callActivity.values()){
-            if (callsignAging && cd.utcTimestamp.secsTo(now) / 60 >= callsignAging) {
-                continue;
+        networkQuery(message, client, [id, now, callsignAging, callActivity = m_callActivity](){
+            QVariantMap calls = {
+                {"_ID", id},
+            };
+
+            for(auto const &cd : callActivity){
+                if (callsignAging && cd.utcTimestamp.secsTo(now) / 60 >= callsignAging) {
+                    continue;
+                }
+                QVariantMap detail;
+                detail["SNR"] = QVariant(cd.snr);
+                detail["GRID"] = QVariant(cd.grid);
+                detail["UTC"] = QVariant(cd.utcTimestamp.toMSecsSinceEpoch());
+                calls[cd.call] = QVariant(detail);
             }
-            QVariantMap detail;
-            detail["SNR"] = QVariant(cd.snr);
-            detail["GRID"] = QVariant(cd.grid);
-            detail["UTC"] = QVariant(cd.utcTimestamp.toMSecsSinceEpoch());
-            calls[cd.call] = QVariant(detail);
-        }
 
-        sendNetworkMessage("RX.CALL_ACTIVITY", "", calls);
+            return Message("RX.CALL_ACTIVITY", "", calls);
+        });
         return;
     }
 
@@ -10670,26 +11328,28 @@ void MainWindow::networkMessage(Message const &message)
     }
 
     if(type == "RX.GET_BAND_ACTIVITY"){
-        QVariantMap offsets = {
-            {"_ID", id},
-        };
-        for (auto const [offset, activity] : m_bandActivity.asKeyValueRange())
-        {
-            if (activity.isEmpty()) continue;
+        networkQuery(message, client, [id, bandActivity = m_bandActivity](){
+            QVariantMap offsets = {
+                {"_ID", id},
+            };
+            for (auto const [offset, activity] : bandActivity.asKeyValueRange())
+            {
+                if (activity.isEmpty()) continue;
 
-            auto const d = activity.last();
+                auto const &d = activity.last();
 
-            offsets[QString("%1").arg(offset)] = QVariant(QVariantMap {
-              { "FREQ",   QVariant(d.dial + d.offset)                  },
-              { "DIAL",   QVariant(d.dial)                             },
-              { "OFFSET", QVariant(d.offset)                           },
-              { "TEXT",   QVariant(d.text)                             },
-              { "SNR",    QVariant(d.snr)                              },
-              { "UTC",    QVariant(d.utcTimestamp.toMSecsSinceEpoch()) }
-            });
-        }
+                offsets[QString("%1").arg(offset)] = QVariant(QVariantMap {
+                  { "FREQ",   QVariant(d.dial + d.offset)                  },
+                  { "DIAL",   QVariant(d.dial)                             },
+                  { "OFFSET", QVariant(d.offset)                           },
+                  { "TEXT",   QVariant(d.text)                             },
+                  { "SNR",    QVariant(d.snr)                              },
+                  { "UTC",    QVariant(d.utcTimestamp.toMSecsSinceEpoch()) }
+                });
+            }
 
-        sendNetworkMessage("RX.BAND_ACTIVITY", "", offsets);
+            return Message("RX.BAND_ACTIVITY", "", offsets);
+        });
         return;
     }
 
@@ -10700,6 +11360,37 @@ void MainWindow::networkMessage(Message const &message)
         return;
     }
 
+    if(type == "RX.GET_DECODER_STATS"){
+        sendNetworkMessage("RX.DECODER_STATS", "", {
+            {"_ID", id},
+            {"SKIPPED", QVariant(m_decodesSkipped)},
+            {"CAUGHT_UP", QVariant(m_decodesCaughtUp)},
+            {"LOST", QVariant(m_decodesLost)},
+            {"BACKLOG", QVariant(m_decoderBacklog.count())},
+        });
+        return;
+    }
+
+    if(type == "RX.GET_RETENTION"){
+        QVariantMap retained = {
+            {"_ID", id},
+        };
+
+        for(int i = 0; i < RetainedCount; i++){
+            auto const &retention = m_retention[i];
+
+            retained[retention.name] = QVariantMap {
+                {"SIZE",      QVariant(qlonglong(retainedSize(static_cast<Retained>(i))))},
+                {"MAX_AGE",   QVariant(retainedAgeMins(static_cast<Retained>(i)))},
+                {"MAX_COUNT", QVariant(qlonglong(retention.maxCount))},
+                {"DROPPED",   QVariant(qlonglong(retention.dropped))},
+            };
+        }
+
+        sendNetworkMessage("RX.RETENTION", "", retained);
+        return;
+    }
+
     // TX.GET_TEXT
     // TX.SET_TEXT
     // TX.SEND_MESSAGE
@@ -10773,30 +11464,39 @@ void MainWindow::networkMessage(Message const &message)
             selectedCall = "%";
         }
 
-        Inbox inbox(inboxPath());
-        if(!inbox.open()){
-            return;
-        }
+        networkQuery(message, client, [id, selectedCall, path = inboxPath()](){
+            // don't hold up the queries behind this one for long if the
+            // GUI thread is writing to the inbox; the client can ask again
+            Inbox inbox(path);
+            if(!inbox.open(ApiQueries::BUSY_TIMEOUT_MS)){
+                if(inbox.isBusy()) throw ApiQueries::Busy();
+                return Message();
+            }
 
-        QList<QPair<int, Message> > msgs;
-        msgs.append(inbox.values("STORE", "$.params.TO", selectedCall, 0, 1000));
-        msgs.append(inbox.values("READ", "$.params.FROM", selectedCall, 0, 1000));
-        foreach(auto pair, inbox.values("UNREAD", "$.params.FROM", selectedCall, 0, 1000)){
-            msgs.append(pair);
-        }
-        std::stable_sort(msgs.begin(), msgs.end(), [](QPair<int, Message> const &a, QPair<int, Message> const &b){
-            return QVariant::compare(a.second.params().value("UTC"),
-                                     b.second.params().value("UTC")) == QPartialOrdering::Greater;
-        });
+            auto const values = [&inbox, &selectedCall](QString const &type, QString const &query){
+                auto const v = inbox.values(type, query, selectedCall, 0, 1000);
+                if(inbox.isBusy()) throw ApiQueries::Busy();
+                return v;
+            };
+
+            QList<QPair<int, Message> > msgs;
+            msgs.append(values("STORE", "$.params.TO"));
+            msgs.append(values("READ", "$.params.FROM"));
+            msgs.append(values("UNREAD", "$.params.FROM"));
+            std::stable_sort(msgs.begin(), msgs.end(), [](QPair<int, Message> const &a, QPair<int, Message> const &b){
+                return QVariant::compare(a.second.params().value("UTC"),
+                                         b.second.params().value("UTC")) == QPartialOrdering::Greater;
+            });
 
-        QVariantList l;
-        foreach(auto pair, msgs){
-            l << pair.second.toVariantMap();
-        }
+            QVariantList l;
+            for(auto const &pair : std::as_const(msgs)){
+                l << pair.second.toVariantMap();
+            }
 
-        sendNetworkMessage("INBOX.MESSAGES", "", {
-            {"_ID", id},
-            {"MESSAGES", l},
+            return Message("INBOX.MESSAGES", "", {
+                {"_ID", id},
+                {"MESSAGES", l},
+            });
         });
         return;
     }
@@ -10818,7 +11518,7 @@ void MainWindow::networkMessage(Message const &message)
         d.from = m_config.my_callsign();
         d.relayPath = d.from;
         d.text = text;
-        d.utcTimestamp = DriftingDateTime::currentDateTimeUtc();
+        d.utcTimestamp = DriftingDateTime::currentUtc();
         d.submode = m_nSubMode;
 
         auto mid = addCommandToStorage("STORE", d);
@@ -10830,6 +11530,18 @@ void MainWindow::networkMessage(Message const &message)
         return;
     }
 
+    // MEMORY.GET_USAGE
+
+    if(type == "MEMORY.GET_USAGE"){
+        m_memory.sample();
+
+        auto usage = m_memory.toVariantMap();
+        usage["_ID"] = id;
+
+        sendNetworkMessage("MEMORY.USAGE", "", usage);
+        return;
+    }
+
     // WINDOW.RAISE
 
     if(type == "WINDOW.RAISE"){
@@ -10847,35 +11559,26 @@ bool MainWindow::canSendNetworkMessage(){
 }
 
 void MainWindow::sendNetworkMessage(QString const &type, QString const &message){
-    if(!canSendNetworkMessage()){
-        return;
-    }
-
-    auto m = Message(type, message);
-
-    if(m_config.udpEnabled()){
-        m_messageClient->send(m);
-    }
-
-    if(m_config.tcpEnabled()){
-        m_messageServer->send(m);
-    }
+    sendNetworkMessage(Message(type, message));
 }
 
 void MainWindow::sendNetworkMessage(QString const &type, QString const &message, QVariantMap const &params)
+{
+    sendNetworkMessage(Message(type, message, params));
+}
+
+void MainWindow::sendNetworkMessage(Message const &message)
 {
     if(!canSendNetworkMessage()){
         return;
     }
 
-    auto m = Message(type, message, params);
-
     if(m_config.udpEnabled()){
-        m_messageClient->send(m);
+        m_messageClient->send(message);
     }
 
     if(m_config.tcpEnabled()){
-        m_messageServer->send(m);
+        m_messageServer->send(message);
     }
 }
 
@@ -10887,6 +11590,24 @@ MainWindow::pskReporterError(QString const & message)
   showStatusMessage (tr ("Spotting to PSK Reporter unavailable"));
 }
 
+void
+MainWindow::logDispatcherStatus(LogDispatcher::Target const target,
+                                bool                  const delivered,
+                                int                   const pending,
+                                QString               const & message)
+{
+  auto const name = target == LogDispatcher::N1MM ? QString {"N1MM"} : QString {"N3FJP"};
+
+  if (delivered)
+  {
+    if (pending) showStatusMessage (tr ("Log sent to %1; %2 pending").arg (name).arg (pending));
+  }
+  else
+  {
+    showStatusMessage (tr ("Unable to send log to %1 (%2); %3 pending, will retry").arg (name).arg (message).arg (pending));
+  }
+}
+
 void MainWindow::setRig (Frequency f)
 {
   if (f)
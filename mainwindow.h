@@ -7,10 +7,12 @@
 #include <QtGui>
 #endif
 #include <QThread>
+#include <QThreadPool>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QList>
 #include <QAudioDevice>
 #include <QScopedPointer>
@@ -29,7 +31,10 @@
 #include <QLabel>
 #include <QProgressBar>
 
+#include <array>
 #include <functional>
+#include <limits>
+#include <optional>
 #include <unordered_map>
 
 #include "AudioDevice.hpp"
@@ -49,13 +54,21 @@
 #include "varicode.h"
 #include "MessageClient.hpp"
 #include "MessageServer.h"
-#include "TCPClient.h"
+#include "LogDispatcher.h"
 #include "SpotClient.h"
 #include "APRSISClient.h"
 #include "NotificationAudio.h"
 #include "ProcessThread.h"
 #include "JS8.hpp"
+#include "DecodeSchedule.hpp"
 #include "StationList.hpp"
+#include "StationSchedule.hpp"
+#include "StartupTimeline.hpp"
+#include "MemoryAccounting.hpp"
+#include "StringPool.hpp"
+#include "Activity.hpp"
+#include "ApiQueries.hpp"
+#include "DriftingDateTime.h"
 
 extern int volatile itone[JS8_NUM_SYMBOLS];   //Audio tones for all Tx symbols
 
@@ -90,8 +103,6 @@ class MainWindow : public QMainWindow
 {
   Q_OBJECT;
 
-  struct CallDetail;
-  struct CommandDetail;
 public:
   using Frequency = Radio::Frequency;
   using FrequencyDelta = Radio::FrequencyDelta;
@@ -101,6 +112,7 @@ public:
                       QDir    const & temp_directory,
                       bool            multiple,
                       MultiSettings * settings,
+                      QElapsedTimer const & startupClock,
                       QWidget       * parent = nullptr);
   ~MainWindow();
 
@@ -215,9 +227,7 @@ private slots:
   void on_actionOpen_log_directory_triggered ();
   void on_actionCopyright_Notice_triggered();
   bool decode(qint32 k);
-  bool isDecodeReady(int submode, qint32 k, qint32 k0, qint32 *pCurrentDecodeStart, qint32 *pNextDecodeStart, qint32 *pStart, qint32 *pSz, qint32 *pCycle);
-  bool decodeEnqueueReady(qint32 k, qint32 k0);
-  bool decodeEnqueueReadyExperiment(qint32 k, qint32 k0);
+  bool decodeEnqueueReady(qint32 k);
   bool decodeProcessQueue(qint32 *pSubmode);
   void decodeStart();
   void decodeBusy(bool b);
@@ -315,12 +325,15 @@ private slots:
   void emitPTT(bool on);
   void emitTones();
   void udpNetworkMessage(Message const &message);
-  void tcpNetworkMessage(Message const &message);
-  void networkMessage(Message const &message);
+  void tcpNetworkMessage(Message const &message, QString const &client);
+  void networkMessage(Message const &message, QString const &client);
+  void networkQuery(Message const &request, QString const &client, ApiQueries::Query query);
   bool canSendNetworkMessage();
   void sendNetworkMessage(QString const &type, QString const &message);
   void sendNetworkMessage(QString const &type, QString const &message, const QVariantMap &params);
+  void sendNetworkMessage(Message const &message);
   void pskReporterError (QString const &);
+  void logDispatcherStatus (LogDispatcher::Target, bool, int, QString const &);
   void TxAgain();
   void checkVersion(bool alertOnUpToDate);
   void checkStartupWarnings ();
@@ -351,9 +364,13 @@ private:
   Q_SIGNAL void spotClientEnqueueCmd(QString, QString, QString, QString, QString, QString, QString, int, int, int, int);
   Q_SIGNAL void spotClientEnqueueSpot(QString, QString, int, int, int, int);
 
+  Q_SIGNAL void logDispatcherEnqueue(LogDispatcher::Target, QString, quint16, QByteArray);
+
   Q_SIGNAL void decodedLineReady(QByteArray t);
+  Q_SIGNAL void inboxUpdated();
   Q_SIGNAL void playNotification(const QString &name);
   Q_SIGNAL void initializeNotificationAudioOutputStream(const QAudioDevice &, unsigned) const;
+  Q_SIGNAL void prepareNotifications(const QStringList &paths) const;
   Q_SIGNAL void initializeAudioOutputStream (QAudioDevice,
       unsigned channels, unsigned msBuffered) const;
   Q_SIGNAL void stopAudioOutputStream () const;
@@ -386,7 +403,17 @@ private:
   int freq() const { return m_freq; }
 
   void setFreq(int);
-
+  void showStartupTimeline();
+  void showMemoryUsage();
+  void addMemoryAccounts();
+  void sampleMemory();
+
+  StartupTimeline m_startup;
+  MemoryAccounting m_memory;
+  QTimer m_memoryTimer;
+  int m_memoryLogInterval = 0; // minutes between logging samples, 0 to not log
+  int m_memorySamples = 0;
+  ApiQueries m_apiQueries;
   QString m_nextFreeTextMsg;
 
   NetworkAccessManager m_network_manager;
@@ -445,7 +472,7 @@ private:
   bool    m_btxok;		//True if OK to transmit
   bool    m_decoderBusy;
   QString m_decoderBusyBand;
-  QMap<qint32, qint32> m_lastDecodeStartMap;  // submode, decode k start position
+  DecodeSchedule m_decodeSchedule;
   Radio::Frequency m_decoderBusyFreq;
   QDateTime m_decoderBusyStartTime;
   bool    m_auto;
@@ -476,6 +503,8 @@ private:
   QLabel config_label;
   QLabel mode_label;
   QLabel last_tx_label;
+  QLabel decoder_label;
+  QLabel retention_label;
   QLabel auto_tx_label;
   QProgressBar progressBar;
   QLabel wpm_label;
@@ -502,59 +531,6 @@ private:
   QString m_msgSent0;
   QString m_opCall;
 
-  struct CallDetail
-  {
-    QString call;
-    QString through;
-    QString grid;
-    int dial;
-    int offset;
-    QDateTime cqTimestamp;
-    QDateTime ackTimestamp;
-    QDateTime utcTimestamp;
-    int snr;
-    int bits;
-    float tdrift;
-    int submode;
-  };
-
-  struct CommandDetail
-  {
-    bool isCompound;
-    bool isBuffered;
-    QString from;
-    QString to;
-    QString cmd;
-    int dial;
-    int offset;
-    QDateTime utcTimestamp;
-    int snr;
-    int bits;
-    QString grid;
-    QString text;
-    QString extra;
-    float tdrift;
-    int submode;
-    QString relayPath;
-  };
-
-  struct ActivityDetail
-  {
-    bool isLowConfidence;
-    bool isCompound;
-    bool isDirected;
-    bool isBuffered;
-    int bits;
-    int dial;
-    int offset;
-    QString text;
-    QDateTime utcTimestamp;
-    int snr;
-    bool shouldDisplay;
-    float tdrift;
-    int submode;
-  };
-
   struct MessageBuffer {
     CommandDetail cmd;
     QQueue<CallDetail> compound;
@@ -606,15 +582,52 @@ private:
 
   struct CachedDirectedType {
       bool isAllcall;
-      QDateTime date;
+      UtcTime date;
   };
 
   struct DecodeParams {
       int submode;
       int start;
       int sz;
+      UtcTime utc;  // when the window was ready
+  };
+
+  void decodeBacklogAppend(DecodeParams const &params);
+  std::optional<DecodeParams> decodeBacklogTake();
+  void decodeBacklogClear();
+  void decodeHints();
+  void updateDecoderStatus();
+
+  enum class DisplayState { Visible, Hidden, Minimized };
+
+  void updateDisplayState();
+
+  enum Retained {
+    RetainedBandActivity,
+    RetainedCallActivity,
+    RetainedMessageBuffer,
+    RetainedHeardGraph,
+    RetainedCount
   };
 
+  struct RetentionPolicy {
+      char const *name;     // in settings and as reported
+      int maxAgeMins;       // 0 to follow the configured aging, if any
+      qsizetype maxCount;   // 0 for no limit by count
+      qsizetype dropped;    // entries removed by compaction so far
+  };
+
+  template<typename Key>
+  struct CompactionPass {
+      std::optional<Key> cursor; // where the next visit resumes, if under way
+      qint64 tooMany = std::numeric_limits<qint64>::min(); // count cutoff, as the pass began
+  };
+
+  void compactActivity();
+  int retainedAgeMins(Retained retained) const;
+  qsizetype retainedSize(Retained retained) const;
+  void updateRetentionStatus();
+
   struct FrameCacheKey
   {
     int     submode;
@@ -640,10 +653,31 @@ private:
     };
   };
 
-  using FrameCache   = std::unordered_map<FrameCacheKey, QDateTime, FrameCacheKey::Hash>;
+  using FrameCache   = std::unordered_map<FrameCacheKey, UtcTime, FrameCacheKey::Hash>;
   using BandActivity = QMap<int, QList<ActivityDetail>>;
 
   QQueue<DecodeParams> m_decoderQueue;
+  QList<DecodeParams> m_decoderBacklog; // windows skipped while the decoder was busy, oldest first
+  UtcTime m_decoderPassUtc; // when the window being caught up on was ready, if we are
+  int m_decodesSkipped = 0;
+  int m_decodesCaughtUp = 0;
+  int m_decodesLost = 0;
+  DisplayState m_displayState = DisplayState::Visible;
+  QElapsedTimer m_displayStateTimer; // time spent in the current display state
+  qint64 m_displayStateCpuMs = 0; // process cpu time on entering it
+  QTimer m_compactionTimer;
+  int m_compactionSlot = 0; // next slot of the compaction wheel
+  std::array<RetentionPolicy, RetainedCount> m_retention = {{
+      {"BandActivity",  0, 2000, 0},
+      {"CallActivity",  0, 5000, 0},
+      {"MessageBuffer", 0, 64,   0},
+      {"HeardGraph",    0, 5000, 0},
+  }};
+  CompactionPass<int> m_bandActivityPass; // compaction's progress, per map
+  CompactionPass<QString> m_callActivityPass;
+  CompactionPass<int> m_messageBufferPass;
+  CompactionPass<QString> m_heardGraphIncomingPass;
+  CompactionPass<QString> m_heardGraphOutgoingPass;
   FrameCache  m_messageDupeCache; // submode, frame -> date seen
   QVariantMap m_showColumnsCache; // table column:key -> show boolean
   QVariantMap m_sortCache; // table key -> sort by
@@ -653,8 +687,9 @@ private:
   QQueue<CommandDetail> m_rxCommandQueue; // command queue for processing commands
   QQueue<CallDetail> m_rxCallQueue; // call detail queue for spots to pskreporter
   QMap<QString, QString> m_compoundCallCache; // base callsign -> compound callsign
-  QCache<QString, QDateTime> m_txAllcallCommandCache; // callsign -> last tx
-  QCache<int, QDateTime> m_rxRecentCache; // freq -> last rx
+  StringPool m_strings; // callsigns, grids and commands shared by activity records
+  QCache<QString, UtcTime> m_txAllcallCommandCache; // callsign -> last tx
+  QCache<int, UtcTime> m_rxRecentCache; // freq -> last rx
   QCache<int, CachedDirectedType> m_rxDirectedCache; // freq -> last directed rx
   QCache<QString, int> m_rxCallCache; // call -> last freq seen
   QMap<int, int> m_rxFrameBlockNumbers; // freq -> block
@@ -674,12 +709,16 @@ private:
   QMap<QString, QMap<QString, QSet<QString>>> m_heardGraphOutgoingBandCache; // band -> heard in
   QMap<QString, QMap<QString, QSet<QString>>> m_heardGraphIncomingBandCache; // band -> heard out
 
-  QMap<QString, QDateTime> m_callSelectedTime; // call -> timestamp when callsign was last selected
+  QMap<QString, UtcTime> m_callSelectedTime; // call -> timestamp when callsign was last selected
   QSet<QString> m_callSeenHeartbeat; // call
   int m_previousFreq;
   bool m_shouldRestoreFreq;
   bool m_bandHopped;
   Frequency m_bandHoppedFreq;
+  StationSchedule m_bandHopSchedule;
+  QTimer m_bandHopTimer;
+  int m_bandHopSegment;
+  bool m_bandHopPending;
 
   int m_hbInterval;
   int m_cqInterval;
@@ -690,6 +729,8 @@ private:
   QDateTime m_dateTimeLastTX;
 
   LogBook m_logBook;
+  unsigned m_logBookLoads = 0;
+  QThreadPool m_logBookLoader;    // after the log book, so a load in flight is waited for first
   unsigned m_msAudioOutputBuffered;
   unsigned m_framesAudioInputBuffered;
   QThread::Priority m_audioThreadPriority;
@@ -708,7 +749,7 @@ private:
   Frequency m_lastMonitoredFrequency;
   MessageClient * m_messageClient;
   MessageServer * m_messageServer;
-  TCPClient * m_n3fjpClient;
+  LogDispatcher * m_logDispatcher;
   PSKReporter * m_pskReporter;
   SpotClient *m_spotClient;
   APRSISClient *m_aprsClient;
@@ -780,6 +821,7 @@ private:
   void displayBandActivity();
   void displayCallActivity();
   void enable_DXCC_entity (bool on);
+  void loadLogBook();
   void setRig (Frequency = 0);  // zero frequency means no change
   QDateTime nextTransmitCycle();
   void resetAutomaticIntervalTransmissions(bool stopCQ, bool stopHB);
@@ -788,6 +830,8 @@ private:
   void statusUpdate ();
   void on_the_minute ();
   void tryBandHop();
+  void updateBandHopSchedule();
+  void scheduleBandHop();
   void add_child_to_event_filter (QObject *);
   void remove_child_from_event_filter (QObject *);
   void setup_status_bar ();
@@ -1,14 +1,25 @@
 #include "messagewindow.h"
 #include <algorithm>
+#include <limits>
+#include <optional>
+#include <QAbstractTableModel>
+#include <QAction>
 #include <QDateTime>
 #include <QMenu>
 #include "EventFilter.hpp"
+#include "Inbox.h"
+#include "Message.hpp"
 #include "Radio.hpp"
 #include "ui_messagewindow.h"
 #include "moc_messagewindow.cpp"
 
 namespace
 {
+  // Rows fetched from the inbox at a time, as the view scrolls toward
+  // the end of what it has.
+
+  constexpr int PAGE_SIZE = 100;
+
   auto
   pathSegs(QString const & path)
   {
@@ -19,15 +30,248 @@ namespace
   }
 }
 
+/******************************************************************************/
+// Model
+/******************************************************************************/
+
+// Messages to and from a callsign, newest first, paged in from the inbox
+// as the view asks for them. Rows hold the undecoded message until the
+// view first asks for something from them, i.e., until they're visible.
+
+class MessageWindow::Model final : public QAbstractTableModel
+{
+public:
+
+  enum Column
+  {
+    Flag,
+    Id,
+    Date,
+    Frequency,
+    From,
+    To,
+    Text,
+    ColumnCount
+  };
+
+  Model(QString   const & inboxPath,
+        QString   const & call,
+        QSet<int> const & unread,
+        QObject         * parent)
+    : QAbstractTableModel {parent}
+    , inbox_              {inboxPath}
+    , call_               {call}
+    , unread_             {unread}
+  {
+    inbox_.open();
+  }
+
+  int
+  rowCount(QModelIndex const & parent = {}) const override
+  {
+    return parent.isValid() ? 0 : rows_.size();
+  }
+
+  int
+  columnCount(QModelIndex const & parent = {}) const override
+  {
+    return parent.isValid() ? 0 : ColumnCount;
+  }
+
+  QVariant
+  headerData(int             const section,
+             Qt::Orientation const orientation,
+             int             const role) const override
+  {
+    if (orientation != Qt::Horizontal) return {};
+
+    switch (role)
+    {
+      case Qt::DisplayRole:
+        switch (section)
+        {
+          case Flag:      return QString {"\u2691"};
+          case Id:        return QString {"ID"};
+          case Date:      return QString {"Date"};
+          case Frequency: return QString {"Frequency"};
+          case From:      return QString {"From"};
+          case To:        return QString {"To"};
+          case Text:      return QString {"Message"};
+        }
+        break;
+
+      case Qt::ToolTipRole:
+        if (section == Flag) return QString {"Read / Unread Status"};
+        break;
+    }
+
+    return {};
+  }
+
+  QVariant
+  data(QModelIndex const & index,
+       int         const   role) const override
+  {
+    if (!index.isValid() || index.row() >= rows_.size()) return {};
+
+    auto const & row = rows_[index.row()];
+
+    switch (role)
+    {
+      case Qt::DisplayRole:
+      {
+        auto const & fields = decode(row);
+
+        switch (index.column())
+        {
+          case Flag:      return fields.unread ? QString {"\u2691"} : QString {};
+          case Id:        return QString::number(row.id);
+          case Date:      return fields.utc.toString();
+          case Frequency: return QString {"%1 MHz"}.arg(Radio::pretty_frequency_MHz_string(fields.dial));
+          case From:      return pathSegs(fields.path).join(" via ");
+          case To:        return fields.to;
+          case Text:      return fields.text;
+        }
+        break;
+      }
+
+      case Qt::TextAlignmentRole:
+        return index.column() == Text ? QVariant {Qt::AlignVCenter}
+                                      : QVariant {Qt::AlignCenter};
+    }
+
+    return {};
+  }
+
+  bool
+  canFetchMore(QModelIndex const & parent) const override
+  {
+    return !parent.isValid() && !exhausted_;
+  }
+
+  // Next page, older than the oldest we have; keyed on the id, so the cost
+  // of a page doesn't depend on how far down the inbox it is.
+
+  void
+  fetchMore(QModelIndex const & parent) override
+  {
+    if (parent.isValid() || exhausted_) return;
+
+    auto const page = inbox_.conversation(call_,
+                                          0,
+                                          rows_.isEmpty() ? std::numeric_limits<int>::max()
+                                                          : rows_.last().id,
+                                          PAGE_SIZE);
+
+    exhausted_ = page.size() < PAGE_SIZE;
+
+    if (page.isEmpty()) return;
+
+    beginInsertRows({}, rows_.size(), rows_.size() + page.size() - 1);
+    for (auto const & [id, blob] : page) rows_.append({id, blob, {}});
+    endInsertRows();
+  }
+
+  // Anything that's arrived since we started, newer than the newest we
+  // have, goes on top.
+
+  void
+  fetchNewer()
+  {
+    if (rows_.isEmpty() && !exhausted_) return fetchMore({});
+
+    auto const page = inbox_.conversation(call_,
+                                          rows_.isEmpty() ? 0 : rows_.first().id,
+                                          std::numeric_limits<int>::max(),
+                                          -1);
+
+    if (page.isEmpty()) return;
+
+    beginInsertRows({}, 0, page.size() - 1);
+    for (auto it = page.crbegin(); it != page.crend(); ++it) rows_.prepend({it->first, it->second, {}});
+    endInsertRows();
+  }
+
+  void
+  remove(int const row)
+  {
+    beginRemoveRows({}, row, row);
+    rows_.removeAt(row);
+    endRemoveRows();
+  }
+
+  int     id  (int const row) const { return rows_[row].id; }
+  QString path(int const row) const { return decode(rows_[row]).path; }
+  QString text(int const row) const { return decode(rows_[row]).text; }
+
+private:
+
+  struct Fields
+  {
+    bool      unread = false;
+    QDateTime utc;
+    quint64   dial   = 0;
+    QString   path;
+    QString   to;
+    QString   text;
+  };
+
+  struct Row
+  {
+    int                           id;
+    mutable QByteArray            blob;
+    mutable std::optional<Fields> fields;
+  };
+
+  // Decode a row on first use; the blob isn't needed thereafter. A blob
+  // that can't be decoded leaves us with an empty row.
+
+  Fields const &
+  decode(Row const & row) const
+  {
+    if (!row.fields)
+    {
+      auto & fields = row.fields.emplace();
+
+      try
+      {
+        auto const message = Message::fromJson(row.blob);
+        auto const params  = message.params();
+
+        fields.unread = message.type() == "UNREAD" || unread_.contains(row.id);
+        fields.utc    = QDateTime::fromString(params.value("UTC").toString(), "yyyy-MM-dd hh:mm:ss");
+        fields.dial   = (quint64)params.value("DIAL").toInt();
+        fields.path   = params.value("PATH").toString();
+        fields.to     = params.value("TO").toString();
+        fields.text   = params.value("TEXT").toString();
+      }
+      catch (...)
+      {
+      }
+
+      row.blob.clear();
+    }
+
+    return *row.fields;
+  }
+
+  Inbox         inbox_;
+  QString       call_;
+  QSet<int>     unread_;
+  QList<Row>    rows_;
+  bool          exhausted_ = false;
+};
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
 MessageWindow::MessageWindow(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::MessageWindow)
 {
     ui->setupUi(this);
 
-    // connect selection model changed
-    connect(ui->messageTableWidget->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MessageWindow::messageTableSelectionChanged);
-
     // reply when key pressed in the reply box
     ui->replytextEdit->installEventFilter(new EventFilter::EnterKeyPress([this](QKeyEvent * const event)
     {
@@ -36,32 +280,25 @@ MessageWindow::MessageWindow(QWidget *parent) :
       return true;
     }, this));
 
-    ui->messageTableWidget->horizontalHeader()->setVisible(true);
-    ui->messageTableWidget->resizeColumnsToContents();
+    ui->messageTableView->horizontalHeader()->setVisible(true);
 
-    ui->messageTableWidget->setContextMenuPolicy(Qt::ActionsContextMenu);
-    auto deleteAction = new QAction("Delete", ui->messageTableWidget);
+    ui->messageTableView->setContextMenuPolicy(Qt::ActionsContextMenu);
+    auto deleteAction = new QAction("Delete", ui->messageTableView);
     connect(deleteAction, &QAction::triggered, this, [this](){
-        auto items = ui->messageTableWidget->selectedItems();
-        if(items.isEmpty()){
-            return;
-        }
-        auto item = items.first();
-        auto col = ui->messageTableWidget->item(item->row(), 1);
-        if(!col){
+        if(!m_model){
             return;
         }
-        bool ok = false;
-        auto mid = col->data(Qt::UserRole).toInt(&ok);
-        if(!ok){
+        auto index = ui->messageTableView->currentIndex();
+        if(!index.isValid()){
             return;
         }
 
-        ui->messageTableWidget->removeRow(item->row());
+        auto mid = m_model->id(index.row());
+        m_model->remove(index.row());
 
         emit this->deleteMessage(mid);
     });
-    ui->messageTableWidget->addAction(deleteAction);
+    ui->messageTableView->addAction(deleteAction);
 }
 
 MessageWindow::~MessageWindow()
@@ -70,80 +307,34 @@ MessageWindow::~MessageWindow()
 }
 
 void MessageWindow::setCall(const QString &call){
+    m_call = call;
     setWindowTitle(QString("Messages: %1").arg(call == "%" ? "All" : call));
 }
 
-void MessageWindow::populateMessages(QList<QPair<int, Message> > msgs){
-    for(int i = ui->messageTableWidget->rowCount(); i >= 0; i--){
-        ui->messageTableWidget->removeRow(i);
-    }
+void MessageWindow::showInbox(const QString &inboxPath, const QSet<int> &unread){
+    auto previous = m_model;
 
-    ui->messageTableWidget->setUpdatesEnabled(false);
-    {
-        foreach(auto pair, msgs){
-            auto mid = pair.first;
-            auto msg = pair.second;
-            auto params = msg.params();
-
-            int row = ui->messageTableWidget->rowCount();
-            ui->messageTableWidget->insertRow(row);
-
-            int col = 0;
-
-            auto typeItem = new QTableWidgetItem(msg.type() == "UNREAD" ? "\u2691" : "");
-            typeItem->setData(Qt::UserRole, msg.type());
-            typeItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, typeItem);
-
-            auto midItem = new QTableWidgetItem(QString::number(mid));
-            midItem->setData(Qt::UserRole, mid);
-            midItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, midItem);
-
-            auto date = params.value("UTC").toString();
-            auto timestamp = QDateTime::fromString(date, "yyyy-MM-dd hh:mm:ss");
-            auto dateItem = new QTableWidgetItem(timestamp.toString());
-            dateItem->setData(Qt::UserRole, timestamp);
-            dateItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, dateItem);
-
-            auto dial = (quint64)params.value("DIAL").toInt();
-            auto dialItem = new QTableWidgetItem(QString("%1 MHz").arg(Radio::pretty_frequency_MHz_string(dial)));
-            dialItem->setData(Qt::UserRole, dial);
-            dialItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, dialItem);
-
-            auto path     = params.value("PATH").toString();
-            auto segs     = pathSegs(path);
-            auto fromItem = new QTableWidgetItem(segs.join(" via "));
-            fromItem->setData(Qt::UserRole, path);
-            fromItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, fromItem);
-
-            auto to = params.value("TO").toString();
-            auto toItem = new QTableWidgetItem(to);
-            toItem->setData(Qt::UserRole, to);
-            toItem->setTextAlignment(Qt::AlignCenter);
-            ui->messageTableWidget->setItem(row, col++, toItem);
-
-            auto text = params.value("TEXT").toString();
-            auto textItem = new QTableWidgetItem(text);
-            textItem->setData(Qt::UserRole, text);
-            textItem->setTextAlignment(Qt::AlignVCenter);
-            ui->messageTableWidget->setItem(row, col++, textItem);
-        }
+    m_model = new Model(inboxPath, m_call, unread, this);
+    ui->messageTableView->setModel(m_model);
+    delete previous;
+
+    connect(ui->messageTableView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, &MessageWindow::messageTableCurrentChanged);
+
+    // the first page; the view asks for more as it's scrolled
+    m_model->fetchMore({});
 
-        ui->messageTableWidget->resizeColumnToContents(0);
-        ui->messageTableWidget->resizeColumnToContents(1);
-        ui->messageTableWidget->resizeColumnToContents(2);
-        ui->messageTableWidget->resizeColumnToContents(3);
-        ui->messageTableWidget->resizeColumnToContents(4);
-        ui->messageTableWidget->resizeColumnToContents(5);
+    for(int col = Model::Flag; col < Model::Text; col++){
+        ui->messageTableView->resizeColumnToContents(col);
     }
-    ui->messageTableWidget->setUpdatesEnabled(true);
 
-    if(ui->messageTableWidget->rowCount() > 0){
-        ui->messageTableWidget->selectRow(0);
+    if(m_model->rowCount() > 0){
+        ui->messageTableView->selectRow(0);
+    }
+}
+
+void MessageWindow::refresh(){
+    if(m_model){
+        m_model->fetchNewer();
     }
 }
 
@@ -151,29 +342,21 @@ QString MessageWindow::prepareReplyMessage(QString path, QString text){
     return QString("%1 MSG %2").arg(path).arg(text);
 }
 
-void MessageWindow::messageTableSelectionChanged(const QItemSelection &/*selected*/, const QItemSelection &/*deselected*/){
-    auto row = ui->messageTableWidget->currentRow();
-
-    // message column
-    auto item = ui->messageTableWidget->item(row, ui->messageTableWidget->columnCount()-1);
-    if(!item){
+void MessageWindow::messageTableCurrentChanged(const QModelIndex &current, const QModelIndex &/*previous*/){
+    if(!current.isValid()){
         return;
     }
 
-    auto text = item->data(Qt::UserRole).toString();
-    ui->messageTextEdit->setPlainText(text);
+    ui->messageTextEdit->setPlainText(m_model->text(current.row()));
 }
 
 void MessageWindow::on_replyPushButton_clicked(){
-    auto row = ui->messageTableWidget->currentRow();
-
-    // from column
-    auto item = ui->messageTableWidget->item(row, ui->messageTableWidget->columnCount()-3);
-    if(!item){
+    auto index = ui->messageTableView->currentIndex();
+    if(!m_model || !index.isValid()){
         return;
     }
 
-    auto path = item->data(Qt::UserRole).toString();
+    auto path = m_model->path(index.row());
     auto text = "[MESSAGE]";
     auto message = prepareReplyMessage(path, text);
 
@@ -2,10 +2,8 @@
 #define MESSAGEWINDOW_H
 
 #include <QDialog>
-#include <QPair>
-#include <QItemSelection>
-
-#include "Message.hpp"
+#include <QModelIndex>
+#include <QSet>
 
 namespace Ui {
 class MessageWindow;
@@ -25,15 +23,20 @@ signals:
 
 public slots:
     void setCall(const QString &call);
-    void populateMessages(QList<QPair<int, Message>> msgs);
+    void showInbox(const QString &inboxPath, const QSet<int> &unread);
+    void refresh();
     QString prepareReplyMessage(QString path, QString text);
 
 private slots:
-    void messageTableSelectionChanged(const QItemSelection &/*selected*/, const QItemSelection &/*deselected*/);
+    void messageTableCurrentChanged(const QModelIndex &current, const QModelIndex &/*previous*/);
     void on_replyPushButton_clicked();
 
 private:
+    class Model;
+
     Ui::MessageWindow *ui;
+    Model *m_model = nullptr;
+    QString m_call;
 };
 
 #endif // MESSAGEWINDOW_H
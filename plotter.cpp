@@ -140,9 +140,62 @@ CPlotter::paintEvent(QPaintEvent *)
 {
   QPainter p(this);
 
-  p.drawPixmap(0, 0,    m_ScalePixmap);
-  p.drawPixmap(0, 30,   m_WaterfallPixmap);
-  p.drawPixmap(0, m_h1, m_SpectrumPixmap);
+  p.drawPixmap(0, 0, m_ScalePixmap);
+
+  // The waterfall pixmap is a ring of rows, in device pixels, the newest
+  // of which is at the head; paint from the head to the bottom, and then
+  // from the top to the head, which gets us the rows in order, newest at
+  // the top, without ever having to move any of them.
+
+  if (!m_WaterfallPixmap.isNull())
+  {
+    auto const ratio  = m_WaterfallPixmap.devicePixelRatio();
+    auto const width  = m_WaterfallPixmap.width();
+    auto const height = m_WaterfallPixmap.height();
+    auto const split  = (height - m_head) / ratio;
+
+    p.drawPixmap(QRectF(0, 30, m_w, split),
+                 m_WaterfallPixmap,
+                 QRectF(0, m_head, width, height - m_head));
+
+    if (m_head > 0)
+    {
+      p.drawPixmap(QRectF(0, 30 + split, m_w, m_head / ratio),
+                   m_WaterfallPixmap,
+                   QRectF(0, 0, width, m_head));
+    }
+  }
+
+  // The overlay goes over the bottom of the waterfall, as the spectrum
+  // always has.
+
+  p.drawPixmap(0, m_h1, m_OverlayPixmap);
+
+  // Spectrum line, over the overlay; drawn here rather than into a copy of
+  // the overlay, since we'd have to draw it in any event. We work around
+  // what seems to be a performance bug in all versions of Qt up to and
+  // including 6.8, when drawing large polylines; this was culled from the
+  // Qwt library's workaround for the issue. Doubles overall program
+  // performance, pretty much.
+
+  if (!m_points.isEmpty())
+  {
+    p.save();
+    p.setClipRect(0, m_h1, m_w, m_h2);
+    p.translate(0, m_h1);
+    p.setPen(m_pointsColor);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    for (qsizetype i  = 0;
+                   i  < m_points.size();
+                   i += POLYLINE_SIZE)
+    {
+      p.drawPolyline(m_points.data() + i, qMin(POLYLINE_SIZE   + 1,
+                                               m_points.size() - i));
+    }
+
+    p.restore();
+  }
 
   p.drawPixmap(xFromFreq(m_freq), 30, m_DialPixmap[0]);
 
@@ -164,17 +217,62 @@ CPlotter::resizeEvent(QResizeEvent *)
   m_resizeTimer->start();
 }
 
+// Advance the head of the waterfall ring by a row, returning the row,
+// in device pixels, which is now the newest, and which the caller should
+// draw into.
+
+int
+CPlotter::advance()
+{
+  auto const height = m_WaterfallPixmap.height();
+
+  return m_head = height > 0 ? (m_head + height - 1) % height : 0;
+}
+
+// Draw something anchored at the newest row of the waterfall, in logical
+// coordinates relative to it, e.g., decode markers and line text. These
+// extend into older rows, which might be on the other side of the wrap
+// point of the ring, so we draw twice; once relative to the head, and
+// again a ring's height above it, where all but the part that wrapped
+// will be clipped.
+
+template <typename Draw>
+void
+CPlotter::decorate(Draw const & draw)
+{
+  if (m_WaterfallPixmap.isNull()) return;
+
+  QPainter p(&m_WaterfallPixmap);
+
+  auto const ratio  = m_WaterfallPixmap.devicePixelRatio();
+  auto const height = m_WaterfallPixmap.height();
+
+  for (auto const offset : {m_head, m_head - height})
+  {
+    p.resetTransform();
+    p.scale(1, 1 / ratio);
+    p.translate(0, offset);
+    p.scale(1, ratio);
+
+    draw(p);
+  }
+}
+
 void
 CPlotter::drawLine(QString const & text)
 {
-  m_WaterfallPixmap.scroll(0, 1, m_WaterfallPixmap.rect());
+  if (m_WaterfallPixmap.isNull()) return;
+  if (m_stale) replot();
+
+  auto const y = advance();
 
   QPainter p(&m_WaterfallPixmap);
 
   // Draw a green line across the complete span.
 
+  p.scale(1, 1 / m_WaterfallPixmap.devicePixelRatio());
   p.setPen(Qt::green);
-  p.drawLine(0, 0, m_w, 0);
+  p.drawLine(0, y, m_WaterfallPixmap.width(), y);
 
   // Compute the number of lines required before we need to draw the
   // text, and note the text to draw, saving it against a potential
@@ -191,21 +289,29 @@ void
 CPlotter::drawData(WF::SWide       swide,
                    WF::State const state)
 {
-  m_WaterfallPixmap.scroll(0, 1, m_WaterfallPixmap.rect());
+  if (m_WaterfallPixmap.isNull()) return;
+  if (m_stale) replot();
 
   // Flattening, we just process the visible width; tends to be the best
   // approach in terms of what happens when resizing to a larger size.
 
   m_flatten(swide.data(), m_w);
 
-  // Display the data in the waterfall, drawing only the displayed range.
+  // Display the data in the newest row of the waterfall, drawing only the
+  // displayed range.
 
-  QPainter p(&m_WaterfallPixmap);
-  
-  for (auto x = 0; x < m_w; ++x)
   {
-    p.setPen(m_colors[m_scaler1D(swide[x])]);
-    p.drawPoint(x, 0);
+    auto const y = advance();
+
+    QPainter p(&m_WaterfallPixmap);
+
+    p.scale(1, 1 / m_WaterfallPixmap.devicePixelRatio());
+
+    for (auto x = 0; x < m_w; ++x)
+    {
+      p.setPen(m_colors[m_scaler1D(swide[x])]);
+      p.drawPoint(x, y);
+    }
   }
 
   // See if we've reached the point where we should draw previously computed
@@ -215,20 +321,19 @@ CPlotter::drawData(WF::SWide       swide,
   {
     m_line = std::numeric_limits<int>::max();
 
-    p.setPen(Qt::white);
-    p.drawText(5, p.fontMetrics().ascent(), m_text);
+    decorate([&text = std::as_const(m_text)](QPainter & p)
+    {
+      p.setPen(Qt::white);
+      p.drawText(5, p.fontMetrics().ascent(), text);
+    });
   }
 
   // A number of factors determine whether or not we should draw the spectrum.
 
   if (shouldDrawSpectrum(state))
   {
-    // We draw the spectrum by copying the overlay prototype and drawing our
-    // points into it.
-
-    m_SpectrumPixmap = m_OverlayPixmap.copy();
-
-    QPainter p(&m_SpectrumPixmap);
+    // We compute the spectrum line here, but it's drawn over the overlay at
+    // paint time.
 
     // Add a point to the polyline.
 
@@ -277,7 +382,7 @@ CPlotter::drawData(WF::SWide       swide,
 
       case Spectrum::Current:
       {
-        p.setPen(Qt::green);
+        m_pointsColor = Qt::green;
 
         auto const min = *std::min_element(swide.begin(),
                                            swide.begin() + m_w);
@@ -291,7 +396,7 @@ CPlotter::drawData(WF::SWide       swide,
 
       case Spectrum::Cumulative:
       {
-        p.setPen(Qt::cyan);
+        m_pointsColor = Qt::cyan;
         addPoints(std::begin(specData.savg), [](auto const value)
         {
           return 30.0f + 10.0f * std::log10(value);
@@ -304,7 +409,7 @@ CPlotter::drawData(WF::SWide       swide,
       
       case Spectrum::LinearAvg:
       {
-        p.setPen(Qt::yellow);
+        m_pointsColor = Qt::yellow;
         addPoints(std::begin(specData.slin), [](auto const value)
         {
           return value;
@@ -313,23 +418,10 @@ CPlotter::drawData(WF::SWide       swide,
       break;
     }
 
-    // Draw the spectrum line, reducing the resulting points prior to
-    // drawing them, but keeping the collection capacity. We also work
-    // around what seems to be a performance bug in all versions of Qt
-    // up to and including 6.8, when drawing large polylines; this was
-    // culled from the Qwt library's workaround for the issue. Doubles
-    // overall program performance, pretty much.
+    // Reduce the resulting points prior to drawing them, but keep the
+    // collection capacity.
 
     m_points.erase(m_rdp(m_points), m_points.end());
-    p.setRenderHint(QPainter::Antialiasing);
-
-    for (qsizetype i  = 0;
-                   i  < m_points.size();
-                   i += POLYLINE_SIZE)
-    {
-      p.drawPolyline(m_points.data() + i, qMin(POLYLINE_SIZE   + 1,
-                                               m_points.size() - i));
-    }
   }
 
   // Save the data against a potential replot requirement.
@@ -339,20 +431,61 @@ CPlotter::drawData(WF::SWide       swide,
   update();
 }
 
+// While nobody can see the waterfall, there's no point in painting it;
+// just record what we'd have drawn in the replot buffer, and the first
+// draw once we're visible again will bring the display up to date with
+// a single replot.
+
+void
+CPlotter::deferLine(QString const & text)
+{
+  if (m_WaterfallPixmap.isNull()) return;
+
+  m_line  = std::numeric_limits<int>::max();
+  m_stale = true;
+  m_replot.push_front(text);
+}
+
+void
+CPlotter::deferData(WF::SWide swide)
+{
+  if (m_WaterfallPixmap.isNull()) return;
+
+  m_flatten(swide.data(), m_w);
+
+  m_stale = true;
+  m_replot.push_front(std::move(swide));
+}
+
+MemoryAccounting::Usage
+CPlotter::replotUsage() const
+{
+  MemoryAccounting::Usage usage {static_cast<qsizetype>(m_replot.size()),
+                                 static_cast<qsizetype>(m_replot.capacity() * sizeof(Replot::value_type))};
+
+  for (auto const & row : m_replot)
+  {
+    if (auto const text = std::get_if<QString>(&row)) usage.bytes += MemoryAccounting::heap(*text);
+  }
+
+  return usage;
+}
+
 void
 CPlotter::drawDecodeLine(QColor const & color,
                          int    const   ia,
                          int    const   ib)
 {
-  auto const x1 = xFromFreq(ia);
-  auto const x2 = xFromFreq(ib);
+  auto const x1 = qMin(xFromFreq(ia), xFromFreq(ib));
+  auto const x2 = qMax(xFromFreq(ia), xFromFreq(ib));
 
-  QPainter p(&m_WaterfallPixmap);
-  
-  p.setPen(color);
-  p.drawLine(qMin(x1, x2), 4, qMax(x1, x2), 4);
-  p.drawLine(qMin(x1, x2), 0, qMin(x1, x2), 9);
-  p.drawLine(qMax(x1, x2), 0, qMax(x1, x2), 9);
+  decorate([&color, x1, x2](QPainter & p)
+  {
+    p.setPen(color);
+    p.drawLine(x1, 4, x2, 4);
+    p.drawLine(x1, 0, x1, 9);
+    p.drawLine(x2, 0, x2, 9);
+  });
 }
 
 void
@@ -360,10 +493,11 @@ CPlotter::drawHorizontalLine(QColor const & color,
                              int    const   x,
                              int    const   width)
 {
-  QPainter p(&m_WaterfallPixmap);
-
-  p.setPen(color);
-  p.drawLine(x, 0, width <= 0 ? m_w : x + width, 0);
+  decorate([&color, x, end = width <= 0 ? m_w : x + width](QPainter & p)
+  {
+    p.setPen(color);
+    p.drawLine(x, 0, end, 0);
+  });
 }
 
 void
@@ -607,9 +741,12 @@ CPlotter::replot()
   if (m_WaterfallPixmap.isNull()) return;
 
   // Whack anything currently in the waterfall pixmap; we must do this
-  // before attaching a painter.
+  // before attaching a painter. We redraw from the top down, so the ring
+  // starts over with its head at the top.
 
   m_WaterfallPixmap.fill(Qt::black);
+  m_head  = 0;
+  m_stale = false;
 
   // We need to consider that entries have been added to the replot
   // buffer at a rate proportional to the display pixel ratio, i.e.,
@@ -732,11 +869,9 @@ CPlotter::resize()
     drawFilter();
     drawMetrics();
 
-    // The overlay pixmap acts as a prototype for the spectrum pixmap;
-    // each time we draw the spectrum, we do so by first making a copy
-    // of the overlay, then drawing the spectrum line into it.
+    // Any spectrum line we have was computed for the previous size.
 
-    m_SpectrumPixmap = m_OverlayPixmap.copy();
+    m_points.clear();
 
     replot();
   }
@@ -23,6 +23,7 @@
 #include <QWidget>
 #include <boost/circular_buffer.hpp>
 #include "Flatten.hpp"
+#include "MemoryAccounting.hpp"
 #include "RDP.hpp"
 #include "WF.hpp"
 
@@ -144,6 +145,10 @@ public:
     return static_cast<int>(freqFromX(x));
   }
 
+  // Rows held for replotting; the buffer's allocated to its capacity.
+
+  MemoryAccounting::Usage replotUsage() const;
+
   // Inline manipulators
 
   void setFlatten   (bool     const flatten   ) { m_flatten(flatten);             } 
@@ -155,6 +160,8 @@ public:
 
   void drawLine(QString const &);
   void drawData(WF::SWide, WF::State);
+  void deferLine(QString const &);
+  void deferData(WF::SWide);
   void drawDecodeLine    (const QColor &, int, int);
   void drawHorizontalLine(const QColor &, int, int);
   void setBinsPerPixel(int);
@@ -213,6 +220,10 @@ private:
   void drawDials();
   void replot();
   void resize();
+  int  advance();
+
+  template <typename Draw>
+  void decorate(Draw const &);
 
   // Data members ** ORDER DEPENDENCY **
 
@@ -231,7 +242,9 @@ private:
   int    m_w             =  0;
   int    m_h1            =  0;
   int    m_h2            =  0;
+  int    m_head          =  0;
   bool   m_filterEnabled = false;
+  bool   m_stale         = false;
   float  m_freqPerPixel;
 
   RDP       m_rdp;
@@ -240,6 +253,7 @@ private:
   Colors    m_colors;
   Replot    m_replot;
   QPolygonF m_points;
+  QColor    m_pointsColor;
   Flatten   m_flatten;
   Spectrum  m_spectrum = Spectrum::Current;
   QTimer  * m_replotTimer;
@@ -248,7 +262,6 @@ private:
   QPixmap m_ScalePixmap;
   QPixmap m_WaterfallPixmap;
   QPixmap m_OverlayPixmap;
-  QPixmap m_SpectrumPixmap;
   
   std::array<QPixmap, 2> m_FilterPixmap = {};
   std::array<QPixmap, 2> m_DialPixmap   = {};
@@ -0,0 +1,492 @@
+#include <atomic>
+#include <thread>
+#include <QtTest>
+#include <QDateTime>
+#include <QFile>
+#include <QMap>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimeZone>
+#include <QVariant>
+#include "fileutils.h"
+#include "logbook/adif.h"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using Fields = QMap<QString, QVariant>;
+
+  QDateTime const ON  = QDateTime(QDate(2024, 3, 9), QTime(14,  5,  7), QTimeZone::utc());
+  QDateTime const OFF = QDateTime(QDate(2024, 3, 9), QTime(14, 12, 59), QTimeZone::utc());
+
+  // The encoder that QSOToADIF() replaced, as it was, other than being a
+  // free function.
+
+  QByteArray
+  oldQSOToADIF(QString const& hisCall, QString const& hisGrid, QString const& mode, QString const& submode
+               , QString const& rptSent, QString const& rptRcvd, QDateTime const& dateTimeOn
+               , QDateTime const& dateTimeOff, QString const& band, QString const& comments
+               , QString const& name, QString const& strDialFreq, QString const& m_myCall
+               , QString const& m_myGrid, QString const& operator_call, QMap<QString, QVariant> const &additionalFields)
+  {
+    QString t;
+    t = "<call:" + QString::number(hisCall.length()) + ">" + hisCall;
+    t += " <gridsquare:" + QString::number(hisGrid.length()) + ">" + hisGrid;
+    t += " <mode:" + QString::number(mode.length()) + ">" + mode;
+    if(!submode.isEmpty()){
+      t += " <submode:" + QString::number(submode.length()) + ">" + submode;
+    }
+    t += " <rst_sent:" + QString::number(rptSent.length()) + ">" + rptSent;
+    t += " <rst_rcvd:" + QString::number(rptRcvd.length()) + ">" + rptRcvd;
+    t += " <qso_date:8>" + dateTimeOn.date().toString("yyyyMMdd");
+    t += " <time_on:6>" + dateTimeOn.time().toString("hhmmss");
+    t += " <qso_date_off:8>" + dateTimeOff.date().toString("yyyyMMdd");
+    t += " <time_off:6>" + dateTimeOff.time().toString("hhmmss");
+    t += " <band:" + QString::number(band.length()) + ">" + band;
+    t += " <freq:" + QString::number(strDialFreq.length()) + ">" + strDialFreq;
+    t += " <station_callsign:" + QString::number(m_myCall.length()) + ">" +
+        m_myCall;
+    t += " <my_gridsquare:" + QString::number(m_myGrid.length()) + ">" +
+        m_myGrid;
+    if (comments != "")
+      t += " <comment:" + QString::number(comments.length()) +
+          ">" + comments;
+    if (name != "")
+      t += " <name:" + QString::number(name.length()) +
+          ">" + name;
+    if (operator_call!="")
+        t+=" <operator:" + QString::number(operator_call.length()) +
+                ">" + operator_call;
+
+    foreach(auto key, additionalFields.keys()){
+        auto k = key.toUpper();
+        auto value = additionalFields[k].toString();
+
+        if(ADIF_FIELDS.contains(k)){
+          t += QString(" <%1:%2>%3").arg(k).arg(value.length()).arg(value);
+        } else {
+          t += QString(" <APP_JS8CALL_%1:%2>%3").arg(k).arg(value.length()).arg(value);
+        }
+    }
+
+    return t.toLatin1 ();
+  }
+
+  // The way addQSOToFile() used to append a record, through a text stream.
+
+  bool
+  oldAddQSOToFile(QString    const & filename,
+                  QByteArray const & ADIF_record)
+  {
+      QFile f2(filename);
+      if (!f2.open(QIODevice::Text | QIODevice::Append))
+          return false;
+      else
+      {
+          QTextStream out(&f2);
+          if (f2.size()==0)
+              out << "JS8Call ADIF Export<eoh>" << Qt::endl;  // new file
+
+          out << ADIF_record << " <eor>" << Qt::endl;
+          out.flush();
+          flushFileBuffer(f2);
+          f2.close();
+      }
+      return true;
+  }
+
+  // QSOs to encode, one per row; between them, text that is and isn't
+  // representable in Latin-1, every optional field left empty, and
+  // additional fields both standard and not. The log is read back as
+  // UTF-8, so only plain text survives the trip through it unchanged.
+
+  void
+  addQSOs()
+  {
+    QTest::addColumn<QString>("call");
+    QTest::addColumn<QString>("submode");
+    QTest::addColumn<QString>("rptSent");
+    QTest::addColumn<QString>("comments");
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("operatorCall");
+    QTest::addColumn<Fields>("additionalFields");
+    QTest::addColumn<bool>("plain");
+
+    QTest::newRow("plain")
+      << "K1ABC" << "NORMAL" << "-12" << "Nice signal" << "Bob" << "N0OP"
+      << Fields {} << true;
+    QTest::newRow("empty optional fields")
+      << "K1ABD" << "" << "" << "" << "" << ""
+      << Fields {} << true;
+    QTest::newRow("latin-1")
+      << "DL1ABC" << "FAST" << "+03" << QString {"73 de Ångström"} << QString {"Jürgen"} << ""
+      << Fields {} << false;
+    QTest::newRow("not latin-1")
+      << "SV1ABC" << "" << "-20" << QString {"日本語 \U0001F600"} << QString {"Σωκράτης"} << ""
+      << Fields {} << false;
+    QTest::newRow("additional fields")
+      << "W1ABC" << "SLOW" << "-05" << "" << "Ann" << ""
+      << Fields {{"STATE", "MA"}, {"TX_PWR", 5}, {"RELAY_PATH", "W1ABC>K1ABC"}, {"EMPTY", ""}} << true;
+  }
+
+  QByteArray
+  newQSOToADIF(ADIF           & adif,
+               QString  const & call,
+               QString  const & submode,
+               QString  const & rptSent,
+               QString  const & comments,
+               QString  const & name,
+               QString  const & operatorCall,
+               Fields   const & additionalFields)
+  {
+    return adif.QSOToADIF(call, "FN42", "MFSK", submode, rptSent, "-09", ON, OFF, "20m",
+                          comments, name, "14.078000", "N0CALL", "EM48", operatorCall, additionalFields);
+  }
+
+  // A log of the number of QSOs given, written in one go, as addQSOToFile()
+  // would have written them a record at a time; a QSO with each of a few
+  // thousand calls, over and over, as a long-running station's log has.
+
+  constexpr int CALLS = 5000;
+
+  QString
+  logCall(int const qso)
+  {
+    return QString {"K%1ABC"}.arg(qso % CALLS);
+  }
+
+  bool
+  writeLog(ADIF          & adif,
+           QString const & filename,
+           int     const   count)
+  {
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+      return false;
+
+    file.write("JS8Call ADIF Export<eoh>\n");
+
+    for (int i = 0; i < count; ++i)
+    {
+      file.write(newQSOToADIF(adif, logCall(i), "NORMAL", "-12", "", "Bob", "", Fields {}) + " <eor>\n");
+    }
+
+    return file.flush();
+  }
+
+  // What load() makes of a record written by newQSOToADIF().
+
+  ADIF::QSO
+  loaded(QString const & call)
+  {
+    return {call, "20m", "MFSK", "NORMAL", "FN42", "20240309", "Bob", ""};
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestADIF : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // The record is byte for byte what the old encoder produced, characters
+  // outside Latin-1 included; they're '?', one per UTF-16 code unit.
+
+  void
+  encoder_data()
+  {
+    addQSOs();
+  }
+
+  void
+  encoder()
+  {
+    QFETCH(QString, call);
+    QFETCH(QString, submode);
+    QFETCH(QString, rptSent);
+    QFETCH(QString, comments);
+    QFETCH(QString, name);
+    QFETCH(QString, operatorCall);
+    QFETCH(Fields,  additionalFields);
+
+    ADIF adif;
+
+    // After a longer record, since the buffer is reused; nothing of that
+    // one may show up in this one.
+
+    newQSOToADIF(adif, "VE3ABCDEF", "NORMAL", "-12", QString(200, 'x'), "Somebody", "VE3OP",
+                 Fields {{"STATE", "ON"}, {"RELAY_PATH", "VE3ABCDEF>K1ABC>W1ABC"}});
+
+    QCOMPARE(newQSOToADIF(adif, call, submode, rptSent, comments, name, operatorCall, additionalFields),
+             oldQSOToADIF(call, "FN42", "MFSK", submode, rptSent, "-09", ON, OFF, "20m",
+                          comments, name, "14.078000", "N0CALL", "EM48", operatorCall, additionalFields));
+  }
+
+  // Additional fields are written with their own values, whatever the case
+  // of their keys; the old encoder looked them up again by upper-cased key,
+  // and so left them empty unless they were upper case already.
+
+  void
+  additionalFieldKeys()
+  {
+    ADIF adif;
+
+    auto const record = newQSOToADIF(adif, "W1ABC", "", "-05", "", "", "",
+                                     Fields {{"state", "MA"}, {"relay_path", "W1ABC>K1ABC"}});
+
+    QVERIFY(record.contains(" <STATE:2>MA"));
+    QVERIFY(record.contains(" <APP_JS8CALL_RELAY_PATH:11>W1ABC>K1ABC"));
+    QCOMPARE(record,
+             oldQSOToADIF("W1ABC", "FN42", "MFSK", "", "-05", "-09", ON, OFF, "20m",
+                          "", "", "14.078000", "N0CALL", "EM48", "",
+                          Fields {{"STATE", "MA"}, {"RELAY_PATH", "W1ABC>K1ABC"}}));
+  }
+
+  // Appended to a log, the record loads as the old one did when appended
+  // the old way, and, where the text is plain, as what was logged.
+
+  void
+  roundTrip_data()
+  {
+    addQSOs();
+  }
+
+  void
+  roundTrip()
+  {
+    QFETCH(QString, call);
+    QFETCH(QString, submode);
+    QFETCH(QString, rptSent);
+    QFETCH(QString, comments);
+    QFETCH(QString, name);
+    QFETCH(QString, operatorCall);
+    QFETCH(Fields,  additionalFields);
+    QFETCH(bool,    plain);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ADIF adif;
+    adif.init(dir.filePath("new.adi"));
+
+    auto const record = newQSOToADIF(adif, call, submode, rptSent, comments, name, operatorCall, additionalFields);
+
+    QVERIFY(adif.addQSOToFile(record));
+    QVERIFY(oldAddQSOToFile(dir.filePath("old.adi"),
+                            oldQSOToADIF(call, "FN42", "MFSK", submode, rptSent, "-09", ON, OFF, "20m",
+                                         comments, name, "14.078000", "N0CALL", "EM48", operatorCall, additionalFields)));
+
+    ADIF old;
+    old.init(dir.filePath("old.adi"));
+    old.load();
+    adif.load();
+
+    QCOMPARE(adif.getCount(), qsizetype {1});
+    QCOMPARE(adif.find(call), old.find(call));
+
+    auto const qso = adif.find(call).value(0);
+
+    QCOMPARE(qso.call,    call);
+    QCOMPARE(qso.band,    QString {"20m"});
+    QCOMPARE(qso.mode,    QString {"MFSK"});
+    QCOMPARE(qso.submode, submode);
+    QCOMPARE(qso.grid,    QString {"FN42"});
+    QCOMPARE(qso.date,    QString {"20240309"});
+
+    if (plain)
+    {
+      QCOMPARE(qso.name,    name);
+      QCOMPARE(qso.comment, comments);
+    }
+  }
+
+  // Records appended in turn load as the same records appended the old
+  // way; each goes after the last, with the header only before the first.
+
+  void
+  append()
+  {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ADIF adif;
+    adif.init(dir.filePath("new.adi"));
+
+    QList<QByteArray> records;
+    QStringList       calls;
+
+    for (int i = 0; i < 10; ++i)
+    {
+      auto const call = QString {"K%1ABC"}.arg(i);
+      auto const name = i % 2 ? QString {"Jürgen"} : QString {"Bob"};
+
+      records << newQSOToADIF(adif, call, "NORMAL", "-12", "", name, "", Fields {{"STATE", "MA"}});
+      calls   << call;
+
+      QVERIFY(adif.addQSOToFile(records.last()));
+      QVERIFY(oldAddQSOToFile(dir.filePath("old.adi"), records.last()));
+    }
+
+    ADIF old;
+    old.init(dir.filePath("old.adi"));
+    old.load();
+    adif.load();
+
+    QCOMPARE(adif.getCount(), qsizetype {10});
+    QCOMPARE(adif.getCount(), old.getCount());
+
+    for (auto const & call : calls)
+    {
+      QCOMPARE(adif.find(call), old.find(call));
+    }
+  }
+
+  // A record appended to the log after load() has read it, but before the
+  // snapshot's saved, leaves the snapshot stale; it's not missing the QSO
+  // while matching the log. Adding the QSO to it, as a QSO logged while the
+  // log loads is, brings it up to date.
+
+  void
+  snapshotAppendAfterLoad()
+  {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ADIF adif;
+    adif.init(dir.filePath("log.adi"));
+    QVERIFY(writeLog(adif, adif.filename(), 10));
+    adif.load();
+
+    ADIF writer;
+    writer.init(adif.filename());
+
+    auto const record = newQSOToADIF(writer, "W1XYZ", "NORMAL", "-12", "", "Bob", "", Fields {});
+    QVERIFY(writer.addQSOToFile(record));
+    QVERIFY(adif.saveSnapshot());
+
+    ADIF snapshot;
+    snapshot.init(adif.filename());
+    QVERIFY(!snapshot.loadSnapshot());
+
+    QVERIFY(adif.addToSnapshot(loaded("W1XYZ"), record));
+    QVERIFY(snapshot.loadSnapshot());
+    QCOMPARE(snapshot.getCount(), qsizetype {11});
+    QCOMPARE(snapshot.find("W1XYZ"), QList<ADIF::QSO> {loaded("W1XYZ")});
+  }
+
+  // Records appended to the log while load() is reading it, and after, up
+  // until the snapshot's saved; however many of them load() read, the
+  // snapshot doesn't match the log, and were it to, it'd have every QSO
+  // that parsing the log does.
+
+  void
+  snapshotAppendDuringLoad()
+  {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ADIF adif;
+    adif.init(dir.filePath("log.adi"));
+    QVERIFY(writeLog(adif, adif.filename(), 20000));
+
+    std::atomic<int>  appended {0};
+    std::atomic<bool> done     {false};
+
+    std::thread writer([&]()
+    {
+      ADIF writer;
+      writer.init(adif.filename());
+
+      // one more once we're done, so there's always one load() didn't read
+      for (bool last = false; !last; ++appended)
+      {
+        last = done;
+        writer.addQSOToFile(newQSOToADIF(writer, QString {"W%1XYZ"}.arg(appended.load()), "NORMAL", "-12", "", "Bob", "", Fields {}));
+      }
+    });
+
+    while (!appended) std::this_thread::yield();
+
+    adif.load();
+    done = true;
+    writer.join();
+
+    QVERIFY(adif.saveSnapshot());
+
+    ADIF snapshot;
+    snapshot.init(adif.filename());
+
+    ADIF parsed;
+    parsed.init(adif.filename());
+    parsed.load();
+
+    qInfo("%d records appended, %lld read by load()",
+          appended.load(),
+          static_cast<long long>(adif.getCount() - 20000));
+
+    QCOMPARE(parsed.getCount(), qsizetype {20000 + appended.load()});
+    QVERIFY(adif.getCount() < parsed.getCount());
+    QVERIFY(!snapshot.loadSnapshot());
+  }
+
+  // Time to what the main window needs of a long-running station's log;
+  // reading the snapshot, all it waits for before answering worked-before
+  // queries, and parsing the log in full, which it no longer waits for.
+  // This runs once under ctest, run the test directly, e.g., with
+  // -median 5, to measure it.
+
+  void
+  benchmarkStartup_data()
+  {
+    QTest::addColumn<bool>("snapshot");
+
+    QTest::newRow("first window (snapshot)") << true;
+    QTest::newRow("full log (parse)")        << false;
+  }
+
+  void
+  benchmarkStartup()
+  {
+    constexpr int QSOS = 250000;
+
+    QFETCH(bool, snapshot);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ADIF adif;
+    adif.init(dir.filePath("log.adi"));
+    QVERIFY(writeLog(adif, adif.filename(), QSOS));
+
+    if (snapshot)
+    {
+      adif.load();
+      QVERIFY(adif.saveSnapshot());
+    }
+
+    bool current = false;
+
+    QBENCHMARK
+    {
+      adif.init(dir.filePath("log.adi"));
+
+      if (snapshot) current = adif.loadSnapshot();
+      else          adif.load();
+    }
+
+    QCOMPARE(current, snapshot);
+    QCOMPARE(adif.getCount(), qsizetype {QSOS});
+    QCOMPARE(adif.find(logCall(0)).size(), qsizetype {QSOS / CALLS});
+  }
+};
+
+QTEST_APPLESS_MAIN(TestADIF)
+
+#include "test_ADIF.moc"
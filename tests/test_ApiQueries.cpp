@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QList>
+#include <QMap>
+#include <QSemaphore>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVariantMap>
+#include "ApiQueries.hpp"
+#include "Inbox.h"
+#include "Message.hpp"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  // A handful of scripts polling the expensive queries as fast as they can,
+  // against the call activity of a busy band, for a few seconds; meanwhile
+  // a timer on the GUI thread notes how late it fires, which is how long
+  // the GUI would have been unresponsive.
+
+  constexpr int    CLIENTS   = 8;
+  constexpr int    CALLS     = 2000;
+  constexpr int    POLL      = 20;     // ms between each client's requests
+  constexpr int    HEARTBEAT = 10;     // ms
+  constexpr qint64 DURATION  = 3000;   // ms
+
+  QStringList const TYPES =
+  {
+    "RX.GET_CALL_ACTIVITY",
+    "RX.GET_BAND_ACTIVITY",
+    "INBOX.GET_MESSAGES"
+  };
+
+  // Stand-in for the call activity the queries take a snapshot of.
+
+  struct Call
+  {
+    QString call;
+    QString grid;
+    int     snr;
+    qint64  utc;
+  };
+
+  using Calls = QMap<QString, Call>;
+
+  Calls
+  activity()
+  {
+    Calls calls;
+
+    for (int i = 0; i < CALLS; ++i)
+    {
+      auto const call = QString {"KB%1XYZ"}.arg(i);
+      calls.insert(call, {call, QString {"FN%1"}.arg(i % 100, 2, 10, QChar {'0'}), i % 30 - 24, 1710000000000 + i * 1000});
+    }
+
+    return calls;
+  }
+
+  Message
+  request(QString const & type,
+          qint64  const   id)
+  {
+    return Message(type, "", {{"_ID", QVariant(id)}});
+  }
+
+  // Builds the reply from its snapshot, as RX.GET_CALL_ACTIVITY does.
+
+  ApiQueries::Query
+  query(qint64 const id,
+        Calls  const calls)
+  {
+    return [id, calls]()
+    {
+      QVariantMap reply = {
+        {"_ID", id},
+      };
+
+      for (auto const & cd : calls)
+      {
+        QVariantMap detail;
+        detail["SNR"]  = QVariant(cd.snr);
+        detail["GRID"] = QVariant(cd.grid);
+        detail["UTC"]  = QVariant(cd.utc);
+        reply[cd.call] = QVariant(detail);
+      }
+
+      return Message("RX.CALL_ACTIVITY", "", reply);
+    };
+  }
+
+  // What happened over a polling run.
+
+  struct Load
+  {
+    int    asked    = 0;
+    int    accepted = 0;
+    int    limited  = 0;
+    int    replies  = 0;
+    qint64 minRetry = std::numeric_limits<qint64>::max();
+    qint64 maxRetry = 0;
+    qint64 maxStall = 0;    // ms the heartbeat fired late, at worst
+  };
+
+  // Poll for the duration; through ApiQueries, or, as before it, answering
+  // every request on the GUI thread as it arrives. Either way, sending the
+  // reply, i.e., serializing it, happens on the GUI thread.
+
+  Load
+  poll(bool const throughQueries)
+  {
+    auto const calls = activity();
+
+    Load          load;
+    ApiQueries    queries;
+    QElapsedTimer clock;
+    qint64        beat = 0;
+    qint64        id   = 0;
+
+    QObject::connect(&queries, &ApiQueries::ready, [&load](Message const & reply)
+    {
+      reply.toJson();
+      load.replies += 1;
+    });
+
+    QTimer heartbeat;
+    QObject::connect(&heartbeat, &QTimer::timeout, [&]()
+    {
+      auto const now = clock.elapsed();
+      load.maxStall  = std::max(load.maxStall, now - beat - HEARTBEAT);
+      beat           = now;
+    });
+
+    QTimer poller;
+    QObject::connect(&poller, &QTimer::timeout, [&]()
+    {
+      for (int client = 0; client < CLIENTS; ++client)
+      {
+        for (auto const & type : TYPES)
+        {
+          auto const message = request(type, ++id);
+
+          load.asked += 1;
+
+          if (throughQueries)
+          {
+            if (auto const retry = queries.submit(QString {"client%1"}.arg(client), message, query(message.id(), calls)))
+            {
+              load.limited  += 1;
+              load.minRetry  = std::min(load.minRetry, retry);
+              load.maxRetry  = std::max(load.maxRetry, retry);
+            }
+            else
+            {
+              load.accepted += 1;
+            }
+          }
+          else
+          {
+            load.accepted += 1;
+            query(message.id(), calls)().toJson();
+            load.replies  += 1;
+          }
+        }
+      }
+    });
+
+    QEventLoop loop;
+
+    clock.start();
+    heartbeat.start(HEARTBEAT);
+    poller.start(POLL);
+
+    QTimer::singleShot(DURATION, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    poller.stop();
+
+    // Let what was accepted finish.
+
+    QTest::qWaitFor([&load]() { return load.replies == load.accepted; }, 10000);
+
+    return load;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestApiQueries : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // A client may have one query of a type in flight, and may ask again only
+  // after the minimum interval; other clients, and other types, aren't held
+  // up by it. Replies come back in the order asked.
+
+  void
+  limits()
+  {
+    ApiQueries     queries;
+    QList<Message> replies;
+    QSemaphore     gate;
+
+    connect(&queries, &ApiQueries::ready, [&replies](Message const & reply) { replies << reply; });
+
+    auto const blocked = [&gate]() { gate.acquire(); return Message("X.REPLY", "1"); };
+    auto const quick   = [](QString const & value) { return [value]() { return Message("X.REPLY", value); }; };
+
+    QCOMPARE(queries.submit("a", request("X.GET", 1), blocked), qint64 {0});
+    QCOMPARE(queries.submit("a", request("X.GET", 2), quick("2")), ApiQueries::MIN_INTERVAL_MS);
+    QCOMPARE(queries.submit("b", request("X.GET", 3), quick("3")), qint64 {0});
+    QCOMPARE(queries.submit("a", request("Y.GET", 4), quick("4")), qint64 {0});
+
+    gate.release();
+
+    QTRY_COMPARE(replies.size(), qsizetype {3});
+    QCOMPARE(replies[0].value(), QString {"1"});
+    QCOMPARE(replies[1].value(), QString {"3"});
+    QCOMPARE(replies[2].value(), QString {"4"});
+
+    // No longer in flight, but still within the interval.
+
+    auto const retry = queries.submit("a", request("X.GET", 5), quick("5"));
+
+    QVERIFY(retry > 0);
+    QVERIFY(retry <= ApiQueries::MIN_INTERVAL_MS);
+
+    QTest::qWait(ApiQueries::MIN_INTERVAL_MS + 50);
+
+    QCOMPARE(queries.submit("a", request("X.GET", 6), quick("6")), qint64 {0});
+    QTRY_COMPARE(replies.size(), qsizetype {4});
+  }
+
+  // A query with nothing to say sends nothing; one that fails sends an
+  // error naming the request.
+
+  void
+  errors()
+  {
+    ApiQueries     queries;
+    QList<Message> replies;
+
+    connect(&queries, &ApiQueries::ready, [&replies](Message const & reply) { replies << reply; });
+
+    QCOMPARE(queries.submit("a", request("X.GET", 1), []() { return Message(); }), qint64 {0});
+    QCOMPARE(queries.submit("a", request("Y.GET", 2), []() -> Message { throw std::runtime_error("no inbox"); }), qint64 {0});
+
+    QTRY_COMPARE(replies.size(), qsizetype {1});
+    QCOMPARE(replies[0].type(), QString {"API.ERROR"});
+    QCOMPARE(replies[0].id(), qint64 {2});
+  }
+
+  // A query that finds the inbox locked, as it is while the GUI thread
+  // writes to it, gives up after the busy timeout, rather than the inbox's
+  // usual two seconds, and the client's told to ask again; a query behind
+  // it, from another client, is held up no longer than that.
+
+  void
+  busy()
+  {
+    QTemporaryDir dir;
+    auto const    path = dir.filePath("inbox.db3");
+
+    {
+      Inbox inbox(path);
+      QVERIFY(inbox.open());
+    }
+
+    sqlite3 * writer = nullptr;
+
+    QCOMPARE(sqlite3_open(path.toLocal8Bit().data(), &writer), SQLITE_OK);
+    QCOMPARE(sqlite3_exec(writer, "BEGIN EXCLUSIVE", nullptr, nullptr, nullptr), SQLITE_OK);
+
+    ApiQueries     queries;
+    QList<Message> replies;
+    QElapsedTimer  clock;
+    qint64         behind = 0;
+
+    connect(&queries, &ApiQueries::ready, [&](Message const & reply)
+    {
+      replies << reply;
+      behind = clock.elapsed();
+    });
+
+    clock.start();
+
+    QCOMPARE(queries.submit("a", request("INBOX.GET_MESSAGES", 1), [path]()
+    {
+      Inbox inbox(path);
+      if (!inbox.open(ApiQueries::BUSY_TIMEOUT_MS))
+      {
+        if (inbox.isBusy()) throw ApiQueries::Busy();
+        return Message();
+      }
+      return Message("INBOX.MESSAGES", "");
+    }), qint64 {0});
+    QCOMPARE(queries.submit("b", request("X.GET", 2), []() { return Message("X.REPLY", "2"); }), qint64 {0});
+
+    QTRY_COMPARE(replies.size(), qsizetype {2});
+
+    sqlite3_exec(writer, "COMMIT", nullptr, nullptr, nullptr);
+    sqlite3_close(writer);
+
+    qInfo("query behind a locked inbox answered after %lld ms", behind);
+
+    QCOMPARE(replies[0].type(), QString {"API.ERROR"});
+    QCOMPARE(replies[0].id(), qint64 {1});
+    QCOMPARE(replies[0].params().value("RETRY_MS").toLongLong(), ApiQueries::MIN_INTERVAL_MS);
+    QCOMPARE(replies[1].value(), QString {"2"});
+    QVERIFY(behind >= ApiQueries::BUSY_TIMEOUT_MS);
+    QVERIFY(behind < 1000);
+  }
+
+  // Scripts polling flat out, answered on the GUI thread as before, and
+  // through ApiQueries; reports both. Through ApiQueries, each client gets
+  // a reply to each type of query at most once per interval, every other
+  // request is told when to try again, every accepted query is answered,
+  // and the GUI thread stalls less than it did.
+
+  void
+  pollingLoad()
+  {
+    auto const before = poll(false);
+    auto const after  = poll(true);
+
+    auto const report = [](char const * const name, Load const & load)
+    {
+      qInfo("%s: %d requests, %d answered, %d told to retry in %lld to %lld ms, GUI thread stalled up to %lld ms",
+            name,
+            load.asked,
+            load.replies,
+            load.limited,
+            load.limited ? load.minRetry : 0,
+            load.maxRetry,
+            load.maxStall);
+    };
+
+    report("on the GUI thread", before);
+    report("through ApiQueries", after);
+
+    auto const intervals = static_cast<int>(DURATION / ApiQueries::MIN_INTERVAL_MS) + 1;
+
+    QCOMPARE(after.accepted + after.limited, after.asked);
+    QCOMPARE(after.replies, after.accepted);
+    QVERIFY(after.accepted <= CLIENTS * static_cast<int>(TYPES.size()) * intervals);
+    QVERIFY(after.limited > 0);
+    QVERIFY(after.minRetry > 0);
+    QVERIFY(after.maxRetry <= ApiQueries::MIN_INTERVAL_MS);
+    QVERIFY(after.maxStall < before.maxStall);
+  }
+};
+
+QTEST_GUILESS_MAIN(TestApiQueries)
+
+#include "test_ApiQueries.moc"
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <QtTest>
+#include <QByteArray>
+#include <QRandomGenerator>
+#include "AudioKernels.hpp"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  constexpr float FULL_SCALE = std::numeric_limits<qint16>::max();
+
+  // Output buffers run this far past what should be written, filled with
+  // this; comparing the whole of them catches a kernel that writes past the
+  // end of its output.
+
+  constexpr std::size_t GUARD  = 32;
+  constexpr qint16      MARKER = 0x5a5a;
+
+  // Counts to try; every count up to a few of the widest vectors, so every
+  // length of tail after the last full vector, and a few longer runs.
+
+  std::vector<std::size_t>
+  counts()
+  {
+    std::vector<std::size_t> counts;
+
+    for (std::size_t count = 0; count <= 72;  ++count) counts.push_back(count);
+    for (std::size_t count = 4096; count < 4096 + 33; ++count) counts.push_back(count);
+
+    return counts;
+  }
+
+  // The plain C++ versions, as AudioKernels.cpp has them; the reference for
+  // whichever implementation is in use.
+
+  namespace reference
+  {
+    void
+    deinterleave(qint16 const * in,
+                 std::size_t    frames,
+                 std::size_t    channel,
+                 qint16       * out)
+    {
+      for (in += channel; frames; --frames, in += 2) *out++ = *in;
+    }
+
+    void
+    interleave(qint16 const * in,
+               std::size_t    frames,
+               bool     const left,
+               bool     const right,
+               qint16       * out)
+    {
+      for (; frames; --frames)
+      {
+        auto const sample = *in++;
+        *out++ = left  ? sample : 0;
+        *out++ = right ? sample : 0;
+      }
+    }
+
+    void
+    toInt16(float const * in,
+            std::size_t   count,
+            qint16      * out)
+    {
+      for (; count; --count)
+      {
+        *out++ = static_cast<qint16>(std::lrint(std::clamp(*in++, -1.0f, 1.0f) * FULL_SCALE));
+      }
+    }
+
+    void
+    toFloat(qint16 const * in,
+            std::size_t    count,
+            float        * out)
+    {
+      for (; count; --count) *out++ = *in++ * (1.0f / FULL_SCALE);
+    }
+
+    AudioKernels::Level
+    level(qint16 const * in,
+          std::size_t    count)
+    {
+      AudioKernels::Level level;
+
+      for (; count; --count)
+      {
+        int const sample = *in++;
+        level.sumOfSquares += static_cast<quint64>(sample * sample);
+        level.peak          = std::max(level.peak, std::abs(sample));
+      }
+      return level;
+    }
+  }
+
+  // Random 16-bit samples, with the extremes at the start and the end, where
+  // the vector loops and their tails respectively will see them.
+
+  std::vector<qint16>
+  samples(std::size_t const count)
+  {
+    std::vector<qint16> samples(count);
+
+    auto generator = QRandomGenerator(20240309 + count);
+
+    for (auto & sample : samples)
+    {
+      sample = static_cast<qint16>(generator.bounded(-32768, 32768));
+    }
+
+    for (std::size_t i = 0; i < std::min<std::size_t>(count, 2); ++i)
+    {
+      samples[i]             = std::numeric_limits<qint16>::min();
+      samples[count - 1 - i] = i ? std::numeric_limits<qint16>::max()
+                                 : std::numeric_limits<qint16>::min();
+    }
+
+    return samples;
+  }
+
+  // Random float samples, beyond full scale in both directions, with the
+  // awkward values, i.e., those at and past full scale, those about halfway
+  // between steps, and signed zeros, spread through them.
+
+  std::vector<float>
+  floats(std::size_t const count)
+  {
+    static float const awkward[] =
+    {
+      -2.0f, -1.0f, -0.0f, 0.0f, 1.0f, 2.0f,
+      0.5f / FULL_SCALE, 1.5f / FULL_SCALE, -2.5f / FULL_SCALE,
+      32766.5f / FULL_SCALE, -32766.5f / FULL_SCALE
+    };
+
+    std::vector<float> samples(count);
+
+    auto generator = QRandomGenerator(20240310 + count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      samples[i] = i % 3 ? static_cast<float>(generator.generateDouble() * 2.5 - 1.25)
+                         : awkward[(i / 3) % std::size(awkward)];
+    }
+
+    return samples;
+  }
+
+  template <typename T>
+  std::vector<T>
+  guarded(std::size_t const count)
+  {
+    return std::vector<T>(count + GUARD, T(MARKER));
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestAudioKernels : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Run by ctest once as it comes, and once for each implementation that
+  // may be requested; skip if the one requested can't run here.
+
+  void
+  initTestCase()
+  {
+    auto const requested = qgetenv("JS8CALL_AUDIO_KERNELS");
+    auto const inUse     = QByteArray {AudioKernels::instructionSet()}.toLower();
+
+    qInfo("audio kernels: %s", AudioKernels::instructionSet());
+
+    if (!requested.isEmpty() && requested != inUse)
+    {
+      QSKIP(qPrintable(QString {"%1 isn't available here"}.arg(QString::fromLatin1(requested))));
+    }
+  }
+
+  // Each channel, from unaligned input as well as aligned.
+
+  void
+  deinterleave()
+  {
+    for (auto const count : counts())
+    {
+      for (std::size_t offset = 0; offset < 2; ++offset)
+      {
+        auto const in = samples(2 * count + offset);
+
+        for (std::size_t channel = 0; channel < 2; ++channel)
+        {
+          auto expected = guarded<qint16>(count);
+          auto actual   = guarded<qint16>(count);
+
+          reference::deinterleave(in.data() + offset, count, channel, expected.data());
+          AudioKernels::deinterleave(in.data() + offset, count, channel, actual.data());
+
+          QVERIFY2(actual == expected, qPrintable(QString {"%1 frames, offset %2, channel %3"}.arg(count).arg(offset).arg(channel)));
+        }
+      }
+    }
+  }
+
+  // Each combination of channels, into unaligned output as well as aligned.
+
+  void
+  interleave()
+  {
+    for (auto const count : counts())
+    {
+      auto const in = samples(count);
+
+      for (std::size_t offset = 0; offset < 2; ++offset)
+      {
+        for (int channels = 0; channels < 4; ++channels)
+        {
+          bool const left  = channels & 1;
+          bool const right = channels & 2;
+
+          auto expected = guarded<qint16>(2 * count + offset);
+          auto actual   = guarded<qint16>(2 * count + offset);
+
+          reference::interleave(in.data(), count, left, right, expected.data() + offset);
+          AudioKernels::interleave(in.data(), count, left, right, actual.data() + offset);
+
+          QVERIFY2(actual == expected, qPrintable(QString {"%1 frames, offset %2, left %3, right %4"}.arg(count).arg(offset).arg(int {left}).arg(int {right})));
+        }
+      }
+    }
+  }
+
+  // Clamped and rounded alike, ties and values beyond full scale included.
+
+  void
+  toInt16()
+  {
+    for (auto const count : counts())
+    {
+      auto const in = floats(count + 1);
+
+      for (std::size_t offset = 0; offset < 2; ++offset)
+      {
+        auto expected = guarded<qint16>(count);
+        auto actual   = guarded<qint16>(count);
+
+        reference::toInt16(in.data() + offset, count, expected.data());
+        AudioKernels::toInt16(in.data() + offset, count, actual.data());
+
+        QVERIFY2(actual == expected, qPrintable(QString {"%1 samples, offset %2"}.arg(count).arg(offset)));
+      }
+    }
+  }
+
+  void
+  toFloat()
+  {
+    for (auto const count : counts())
+    {
+      auto const in = samples(count + 1);
+
+      for (std::size_t offset = 0; offset < 2; ++offset)
+      {
+        auto expected = guarded<float>(count);
+        auto actual   = guarded<float>(count);
+
+        reference::toFloat(in.data() + offset, count, expected.data());
+        AudioKernels::toFloat(in.data() + offset, count, actual.data());
+
+        QVERIFY2(actual == expected, qPrintable(QString {"%1 samples, offset %2"}.arg(count).arg(offset)));
+      }
+    }
+  }
+
+  // Exact sums and peaks, including a peak of 32768 in the tail.
+
+  void
+  level()
+  {
+    for (auto const count : counts())
+    {
+      auto const in = samples(count + 1);
+
+      for (std::size_t offset = 0; offset < 2; ++offset)
+      {
+        auto const expected = reference::level(in.data() + offset, count);
+        auto const actual   = AudioKernels::level(in.data() + offset, count);
+
+        QVERIFY2(actual.sumOfSquares == expected.sumOfSquares && actual.peak == expected.peak,
+                 qPrintable(QString {"%1 samples, offset %2"}.arg(count).arg(offset)));
+      }
+    }
+  }
+};
+
+QTEST_APPLESS_MAIN(TestAudioKernels)
+
+#include "test_AudioKernels.moc"
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <iterator>
+#include <QtTest>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include "DecodeSchedule.hpp"
+#include "JS8Submode.hpp"
+#include "commons.h"
+#include "varicode.h"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using Window = DecodeSchedule::Window;
+
+  constexpr qint32 SECOND = JS8_RX_SAMPLE_RATE;
+  constexpr qint32 RING   = JS8_RX_SAMPLE_SIZE;
+  constexpr qint32 EARLY  = 3 * SECOND / 2;
+  constexpr qint32 LATE   = 3 * SECOND / 2;
+
+  constexpr int SUBMODES[] = {
+    Varicode::JS8CallSlow,
+    Varicode::JS8CallNormal,
+    Varicode::JS8CallFast,
+    Varicode::JS8CallTurbo,
+#if JS8_ENABLE_JS8I
+    Varicode::JS8CallUltra,
+#endif
+  };
+
+  // Windows as text, in submode order, so that a mismatch reads sensibly.
+
+  QStringList
+  describe(QList<Window> const & windows)
+  {
+    QStringList list;
+
+    for (auto const & window : windows)
+    {
+      list << QString {"%1:%2+%3"}.arg(window.submode)
+                                  .arg(window.start)
+                                  .arg(window.sz);
+    }
+
+    list.sort();
+    return list;
+  }
+
+  // The rules the schedule replaced, as MainWindow applied them on every
+  // position the detector reported; in a cycle, decode if it's been 3/2
+  // seconds since the last decode and the symbols are complete, or if it's
+  // been a second and we're in the first or last 3/2 seconds of the cycle.
+  // Autosynced submodes were decoded every second over the last cycle's
+  // worth of frames.
+
+  class OldRules
+  {
+    QMap<int, qint32> m_lastDecodeStart;
+
+  public:
+
+    QList<Window>
+    advance(qint32          const   k,
+            QSet<int>       const & everySecond)
+    {
+      QList<Window> windows;
+
+      for (auto const submode : SUBMODES)
+      {
+        qint32 const cycle             = JS8::Submode::computeAltCycleForDecode(submode, k, 0);
+        qint32 const cycleFrames       = JS8::Submode::framesPerCycle(submode);
+        qint32 const cycleFramesNeeded = JS8::Submode::framesForSymbols(submode);
+        qint32       cycleFramesReady  = k - (cycle * cycleFrames);
+        if (cycleFramesReady < 0)
+        {
+          cycleFramesReady = k + (RING - (cycle * cycleFrames));
+        }
+
+        if (!m_lastDecodeStart.contains(submode))
+        {
+          m_lastDecodeStart[submode] = cycle * cycleFrames;
+        }
+
+        qint32 const lastDecodeStart = m_lastDecodeStart[submode];
+        qint32       incrementedBy   = k - lastDecodeStart;
+        if (k < lastDecodeStart)
+        {
+          incrementedBy = RING - lastDecodeStart + k;
+        }
+
+        if (everySecond.contains(submode) && incrementedBy >= SECOND)
+        {
+          qint32 start = k - cycleFrames;
+          if (start < 0) start += RING;
+
+          windows.append({submode, start, cycleFrames});
+          m_lastDecodeStart[submode] = k;
+        }
+        else if ((incrementedBy >= 1.5 * SECOND && cycleFramesReady >= cycleFramesNeeded)              ||
+                 (incrementedBy >= SECOND       && cycleFramesReady >= cycleFramesNeeded - 1.5 * SECOND) ||
+                 (incrementedBy >= SECOND       && cycleFramesReady <  1.5 * SECOND))
+        {
+          windows.append({submode, cycle * cycleFrames, cycleFramesReady});
+          m_lastDecodeStart[submode] = k;
+        }
+      }
+
+      return windows;
+    }
+  };
+
+  // Windows for a single submode out of those returned.
+
+  QList<Window>
+  only(int             const   submode,
+       QList<Window>   const & windows)
+  {
+    QList<Window> list;
+
+    for (auto const & window : windows)
+    {
+      if (window.submode == submode) list.append(window);
+    }
+
+    return list;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestDecodeSchedule : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Nothing's known until the first position arrives, and a reset puts us
+  // back there.
+
+  void
+  unsynced()
+  {
+    DecodeSchedule schedule;
+
+    QVERIFY(schedule.due(0));
+    QCOMPARE(schedule.framesUntilNext(), qint64 {-1});
+
+    schedule.advance(5 * SECOND);
+    QVERIFY(schedule.framesUntilNext() >= 0);
+
+    schedule.reset();
+    QVERIFY(schedule.due(0));
+    QCOMPARE(schedule.framesUntilNext(), qint64 {-1});
+  }
+
+  // Cycle-relative windows start at the start of their cycle, cover the
+  // cycle so far, fall only in its early or late span, and come no more
+  // often than once a second; every late span gets one as it opens, and
+  // every cycle after the first gets one as it starts.
+
+  void
+  spans_data()
+  {
+    QTest::addColumn<int>("submode");
+
+    for (auto const submode : SUBMODES)
+    {
+      QTest::newRow(qPrintable(QString::number(submode))) << submode;
+    }
+  }
+
+  void
+  spans()
+  {
+    QFETCH(int, submode);
+
+    qint32 const cycleFrames = JS8::Submode::framesPerCycle(submode);
+    qint32 const late        = JS8::Submode::framesForSymbols(submode) - LATE;
+    qint32 const step        = SECOND / 4;
+
+    DecodeSchedule schedule;
+    QMap<qint32, QList<qint32>> offsets;  // by cycle start
+    qint32 last = -1;
+
+    for (qint32 k = 0; k < RING; k += step)
+    {
+      for (auto const & window : only(submode, schedule.advance(k)))
+      {
+        QCOMPARE(window.start % cycleFrames, 0);
+        QCOMPARE(window.start + window.sz, k);
+        QVERIFY(window.sz < EARLY || window.sz >= late);
+        QVERIFY(last < 0 || k - last >= SECOND);
+
+        offsets[window.start].append(window.sz);
+        last = k;
+      }
+    }
+
+    QCOMPARE(offsets.size(), qsizetype {RING / cycleFrames});
+
+    for (auto it = offsets.cbegin(); it != offsets.cend(); ++it)
+    {
+      auto const & cycle = it.value();
+
+      if (it.key() > 0)
+      {
+        QVERIFY(cycle.first() < EARLY);
+      }
+
+      auto const firstLate = std::find_if(cycle.cbegin(), cycle.cend(), [late](auto const sz)
+      {
+        return sz >= late;
+      });
+
+      QVERIFY(firstLate != cycle.cend());
+      QVERIFY(*firstLate < late + step);
+    }
+  }
+
+  // Continuous windows cover the last cycle's worth of frames, wrapping the
+  // ring as need be, and come exactly once a second.
+
+  void
+  cadence_data()
+  {
+    spans_data();
+  }
+
+  void
+  cadence()
+  {
+    QFETCH(int, submode);
+
+    qint32 const cycleFrames = JS8::Submode::framesPerCycle(submode);
+    qint32 const step        = SECOND / 8;
+
+    DecodeSchedule schedule;
+    schedule.setContinuous(submode, true);
+
+    qint64 position = 0;
+    qint64 last     = -1;
+    int    count    = 0;
+
+    for (qint32 k = 0; position < 2 * RING; k = (k + step) % RING, position += step)
+    {
+      for (auto const & window : only(submode, schedule.advance(k)))
+      {
+        QCOMPARE(window.sz, cycleFrames);
+        QCOMPARE(window.start, (k - cycleFrames + RING) % RING);
+        if (last >= 0) QCOMPARE(position - last, qint64 {SECOND});
+
+        last = position;
+        ++count;
+      }
+    }
+
+    QCOMPARE(count, 2 * RING / SECOND - 1);
+  }
+
+  // Wrapping the ring continues the schedule rather than restarting it;
+  // the first cycle of the ring gets its early window and the schedule
+  // remains due at the same unwrapped position.
+
+  void
+  ringWrap()
+  {
+    qint32 const step = SECOND / 4;
+
+    DecodeSchedule schedule;
+    QSet<int>      early;
+
+    for (qint64 position = RING - 3 * SECOND; position < RING + 3 * SECOND; position += step)
+    {
+      qint32 const k = position % RING;
+
+      if (position > RING - 3 * SECOND)
+      {
+        QCOMPARE(schedule.due(k), schedule.framesUntilNext() <= step);
+      }
+
+      for (auto const & window : schedule.advance(k))
+      {
+        QVERIFY(window.start + window.sz <= RING);
+
+        if (position >= RING)
+        {
+          QCOMPARE(window.start, 0);
+          early.insert(window.submode);
+        }
+      }
+    }
+
+    QCOMPARE(early.size(), qsizetype (std::size(SUBMODES)));
+  }
+
+  // A move by more than half the ring can't be told apart from several
+  // wraps; we start over rather than producing windows for the gap.
+
+  void
+  resync()
+  {
+    DecodeSchedule schedule;
+
+    schedule.advance(0);
+    auto const windows = schedule.advance(RING / 2 + SECOND / 2);
+
+    QVERIFY(windows.isEmpty());
+    QVERIFY(schedule.framesUntilNext() <= SECOND);
+  }
+
+  // Over several wraps of the ring, at a variety of detector block sizes
+  // and starting positions, with and without autosync, the schedule comes
+  // up with the same windows as the old rules did, both when advanced at
+  // every position and, as MainWindow does, only when it says it's due.
+
+  void
+  matchesOldRules_data()
+  {
+    QTest::addColumn<qint32>("start");
+    QTest::addColumn<qint32>("step");
+    QTest::addColumn<bool>("autosync");
+    QTest::addColumn<bool>("dueOnly");
+
+    for (qint32 const start : {0, 123456, RING - 1728})
+    {
+      for (qint32 const step : {576, 1728, 3456, 12000, 12345})
+      {
+        for (bool const autosync : {false, true})
+        {
+          for (bool const dueOnly : {false, true})
+          {
+            QTest::newRow(qPrintable(QString {"start %1 step %2%3%4"}.arg(start)
+                                                                      .arg(step)
+                                                                      .arg(autosync ? " autosync" : "")
+                                                                      .arg(dueOnly  ? " due only" : "")))
+              << start << step << autosync << dueOnly;
+          }
+        }
+      }
+    }
+  }
+
+  void
+  matchesOldRules()
+  {
+    QFETCH(qint32, start);
+    QFETCH(qint32, step);
+    QFETCH(bool,   autosync);
+    QFETCH(bool,   dueOnly);
+
+    // Autosync one submode partway through, as the user might.
+
+    QSet<int> everySecond;
+    int const autosynced = Varicode::JS8CallFast;
+
+    DecodeSchedule schedule;
+    OldRules       old;
+    qint32         k     = start;
+    int            count = 0;
+
+    for (qint64 position = 0; position < 3 * RING; position += step, k = (k + step) % RING)
+    {
+      if (autosync && position >= RING && !everySecond.contains(autosynced))
+      {
+        everySecond.insert(autosynced);
+        schedule.setContinuous(autosynced, true);
+      }
+
+      auto const expected = old.advance(k, everySecond);
+      auto const actual   = (dueOnly && !schedule.due(k))
+                          ? QList<Window> {}
+                          : schedule.advance(k);
+
+      QCOMPARE(describe(actual), describe(expected));
+      count += actual.size();
+    }
+
+    QVERIFY(count > 0);
+  }
+};
+
+QTEST_APPLESS_MAIN(TestDecodeSchedule)
+
+#include "test_DecodeSchedule.moc"
@@ -0,0 +1,566 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include <QtTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "commons.h"
+#include "JS8.hpp"
+
+// Defined by the main window, which isn't part of the test; the decoder
+// copies the frames it's asked to decode from the former, and creates its
+// FFT plans under the latter.
+
+struct dec_data dec_data;
+std::mutex      fftw_mutex;
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  // Noisier copies of each recording are made by adding Gaussian noise at
+  // these multiples of its own RMS level, i.e., with an SNR worse by about
+  // 3 and 7 dB; seeded, so that every run sees the same noise.
+
+  constexpr std::array NOISE = {1.0, 2.0};
+  constexpr unsigned   SEED  = 20240309;
+
+  // Recordings of noise alone to try wrong hints on.
+
+  constexpr int NOISE_ONLY = 8;
+
+  // Longest we'll wait on a decode of a single recording, in ms.
+
+  constexpr int TIMEOUT = 60000;
+
+  // The submodes in the corpus, as the decoder's submode set has them.
+
+  constexpr int SUBMODE_A = 1 << 0;
+  constexpr int SUBMODE_E = 1 << 3;
+
+  // A period's worth of 16-bit mono audio at 12 kHz, in a single submode,
+  // from the recorded corpus, or a noisier copy of a recording from it.
+
+  struct Recording
+  {
+    QString                   name;
+    int                       submode;
+    std::vector<std::int16_t> samples;
+  };
+
+  // The samples in the data chunk of a WAV file.
+
+  std::vector<std::int16_t>
+  samples(QString const & path)
+  {
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    auto const bytes = file.readAll();
+
+    for (qsizetype pos = 12; pos + 8 <= bytes.size();)
+    {
+      std::uint32_t size;
+      std::memcpy(&size, bytes.constData() + pos + 4, sizeof size);
+
+      if (bytes.mid(pos, 4) == "data")
+      {
+        std::vector<std::int16_t> data(std::min<qsizetype>(size, bytes.size() - pos - 8) / 2);
+        std::memcpy(data.data(), bytes.constData() + pos + 8, data.size() * 2);
+        return data;
+      }
+
+      pos += 8 + size;
+    }
+
+    return {};
+  }
+
+  std::vector<std::int16_t>
+  noisier(std::vector<std::int16_t> const & samples,
+          double                    const   level,
+          unsigned                  const   seed)
+  {
+    double power = 0.0;
+
+    for (auto const sample : samples) power += double(sample) * sample;
+
+    std::mt19937                     generator(seed);
+    std::normal_distribution<double> noise(0.0, level * std::sqrt(power / samples.size()));
+    std::vector<std::int16_t>        result(samples.size());
+
+    std::transform(samples.begin(), samples.end(), result.begin(), [&](auto const sample)
+    {
+      return static_cast<std::int16_t>(std::clamp(std::lround(sample + noise(generator)), -32768L, 32767L));
+    });
+
+    return result;
+  }
+
+  // The recorded corpus; files are named for the submode they're in, the
+  // decode depth, and the number of decodes expected, e.g., A_2_5.wav. If
+  // asked, each recording is followed by its noisier copies.
+
+  QList<Recording>
+  corpus(bool const noisy)
+  {
+    QList<Recording> recordings;
+    unsigned         seed = SEED;
+
+    for (auto const & info : QDir(JS8_TEST_CORPUS).entryInfoList({"*.wav"}, QDir::Files, QDir::Name))
+    {
+      auto const name    = info.completeBaseName();
+      auto const submode = name.startsWith('E') ? SUBMODE_E : SUBMODE_A;
+      auto const clean   = samples(info.filePath());
+
+      recordings << Recording {name, submode, clean};
+
+      if (!noisy) continue;
+
+      for (auto const level : NOISE)
+      {
+        recordings << Recording {QString {"%1+%2"}.arg(name).arg(level), submode, noisier(clean, level, seed++)};
+      }
+    }
+
+    return recordings;
+  }
+
+  // Recordings of nothing but noise, at about the level of those in the
+  // corpus; every fourth in submode E, the rest in A.
+
+  QList<Recording>
+  noise(int const count)
+  {
+    QList<Recording> recordings;
+
+    for (int i = 0; i < count; ++i)
+    {
+      auto const submode = i % 4 == 3 ? SUBMODE_E : SUBMODE_A;
+      auto const seconds = submode == SUBMODE_E ? JS8E_TX_SECONDS : JS8A_TX_SECONDS;
+
+      std::mt19937                     generator(SEED + i);
+      std::normal_distribution<double> distribution(0.0, 800.0);
+      std::vector<std::int16_t>        samples(seconds * JS8_RX_SAMPLE_RATE);
+
+      for (auto & sample : samples) sample = static_cast<std::int16_t>(std::lround(distribution(generator)));
+
+      recordings << Recording {QString {"noise#%1"}.arg(i), submode, std::move(samples)};
+    }
+
+    return recordings;
+  }
+
+  // The decoder's alphabet, in which each character of a message is 6 bits
+  // of it, most significant first.
+
+  constexpr std::string_view ALPHABET = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-+";
+
+  // A hint, as the main window gives them for a station we're working, at
+  // the offset we last heard it; the first 59 bits of a message, i.e., the
+  // frame type and the two callsigns of a directed frame, taken here from
+  // whatever message we've been given.
+
+  dec_data::dec_params::dec_hint
+  hint(int     const   submode,
+       QString const & message,
+       float   const   offset)
+  {
+    constexpr int BITS  = 3 + 28 + 28;
+    constexpr int CHARS = (BITS + 5) / 6;
+
+    std::uint64_t bits = 0;
+
+    for (auto const c : message.left(CHARS).toStdString())
+    {
+      bits = (bits << 6) | ALPHABET.find(c);
+    }
+
+    bits <<= 64 - 6 * CHARS;
+
+    auto const mask = ~std::uint64_t {0} << (64 - BITS);
+
+    // Hints name the submode as a decode event does, not as a submode set.
+
+    return {submode == SUBMODE_E ? 4 : 0,
+            static_cast<int>(std::lround(offset)),
+            mask,
+            bits & mask};
+  }
+
+  // What a decode of a recording came up with, and how long it took, in ns;
+  // along with every sync and decode event, in order, in enough detail to
+  // tell where the decoder thought each signal was.
+
+  struct Result
+  {
+    QSet<QString>        decodes;
+    QMap<QString, float> heard;    // offset at which each message was heard
+    QStringList          events;
+    qint64               elapsed = 0;
+  };
+
+  // Decode parameters for a recording, as the main window would set them,
+  // for the only submode present in it, with every optional part of the
+  // decode off.
+
+  dec_data::dec_params
+  params(Recording const & recording)
+  {
+    dec_data::dec_params params = {};
+    auto const           size   = static_cast<int>(recording.samples.size());
+
+    params.nutc      = 0;
+    params.nfqso     = 1500;
+    params.newdat    = true;
+    params.nfa       = 0;
+    params.nfb       = 5000;
+    params.osdBudget = JS8_OSD_BUDGET;
+    params.kin       = size;
+    params.nsubmodes = recording.submode;
+
+    if (recording.submode == SUBMODE_E) params.kszE = size;
+    else                                params.kszA = size;
+
+    return params;
+  }
+
+  Result
+  decode(JS8::Decoder               & decoder,
+         Recording            const & recording,
+         dec_data::dec_params const & params)
+  {
+    std::fill(std::begin(dec_data.d2), std::end(dec_data.d2), 0);
+    std::copy(recording.samples.begin(), recording.samples.end(), std::begin(dec_data.d2));
+
+    Result        result;
+    bool          finished = false;
+    QElapsedTimer timer;
+
+    auto const connection = QObject::connect(&decoder, &JS8::Decoder::decodeEvent, [&](JS8::Event::Variant const & event)
+    {
+      if (auto const decoded = std::get_if<JS8::Event::Decoded>(&event))
+      {
+        result.decodes << QString {"%1 %2"}.arg(decoded->type).arg(QString::fromStdString(decoded->data));
+        result.heard.insert(QString::fromStdString(decoded->data), decoded->frequency);
+        result.events  << QString {"decoded %1 %2 dB %3 s %4 Hz"}.arg(QString::fromStdString(decoded->data))
+                                                                 .arg(decoded->snr)
+                                                                 .arg(decoded->xdt)
+                                                                 .arg(decoded->frequency);
+      }
+      else if (auto const sync = std::get_if<JS8::Event::SyncState>(&event))
+      {
+        result.events << QString {"sync %1 %2 s %3 Hz"}.arg(sync->type == JS8::Event::SyncState::Type::CANDIDATE
+                                                             ? sync->sync.candidate
+                                                             : sync->sync.decoded)
+                                                        .arg(sync->dt)
+                                                        .arg(sync->frequency);
+      }
+      else if (std::holds_alternative<JS8::Event::DecodeFinished>(event))
+      {
+        result.elapsed = timer.nsecsElapsed();
+        finished       = true;
+      }
+    });
+
+    timer.start();
+    decoder.decode(params);
+
+    QTest::qWaitFor([&finished]() { return finished; }, TIMEOUT);
+    QObject::disconnect(connection);
+
+    return result;
+  }
+
+  // Totals over the corpus, for reporting.
+
+  struct Totals
+  {
+    int    decodes = 0;
+    int    lost    = 0;
+    qint64 elapsed = 0;
+
+    // Adds a result in, counting anything in the one it's compared against
+    // that it doesn't have as lost.
+
+    void
+    add(Result const & result,
+        Result const & against = {})
+    {
+      decodes += static_cast<int>(result.decodes.size());
+      lost    += static_cast<int>((against.decodes - result.decodes).size());
+      elapsed += result.elapsed;
+    }
+
+    double ms() const { return elapsed / 1e6; }
+  };
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestJS8Decode : public QObject
+{
+  Q_OBJECT
+
+  JS8::Decoder m_decoder;
+
+private slots:
+
+  // The decoder creates its FFT plans on its own thread as it starts; let
+  // it, so that the first decode we time doesn't include that.
+
+  void
+  initTestCase()
+  {
+    QVERIFY(QDir(JS8_TEST_CORPUS).exists());
+
+    m_decoder.start(QThread::NormalPriority);
+
+    auto const recordings = corpus(false);
+
+    QVERIFY(!recordings.isEmpty());
+
+    decode(m_decoder, recordings.first(), params(recordings.first()));
+  }
+
+  void
+  cleanupTestCase()
+  {
+    m_decoder.quit();
+  }
+
+  // The energy gate against the full sync search, over the corpus and the
+  // noisier copies of it; reports decodes and time for each. The gate may
+  // lose decodes that the full search finds, and does on a busy band, but
+  // it never finds any that the full search doesn't. Losing decodes isn't
+  // something we'll do by default; JS8_ENERGY_GATE is off.
+
+  void
+  energyGate()
+  {
+    Totals full;
+    Totals gated;
+
+    for (auto const & recording : corpus(true))
+    {
+      auto       p      = params(recording);
+      auto const before = decode(m_decoder, recording, p);
+
+      p.energyGate = true;
+
+      auto const after = decode(m_decoder, recording, p);
+
+      QVERIFY2(before.decodes.contains(after.decodes), qPrintable(recording.name));
+
+      full.add(before);
+      gated.add(after, before);
+    }
+
+    qInfo("full search: %d decodes in %.0f ms; energy gate: %d decodes, %d lost, in %.0f ms",
+          full.decodes,
+          full.ms(),
+          gated.decodes,
+          gated.lost,
+          gated.ms());
+  }
+
+  // Belief propagation run to completion against early abort, over the
+  // corpus and the noisier copies of it; reports time for each. Early
+  // abort, which is on by default, must decode everything that running
+  // to completion does.
+
+  void
+  earlyAbort()
+  {
+    Totals complete;
+    Totals aborted;
+
+    for (auto const & recording : corpus(true))
+    {
+      auto       p      = params(recording);
+      auto const before = decode(m_decoder, recording, p);
+
+      p.bpEarlyAbort = true;
+
+      auto const after = decode(m_decoder, recording, p);
+
+      QVERIFY2(after.decodes == before.decodes, qPrintable(recording.name));
+
+      complete.add(before);
+      aborted.add(after, before);
+    }
+
+    qInfo("run to completion: %d decodes in %.0f ms; early abort: %d decodes, %d lost, in %.0f ms",
+          complete.decodes,
+          complete.ms(),
+          aborted.decodes,
+          aborted.lost,
+          aborted.ms());
+  }
+
+  // The fine sync timing search, pruned and exhaustive, over the corpus and
+  // the noisier copies of it, reporting sync events. Pruning skips only the
+  // offsets that can't better the best found, so every candidate must sync
+  // at the same time and frequency either way, and decode identically.
+
+  void
+  syncPrune()
+  {
+    Totals exhaustive;
+    Totals pruned;
+
+    for (auto const & recording : corpus(true))
+    {
+      auto p = params(recording);
+
+      p.syncStats = true;
+
+      auto const before = decode(m_decoder, recording, p);
+
+      p.syncPrune = true;
+
+      auto const after = decode(m_decoder, recording, p);
+
+      QVERIFY2(!before.events.isEmpty(), qPrintable(recording.name));
+      QCOMPARE(after.events, before.events);
+
+      exhaustive.add(before);
+      pruned.add(after, before);
+    }
+
+    qInfo("exhaustive: %d decodes in %.0f ms; pruned: %d decodes, %d lost, in %.0f ms",
+          exhaustive.decodes,
+          exhaustive.ms(),
+          pruned.decodes,
+          pruned.lost,
+          pruned.ms());
+  }
+
+  // A priori decoding over the corpus and the noisier copies of it, first
+  // with a hint for each message in the clean recording, at the offset it
+  // was heard. Then with wrong hints, for messages from other recordings,
+  // as though we were working a station that sent something else there,
+  // and over noise alone, with hints spread across the band. Reports the
+  // decodes gained, and the time taken. Right hints must never cost us a
+  // decode, nor find one that isn't in the clean recording; wrong ones
+  // must find nothing at all. AP decoding is on by default.
+
+  void
+  apriori()
+  {
+    QMap<QString, Result> clean;
+    QStringList           messages;
+
+    for (auto const & recording : corpus(false))
+    {
+      auto const result = decode(m_decoder, recording, params(recording));
+
+      clean.insert(recording.name, result);
+      messages << result.heard.keys();
+    }
+
+    Totals without;
+    Totals with;
+    Totals wrong;
+    int    recordings = 0;
+    int    next       = 0;
+
+    for (auto const & recording : corpus(true) + noise(NOISE_ONLY))
+    {
+      ++recordings;
+
+      auto const truth  = clean.value(recording.name.section('+', 0, 0));
+      auto       p      = params(recording);
+      auto const before = decode(m_decoder, recording, p);
+
+      QList<dec_data::dec_params::dec_hint> right;
+
+      for (auto const & [message, offset] : truth.heard.asKeyValueRange())
+      {
+        right << hint(recording.submode, message, offset);
+      }
+
+      if (!right.isEmpty())
+      {
+        p.nhints = 0;
+
+        for (auto const & h : right.first(std::min<qsizetype>(right.size(), JS8_AP_MAX_HINTS)))
+        {
+          p.hints[p.nhints++] = h;
+        }
+
+        auto const after = decode(m_decoder, recording, p);
+
+        QVERIFY2(after.decodes.contains(before.decodes), qPrintable(recording.name));
+        QVERIFY2(truth.decodes.contains(after.decodes - before.decodes), qPrintable(recording.name));
+
+        without.add(before);
+        with.add(after, before);
+      }
+
+      // Wrong hints; any message whose hint differs from all of the right
+      // ones, at the offsets of the right ones, or for noise alone, spread
+      // across the band.
+
+      auto const other = [&]()
+      {
+        for (;;)
+        {
+          auto const h = hint(recording.submode, messages[next++ % messages.size()], 0.0f);
+
+          if (std::none_of(right.begin(), right.end(), [&h](auto const & r) { return r.bits == h.bits; })) return h;
+        }
+      };
+
+      p.nhints = 0;
+
+      while (p.nhints < JS8_AP_MAX_HINTS && p.nhints < std::max<qsizetype>(right.size(), JS8_AP_MAX_HINTS / 2))
+      {
+        auto h = other();
+
+        h.freq = p.nhints < right.size() ? right[p.nhints].freq : 500 + 500 * p.nhints;
+
+        p.hints[p.nhints++] = h;
+      }
+
+      auto const after = decode(m_decoder, recording, p);
+
+      QVERIFY2(after.decodes == before.decodes, qPrintable(recording.name));
+
+      wrong.add(after, before);
+    }
+
+    qInfo("without hints: %d decodes in %.0f ms; with hints: %d decodes, %d gained, in %.0f ms; "
+          "with wrong hints: %d decodes over %d recordings, none gained or lost, in %.0f ms",
+          without.decodes,
+          without.ms(),
+          with.decodes,
+          with.decodes - without.decodes,
+          with.ms(),
+          wrong.decodes,
+          recordings,
+          wrong.ms());
+  }
+};
+
+QTEST_GUILESS_MAIN(TestJS8Decode)
+
+#include "test_JS8Decode.moc"
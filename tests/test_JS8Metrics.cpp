@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <QtTest>
+#include "JS8Metrics.hpp"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using namespace JS8::Metrics;
+
+  using Spectrum = std::array<std::array<float, NN>, NROWS>;
+  using Metrics  = std::array<float, 3 * ND>;
+
+  // Agreement required between the fused metrics and the direct ones, after
+  // normalization to a standard deviation of 2.83; the metrics feed belief
+  // propagation, which is nowhere near this sensitive.
+
+  constexpr float TOLERANCE = 1e-3f;
+
+  // Magnitudes this small square to nothing, and the linear metrics of both
+  // go to infinity in normalization; that's no change, so it's agreement.
+
+  bool
+  agrees(float const a,
+         float const b)
+  {
+    return a == b || std::abs(a - b) <= TOLERANCE;
+  }
+
+  // The direct computation that softmetrics() replaced, as js8dec() had it.
+
+  void
+  oldMetrics(Spectrum const & s2,
+             Metrics        & llr0,
+             Metrics        & llr1)
+  {
+    std::array<std::array<float, ND>, NROWS> s1;
+
+    for (int row = 0; row < NROWS; ++row)
+    {
+      std::copy(s2[row].begin() +  7, s2[row].begin() + 36, s1[row].begin());
+      std::copy(s2[row].begin() + 43, s2[row].begin() + 72, s1[row].begin() + 29);
+    }
+
+    for (int j = 0; j < ND; ++j)
+    {
+      int const i1 = 3 * j;
+      int const i2 = 3 * j + 1;
+      int const i4 = 3 * j + 2;
+
+      std::array<float, NROWS> ps;
+
+      for (int i = 0; i < NROWS; ++i) ps[i] = s1[i][j];
+
+      llr0[i1] = std::max({ps[4], ps[5], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[2], ps[3]});
+      llr0[i2] = std::max({ps[2], ps[3], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[4], ps[5]});
+      llr0[i4] = std::max({ps[1], ps[3], ps[5], ps[7]}) - std::max({ps[0], ps[2], ps[4], ps[6]});
+
+      for (auto & x : ps) x = std::log(x + 1e-32f);
+
+      llr1[i1] = std::max({ps[4], ps[5], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[2], ps[3]});
+      llr1[i2] = std::max({ps[2], ps[3], ps[6], ps[7]}) - std::max({ps[0], ps[1], ps[4], ps[5]});
+      llr1[i4] = std::max({ps[1], ps[3], ps[5], ps[7]}) - std::max({ps[0], ps[2], ps[4], ps[6]});
+    }
+
+    auto const normalizeLLR = [](auto & llr)
+    {
+      float sum            = 0.0f;
+      float sum_of_squares = 0.0f;
+
+      for (auto const value : llr)
+      {
+        sum            += value;
+        sum_of_squares += value * value;
+      }
+
+      float const llrav    = sum            / llr.size();
+      float const llr2av   = sum_of_squares / llr.size();
+      float const variance = llr2av - llrav * llrav;
+      float const llrsig   = std::sqrt(variance > 0.0f ? variance : llr2av);
+
+      for (float & val : llr) val = (val / llrsig) * 2.83f;
+    };
+
+    normalizeLLR(llr0);
+    normalizeLLR(llr1);
+  }
+
+  // Tone magnitudes as the decoder sees them; Rayleigh distributed noise in
+  // every tone, plus a carrier of the provided amplitude in a random one of
+  // the tones of each symbol, all scaled.
+
+  Spectrum
+  spectrum(unsigned const seed,
+           float    const amplitude,
+           float    const scale = 1.0f)
+  {
+    std::mt19937                          generator {seed};
+    std::uniform_real_distribution<float> uniform {std::numeric_limits<float>::min(), 1.0f};
+
+    auto const gaussian = [&]()
+    {
+      return std::sqrt(-2.0f * std::log(uniform(generator))) *
+             std::cos(6.2831853f * uniform(generator));
+    };
+
+    Spectrum s2;
+
+    for (int k = 0; k < NN; ++k)
+    {
+      auto const tone = static_cast<int>(generator() % NROWS);
+
+      for (int i = 0; i < NROWS; ++i)
+      {
+        float const re = gaussian() + (i == tone ? amplitude : 0.0f);
+        float const im = gaussian();
+
+        s2[i][k] = std::sqrt(re * re + im * im) * scale;
+      }
+    }
+
+    return s2;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestJS8Metrics : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Across the magnitudes the decoder can produce, from just above the
+  // epsilon added before taking logs up through the largest, fastlog()
+  // agrees with std::log() to 1e-5.
+
+  void
+  fastlog()
+  {
+    float worst = 0.0f;
+
+    for (float x = 1e-35f; x < 1e5f; x *= 1.0001f)
+    {
+      worst = std::max(worst, std::abs(JS8::Metrics::fastlog(x) - std::log(x)));
+    }
+
+    qInfo("fastlog: worst absolute error %g", worst);
+
+    QVERIFY(worst <= 1e-5f);
+  }
+
+  // From noise alone through strong signals, and at magnitudes small enough
+  // for the epsilon to matter, the fused metrics agree with the direct ones.
+
+  void
+  softmetrics_data()
+  {
+    QTest::addColumn<float>("amplitude");
+    QTest::addColumn<float>("scale");
+
+    QTest::newRow("noise")        << 0.0f  << 1.0f;
+    QTest::newRow("weak")         << 1.0f  << 1.0f;
+    QTest::newRow("moderate")     << 3.0f  << 1.0f;
+    QTest::newRow("strong")       << 30.0f << 1.0f;
+    QTest::newRow("quiet")        << 3.0f  << 1e-3f;
+    QTest::newRow("loud")         << 3.0f  << 1e3f;
+    QTest::newRow("near epsilon") << 3.0f  << 1e-30f;
+  }
+
+  void
+  softmetrics()
+  {
+    QFETCH(float, amplitude);
+    QFETCH(float, scale);
+
+    for (unsigned seed = 1; seed <= 100; ++seed)
+    {
+      auto const s2 = spectrum(seed, amplitude, scale);
+
+      Metrics old0, old1, new0, new1;
+
+      oldMetrics(s2, old0, old1);
+      JS8::Metrics::softmetrics(s2, new0, new1);
+
+      for (int i = 0; i < 3 * ND; ++i)
+      {
+        QVERIFY2(agrees(new0[i], old0[i]), qPrintable(QString {"seed %1 llr0[%2]: %3 vs %4"}.arg(seed).arg(i).arg(new0[i]).arg(old0[i])));
+        QVERIFY2(agrees(new1[i], old1[i]), qPrintable(QString {"seed %1 llr1[%2]: %3 vs %4"}.arg(seed).arg(i).arg(new1[i]).arg(old1[i])));
+      }
+    }
+  }
+
+  // The hard decisions, i.e., the signs, are the same, other than for log
+  // metrics so close to zero that the difference between the logarithms
+  // could decide them; anything else would change what belief propagation
+  // starts from.
+
+  void
+  signs()
+  {
+    for (unsigned seed = 1; seed <= 100; ++seed)
+    {
+      auto const s2 = spectrum(seed, 2.0f);
+
+      Metrics old0, old1, new0, new1;
+
+      oldMetrics(s2, old0, old1);
+      JS8::Metrics::softmetrics(s2, new0, new1);
+
+      for (int i = 0; i < 3 * ND; ++i)
+      {
+        QCOMPARE(std::signbit(new0[i]), std::signbit(old0[i]));
+
+        if (std::abs(old1[i]) > TOLERANCE)
+        {
+          QCOMPARE(std::signbit(new1[i]), std::signbit(old1[i]));
+        }
+      }
+    }
+  }
+
+  // Microbenchmarks of the two, on the same moderate signal; these run
+  // once under ctest, run the test directly, e.g., with -median 5, to
+  // compare them.
+
+  void
+  benchmarkOld()
+  {
+    auto const s2 = spectrum(1, 3.0f);
+    Metrics    llr0, llr1;
+
+    QBENCHMARK
+    {
+      oldMetrics(s2, llr0, llr1);
+    }
+
+    QVERIFY(std::isfinite(llr1[0]));
+  }
+
+  void
+  benchmarkNew()
+  {
+    auto const s2 = spectrum(1, 3.0f);
+    Metrics    llr0, llr1;
+
+    QBENCHMARK
+    {
+      JS8::Metrics::softmetrics(s2, llr0, llr1);
+    }
+
+    QVERIFY(std::isfinite(llr1[0]));
+  }
+};
+
+QTEST_APPLESS_MAIN(TestJS8Metrics)
+
+#include "test_JS8Metrics.moc"
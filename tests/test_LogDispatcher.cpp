@@ -0,0 +1,315 @@
+#include <chrono>
+#include <QtTest>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QList>
+#include <QNetworkDatagram>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QUdpSocket>
+#include "LogDispatcher.h"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using namespace std::chrono_literals;
+
+  // As LogDispatcher has them; the first retry after a failure, doubling
+  // with each failure after that.
+
+  constexpr auto RETRY_MIN = 5s;
+
+  // Longest we'll wait for anything that doesn't involve a retry, and the
+  // slack we'll allow a retry beyond its time; timers may also fire up to
+  // 5% early.
+
+  constexpr int  TIMEOUT = 5000;
+  constexpr auto SLACK   = 3s;
+  constexpr int  EARLY   = 95;    // percent
+
+  QString const HOST = "127.0.0.1";
+
+  // What we hear from a dispatcher, and when, in ms since it was created.
+
+  struct Status
+  {
+    LogDispatcher::Target target;
+    bool                  delivered;
+    int                   pending;
+    qint64                when;
+  };
+
+  class Statuses
+  {
+    QElapsedTimer m_clock;
+
+  public:
+
+    QList<Status> list;
+
+    explicit Statuses(LogDispatcher & dispatcher)
+    {
+      m_clock.start();
+
+      QObject::connect(&dispatcher, &LogDispatcher::status, [this](LogDispatcher::Target const target,
+                                                                   bool                  const delivered,
+                                                                   int                   const pending,
+                                                                   QString const &)
+      {
+        list << Status {target, delivered, pending, m_clock.elapsed()};
+      });
+    }
+  };
+
+  // A stand-in for N3FJP; takes whatever is sent to it over any number of
+  // connections, keeping the connection it accepted last.
+
+  class Server : public QTcpServer
+  {
+  public:
+
+    QByteArray            received;
+    QPointer<QTcpSocket>  last;
+
+    explicit Server(quint16 const port = 0)
+    {
+      connect(this, &QTcpServer::newConnection, this, [this]()
+      {
+        while (auto const socket = nextPendingConnection())
+        {
+          last = socket;
+          connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { received += socket->readAll(); });
+        }
+      });
+
+      listen(QHostAddress {HOST}, port);
+    }
+  };
+
+  // A port with nothing listening on it, at least for now.
+
+  quint16
+  unused()
+  {
+    QTcpServer server;
+    server.listen(QHostAddress {HOST});
+    return server.serverPort();
+  }
+
+  // A fresh place for a queue, per test.
+
+  class Queue
+  {
+    QTemporaryDir m_dir;
+
+  public:
+
+    QString path() const { return m_dir.filePath("log_queue.json"); }
+  };
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestLogDispatcher : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // A record for N3FJP is delivered over TCP as a command, followed by a
+  // request that it refresh its log; once it has been, nothing's pending,
+  // and so no queue is kept.
+
+  void
+  deliverTcp()
+  {
+    Queue         queue;
+    Server        server;
+    LogDispatcher dispatcher {queue.path()};
+    Statuses      statuses {dispatcher};
+
+    QVERIFY(server.isListening());
+
+    dispatcher.start();
+    dispatcher.enqueue(LogDispatcher::N3FJP, HOST, server.serverPort(), "<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>");
+
+    QTRY_VERIFY_WITH_TIMEOUT(server.received.contains("<CMD><CHECKLOG></CMD>"), TIMEOUT);
+    QVERIFY(server.received.startsWith("<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>\r\f"));
+    QCOMPARE(statuses.list.size(), qsizetype {1});
+    QVERIFY(statuses.list[0].delivered);
+    QCOMPARE(statuses.list[0].pending, 0);
+    QVERIFY(!QFile::exists(queue.path()));
+  }
+
+  // A record for N1MM is delivered as a UDP datagram, as is.
+
+  void
+  deliverUdp()
+  {
+    Queue         queue;
+    QUdpSocket    receiver;
+    LogDispatcher dispatcher {queue.path()};
+    Statuses      statuses {dispatcher};
+
+    QVERIFY(receiver.bind(QHostAddress {HOST}));
+
+    dispatcher.start();
+    dispatcher.enqueue(LogDispatcher::N1MM, HOST, receiver.localPort(), "<call:5>K1ABC <eor>");
+    dispatcher.enqueue(LogDispatcher::N1MM, HOST, receiver.localPort(), "<call:5>K2DEF <eor>");
+
+    QList<QByteArray> datagrams;
+
+    auto const received = [&]()
+    {
+      while (receiver.hasPendingDatagrams()) datagrams << receiver.receiveDatagram().data();
+      return datagrams.size() == 2;
+    };
+
+    QTRY_VERIFY_WITH_TIMEOUT(received(), TIMEOUT);
+
+    QCOMPARE(datagrams[0], QByteArray {"<call:5>K1ABC <eor>"});
+    QCOMPARE(datagrams[1], QByteArray {"<call:5>K2DEF <eor>"});
+    QCOMPARE(statuses.list.size(), qsizetype {2});
+    QVERIFY(statuses.list[1].delivered);
+    QCOMPARE(statuses.list[1].pending, 0);
+  }
+
+  // With nothing listening, a record stays pending, and is retried after
+  // RETRY_MIN, and then after twice that; once something is listening, the
+  // next retry delivers it.
+
+  void
+  backoff()
+  {
+    Queue         queue;
+    auto const    port = unused();
+    LogDispatcher dispatcher {queue.path()};
+    Statuses      statuses {dispatcher};
+
+    dispatcher.start();
+    dispatcher.enqueue(LogDispatcher::N3FJP, HOST, port, "<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>");
+
+    auto const retry = std::chrono::milliseconds {RETRY_MIN}.count();
+    auto const slack = std::chrono::milliseconds {SLACK}.count();
+
+    QTRY_COMPARE_WITH_TIMEOUT(statuses.list.size(), qsizetype {2}, retry + slack + TIMEOUT);
+
+    for (auto const & status : statuses.list)
+    {
+      QVERIFY(!status.delivered);
+      QCOMPARE(status.pending, 1);
+    }
+
+    QVERIFY(QFile::exists(queue.path()));
+
+    auto const first = statuses.list[1].when - statuses.list[0].when;
+
+    QVERIFY2(first >= retry * EARLY / 100 && first < retry + slack, qPrintable(QString::number(first)));
+
+    Server server {port};
+
+    QVERIFY(server.isListening());
+    QTRY_COMPARE_WITH_TIMEOUT(statuses.list.size(), qsizetype {3}, 2 * retry + slack);
+
+    auto const second = statuses.list[2].when - statuses.list[1].when;
+
+    QVERIFY(statuses.list[2].delivered);
+    QCOMPARE(statuses.list[2].pending, 0);
+    QVERIFY2(second >= 2 * retry * EARLY / 100, qPrintable(QString::number(second)));
+    QTRY_VERIFY_WITH_TIMEOUT(server.received.startsWith("<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>\r\f"), TIMEOUT);
+  }
+
+  // A record written to a connection that N3FJP has closed, but that we've
+  // not yet heard is closed, isn't counted as delivered; it stays pending,
+  // and goes over a new connection on the retry.
+
+  void
+  closedPeer()
+  {
+    Queue         queue;
+    Server        server;
+    LogDispatcher dispatcher {queue.path()};
+    Statuses      statuses {dispatcher};
+
+    dispatcher.start();
+    dispatcher.enqueue(LogDispatcher::N3FJP, HOST, server.serverPort(), "<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>");
+
+    QTRY_VERIFY_WITH_TIMEOUT(server.received.contains("<CMD><CHECKLOG></CMD>"), TIMEOUT);
+    QVERIFY(server.last);
+
+    auto const closed = server.last.data();
+
+    server.received.clear();
+    closed->close();
+
+    dispatcher.enqueue(LogDispatcher::N3FJP, HOST, server.serverPort(), "<CMD><ADDDIRECT><CALL>K2DEF</CALL></CMD>");
+
+    QTRY_COMPARE_WITH_TIMEOUT(statuses.list.size(), qsizetype {2}, TIMEOUT);
+    QVERIFY(!statuses.list[1].delivered);
+    QCOMPARE(statuses.list[1].pending, 1);
+
+    auto const retry = std::chrono::milliseconds {RETRY_MIN + SLACK}.count();
+
+    QTRY_COMPARE_WITH_TIMEOUT(statuses.list.size(), qsizetype {3}, retry);
+    QVERIFY(statuses.list[2].delivered);
+    QCOMPARE(statuses.list[2].pending, 0);
+    QVERIFY(server.last.data() != closed);
+    QTRY_VERIFY_WITH_TIMEOUT(server.received.startsWith("<CMD><ADDDIRECT><CALL>K2DEF</CALL></CMD>\r\f"), TIMEOUT);
+  }
+
+  // Records enqueued and not delivered are kept in the queue file, which a
+  // new dispatcher picks up, and delivers, in order, once started.
+
+  void
+  persistence()
+  {
+    Queue      queue;
+    Server     server;
+    QUdpSocket receiver;
+
+    QVERIFY(receiver.bind(QHostAddress {HOST}));
+
+    {
+      LogDispatcher dispatcher {queue.path()};
+
+      dispatcher.enqueue(LogDispatcher::N3FJP, HOST, server.serverPort(),  "<CMD><ADDDIRECT><CALL>K1ABC</CALL></CMD>");
+      dispatcher.enqueue(LogDispatcher::N1MM,  HOST, receiver.localPort(), "<call:5>K1ABC <eor>");
+      dispatcher.enqueue(LogDispatcher::N3FJP, HOST, server.serverPort(),  "<CMD><ADDDIRECT><CALL>K2DEF</CALL></CMD>");
+    }
+
+    QVERIFY(QFile::exists(queue.path()));
+    QVERIFY(server.received.isEmpty());
+    QVERIFY(!receiver.hasPendingDatagrams());
+
+    LogDispatcher dispatcher {queue.path()};
+    Statuses      statuses {dispatcher};
+
+    dispatcher.start();
+
+    QTRY_COMPARE_WITH_TIMEOUT(statuses.list.size(), qsizetype {3}, TIMEOUT);
+
+    for (auto const & status : statuses.list) QVERIFY(status.delivered);
+
+    auto const first  = server.received.indexOf("K1ABC");
+    auto const second = server.received.indexOf("K2DEF");
+
+    QVERIFY(first >= 0);
+    QVERIFY(second > first);
+    QTRY_VERIFY_WITH_TIMEOUT(receiver.hasPendingDatagrams(), TIMEOUT);
+    QCOMPARE(receiver.receiveDatagram().data(), QByteArray {"<call:5>K1ABC <eor>"});
+    QVERIFY(!QFile::exists(queue.path()));
+  }
+};
+
+QTEST_GUILESS_MAIN(TestLogDispatcher)
+
+#include "test_LogDispatcher.moc"
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <QtTest>
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QVector>
+#include "NotificationMixer.hpp"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using Sound = NotificationMixer::Sound;
+
+  constexpr int RATE   = 48000;
+  constexpr int PERIOD = 10;      // ms, of a typical output device
+  constexpr int FRAMES = RATE * PERIOD / 1000;
+
+  QAudioFormat
+  format(QAudioFormat::SampleFormat const sampleFormat,
+         int                        const channels = 1)
+  {
+    QAudioFormat format;
+
+    format.setSampleRate(RATE);
+    format.setChannelCount(channels);
+    format.setSampleFormat(sampleFormat);
+
+    return format;
+  }
+
+  Sound
+  sound(QVector<float> const & samples)
+  {
+    return QSharedPointer<QVector<float>>::create(samples);
+  }
+
+  Sound
+  sound(qsizetype const size,
+        float     const value)
+  {
+    return QSharedPointer<QVector<float>>::create(size, value);
+  }
+
+  // Pull a number of frames from the mixer as the output stream would,
+  // returning the samples it provided.
+
+  template <typename T>
+  QVector<T>
+  pull(NotificationMixer       & mixer,
+       QAudioFormat      const & format,
+       int               const   frames)
+  {
+    QVector<T> samples(frames * format.channelCount());
+
+    auto const bytes = mixer.read(reinterpret_cast<char *>(samples.data()),
+                                  frames * format.bytesPerFrame());
+
+    samples.resize(std::max(qint64 {0}, bytes) / qint64 {sizeof (T)});
+    return samples;
+  }
+
+  // Stands in for an output device in pull mode; on its own thread, as the
+  // audio system's would be, it takes a period's worth of audio from the
+  // mixer every period and discards it.
+
+  class NullSink final
+    : public QThread
+  {
+  public:
+
+    NullSink(NotificationMixer       & mixer,
+             QAudioFormat      const & format)
+      : m_mixer {mixer}
+      , m_bytes {FRAMES * format.bytesPerFrame()}
+    {
+    }
+
+    void
+    stop()
+    {
+      m_stop = true;
+      wait();
+    }
+
+  protected:
+
+    void
+    run() override
+    {
+      QByteArray    buffer(m_bytes, Qt::Uninitialized);
+      QElapsedTimer clock;
+
+      clock.start();
+
+      for (qint64 period = 1; !m_stop; ++period)
+      {
+        m_mixer.read(buffer.data(), buffer.size());
+
+        if (auto const ms = period * PERIOD - clock.elapsed(); ms > 0) msleep(ms);
+      }
+    }
+
+  private:
+
+    NotificationMixer & m_mixer;
+    qint64              m_bytes;
+    std::atomic<bool>   m_stop = false;
+  };
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestNotificationMixer : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Without a format there's nothing to provide; with one and nothing
+  // playing, there's always as much silence as asked for.
+
+  void
+  silence()
+  {
+    NotificationMixer mixer;
+
+    QVERIFY(pull<float>(mixer, {}, FRAMES).isEmpty());
+
+    auto const stereo = format(QAudioFormat::Float, 2);
+    mixer.setFormat(stereo);
+
+    auto const samples = pull<float>(mixer, stereo, FRAMES);
+
+    QCOMPARE(samples.size(), qsizetype {2 * FRAMES});
+    QVERIFY(std::all_of(samples.begin(), samples.end(), [](float const v) { return v == 0.0f; }));
+  }
+
+  // Sounds start in the first read after they're added, overlapping ones
+  // are summed and clamped to full scale, and each ends with silence once
+  // its samples run out.
+
+  void
+  mix()
+  {
+    auto const mono = format(QAudioFormat::Float);
+
+    NotificationMixer mixer;
+    mixer.setFormat(mono);
+
+    mixer.add(sound(100, 0.90f));
+    mixer.add(sound(200, 0.50f));
+    mixer.add(sound(300, -0.25f));
+
+    auto const samples = pull<float>(mixer, mono, FRAMES);
+
+    QCOMPARE(samples.size(), qsizetype {FRAMES});
+    QCOMPARE(samples[0],   1.0f);
+    QCOMPARE(samples[99],  1.0f);
+    QCOMPARE(samples[100], 0.25f);
+    QCOMPARE(samples[200], -0.25f);
+    QCOMPARE(samples[300], 0.0f);
+
+    // A sound longer than a read continues into the next.
+
+    mixer.add(sound(FRAMES + 10, 0.5f));
+
+    QCOMPARE(pull<float>(mixer, mono, FRAMES).last(), 0.5f);
+
+    auto const rest = pull<float>(mixer, mono, FRAMES);
+
+    QCOMPARE(rest[9],  0.5f);
+    QCOMPARE(rest[10], 0.0f);
+  }
+
+  // Stopping, or a change of format, silences whatever is playing.
+
+  void
+  clear()
+  {
+    auto const mono = format(QAudioFormat::Float);
+
+    NotificationMixer mixer;
+    mixer.setFormat(mono);
+
+    mixer.add(sound(10 * FRAMES, 0.5f));
+    QCOMPARE(pull<float>(mixer, mono, FRAMES).first(), 0.5f);
+
+    mixer.clear();
+    QCOMPARE(pull<float>(mixer, mono, FRAMES).first(), 0.0f);
+
+    mixer.add(sound(10 * FRAMES, 0.5f));
+    mixer.setFormat(mono);
+    QCOMPARE(pull<float>(mixer, mono, FRAMES).first(), 0.0f);
+  }
+
+  // Each of the output sample formats, at and beyond full scale.
+
+  void
+  formats()
+  {
+    QVector<float> const values = {-2.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f};
+
+    auto const samples = [&values](QAudioFormat::SampleFormat const sampleFormat, auto const type)
+    {
+      auto const out = format(sampleFormat);
+
+      NotificationMixer mixer;
+      mixer.setFormat(out);
+      mixer.add(sound(values));
+
+      return pull<std::decay_t<decltype(type)>>(mixer, out, values.size());
+    };
+
+    QCOMPARE(samples(QAudioFormat::Float, float {}),
+             (QVector<float> {-1.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 1.0f}));
+    QCOMPARE(samples(QAudioFormat::Int16, qint16 {}),
+             (QVector<qint16> {-32767, -32767, -16384, 0, 16384, 32767, 32767}));
+    QCOMPARE(samples(QAudioFormat::Int32, qint32 {}),
+             (QVector<qint32> {-2147483647, -2147483647, -1073741824, 0, 1073741824, 2147483647, 2147483647}));
+    QCOMPARE(samples(QAudioFormat::UInt8, quint8 {}),
+             (QVector<quint8> {1, 1, 65, 128, 192, 255, 255}));
+  }
+
+  // Trigger to audio latency, with the mixer being pulled from on another
+  // thread by a stand-in for the output device. A triggered sound should
+  // be mixed by the next period the device asks for; allow for the odd
+  // late wakeup of either thread, but not for a backlog.
+
+  void
+  latency()
+  {
+    auto const stereo = format(QAudioFormat::Float, 2);
+
+    NotificationMixer mixer;
+    mixer.setFormat(stereo);
+
+    NullSink sink {mixer, stereo};
+    sink.start(QThread::TimeCriticalPriority);
+
+    constexpr int SOUNDS = 50;
+
+    for (int i = 0; i < SOUNDS; ++i)
+    {
+      mixer.add(sound(2 * FRAMES, 0.1f));
+      QThread::msleep(3 + i % 5);
+    }
+
+    QThread::msleep(2 * PERIOD);
+    sink.stop();
+
+    auto const tally = mixer.latency();
+
+    qInfo("trigger to mix over %lld sounds: mean %lld us, max %lld us",
+          tally.count,
+          tally.totalNs / std::max(qint64 {1}, tally.count) / 1000,
+          tally.maxNs / 1000);
+
+    QCOMPARE(tally.count, qint64 {SOUNDS});
+    QVERIFY(tally.totalNs / tally.count <= PERIOD * 1000000);
+    QVERIFY(tally.maxNs <= 5 * PERIOD * 1000000);
+
+    // Taking the tally resets it.
+
+    QCOMPARE(mixer.latency().count, qint64 {0});
+  }
+};
+
+QTEST_APPLESS_MAIN(TestNotificationMixer)
+
+#include "test_NotificationMixer.moc"
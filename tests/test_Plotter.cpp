@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QPolygonF>
+#include <QRandomGenerator>
+#include "commons.h"
+#include "plotter.h"
+#include "RDP.hpp"
+#include "WF.hpp"
+
+// Defined by the main window, which isn't part of the test; the plotter
+// reads the averaged spectra from it.
+
+struct specData specData;
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  // Waterfall size, and the percentage of it given to the spectrum, as a
+  // typically sized main window would have it; the plotter puts the scale
+  // above the waterfall, and the spectrum over the bottom of it.
+
+  constexpr int WIDTH     = 1200;
+  constexpr int HEIGHT    = 600;
+  constexpr int PERCENT2D = 30;
+  constexpr int SCALE     = 30;
+  constexpr int H2        = PERCENT2D * (HEIGHT - SCALE) / 100;
+  constexpr int H1        = HEIGHT - H2;
+
+  // Frames of noise to cycle through in the benchmarks.
+
+  constexpr int FRAMES = 64;
+
+  // The waterfall scale with the plotter's defaults; 2 bins per pixel,
+  // averaging over 1, no gain, no zero offset.
+
+  float const SCALE1D = 10.0f * std::sqrt(2 * 1 / 15.0f) * std::pow(10.0f, 0.0f);
+
+  int
+  index(float const value)
+  {
+    return std::clamp(static_cast<int>(SCALE1D * value), 0, 254);
+  }
+
+  // A row for which every pixel is the color at the index given.
+
+  WF::SWide
+  row(int const i)
+  {
+    WF::SWide swide;
+    swide.fill((i + 0.5f) / SCALE1D);
+    return swide;
+  }
+
+  // Palettes in which each index is a distinct color.
+
+  CPlotter::Colors
+  palette(bool const green)
+  {
+    CPlotter::Colors colors;
+
+    for (int i = 0; i < 256; ++i)
+    {
+      colors << (green ? QColor(0, i, 0) : QColor(i, 0, 0));
+    }
+
+    return colors;
+  }
+
+  std::vector<WF::SWide>
+  noise()
+  {
+    auto                   generator = QRandomGenerator(20240309);
+    std::vector<WF::SWide> frames(FRAMES);
+
+    for (auto & frame : frames)
+    {
+      for (auto & value : frame)
+      {
+        value = static_cast<float>(generator.generateDouble() * 60.0);
+      }
+    }
+
+    return frames;
+  }
+
+  // Show a plotter at our size; it's ready once the resize has been
+  // debounced, until which it has nothing to draw into.
+
+  bool
+  prepare(CPlotter & plotter)
+  {
+    plotter.setPercent2D(PERCENT2D);
+    plotter.setColors(palette(false));
+    plotter.setFixedSize(WIDTH, HEIGHT);
+    plotter.show();
+
+    return QTest::qWaitForWindowExposed(&plotter)
+        && QTest::qWaitFor([&plotter]() { return plotter.replotUsage().count > 0; });
+  }
+
+  // The waterfall as it was before it became a ring, as far as drawing a
+  // frame and painting it go; the whole waterfall scrolled down a row for
+  // each frame, and the overlay copied to draw the spectrum line into.
+
+  class OldWaterfall
+  {
+    QPixmap   m_ScalePixmap     = pixmap({WIDTH, SCALE}, Qt::white);
+    QPixmap   m_WaterfallPixmap = pixmap({WIDTH, H1},    Qt::black);
+    QPixmap   m_OverlayPixmap   = pixmap({WIDTH, H2},    Qt::darkBlue);
+    QPixmap   m_SpectrumPixmap;
+    QPolygonF m_points;
+    RDP       m_rdp;
+
+    CPlotter::Colors const m_colors = palette(false);
+
+    static QPixmap
+    pixmap(QSize  const & size,
+           QColor const & fill)
+    {
+      QPixmap pixmap(size);
+      pixmap.fill(fill);
+      return pixmap;
+    }
+
+  public:
+
+    void
+    drawData(WF::SWide const & swide)
+    {
+      m_WaterfallPixmap.scroll(0, 1, m_WaterfallPixmap.rect());
+
+      QPainter p(&m_WaterfallPixmap);
+
+      for (auto x = 0; x < WIDTH; ++x)
+      {
+        p.setPen(m_colors[index(swide[x])]);
+        p.drawPoint(x, 0);
+      }
+
+      m_SpectrumPixmap = m_OverlayPixmap.copy();
+
+      QPainter s(&m_SpectrumPixmap);
+
+      s.setPen(Qt::green);
+
+      auto const min = *std::min_element(swide.begin(),
+                                         swide.begin() + WIDTH);
+
+      m_points.clear();
+      m_points.reserve(WIDTH);
+
+      for (auto x = 0; x < WIDTH; ++x)
+      {
+        m_points.emplace_back(x, H2 * 0.9f - H2 / 70.0f * (swide[x] - min));
+      }
+
+      m_points.erase(m_rdp(m_points), m_points.end());
+      s.setRenderHint(QPainter::Antialiasing);
+
+      for (qsizetype i  = 0;
+                     i  < m_points.size();
+                     i += 6)
+      {
+        s.drawPolyline(m_points.data() + i, qMin(qsizetype {7},
+                                                 m_points.size() - i));
+      }
+    }
+
+    void
+    paint(QPainter & p) const
+    {
+      p.drawPixmap(0, 0,     m_ScalePixmap);
+      p.drawPixmap(0, SCALE, m_WaterfallPixmap);
+      p.drawPixmap(0, H1,    m_SpectrumPixmap);
+    }
+  };
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestPlotter : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Rendered headless, having drawn more rows than the ring holds, so that
+  // it has wrapped, the newest row is at the top of the waterfall, and the
+  // older ones below it in order, down to where the spectrum covers them.
+  // A replot, redrawing the ring from the top, leaves them in the same
+  // order.
+
+  void
+  order()
+  {
+    CPlotter plotter;
+    QVERIFY(prepare(plotter));
+
+    constexpr int ROWS = 3 * H1 + 17;
+
+    auto const value = [](int const row) { return row % 200 + 20; };
+
+    for (int i = 0; i < ROWS; ++i)
+    {
+      plotter.drawData(row(value(i)), WF::Sink::Current);
+    }
+
+    auto const check = [&plotter, &value](bool const green)
+    {
+      QImage image(plotter.size(), QImage::Format_ARGB32_Premultiplied);
+      plotter.render(&image);
+
+      for (int y = SCALE; y < H1; ++y)
+      {
+        auto const expected = index(row(value(ROWS - 1 - (y - SCALE)))[0]);
+        auto const color    = green ? qRgb(0, expected, 0) : qRgb(expected, 0, 0);
+
+        for (auto const x : {WIDTH / 4, WIDTH / 2, WIDTH - 1})
+        {
+          QVERIFY2(image.pixel(x, y) == color, qPrintable(QString {"x %1, y %2"}.arg(x).arg(y)));
+        }
+      }
+
+      // The spectrum is over the bottom of the waterfall; none of the
+      // waterfall colors have any blue in them, and the spectrum's
+      // background does.
+
+      for (auto const x : {WIDTH / 4, WIDTH / 2, WIDTH - 1})
+      {
+        QVERIFY2(qBlue(image.pixel(x, H1)) > 0, qPrintable(QString {"x %1"}.arg(x)));
+      }
+    };
+
+    check(false);
+    if (QTest::currentTestFailed()) return;
+
+    plotter.setColors(palette(true));
+
+    check(true);
+  }
+
+  // Time to draw a frame, and to draw and paint one, rendered headless at
+  // the same size; the old way, scrolling the waterfall and copying the
+  // overlay, and the ring. The ring's paint is that of the whole plotter,
+  // the old one only the pixmaps that made up the display. These run once
+  // under ctest; run the test directly, e.g., with -median 5, to compare
+  // them.
+
+  void
+  benchmarkFrame_data()
+  {
+    QTest::addColumn<bool>("old");
+    QTest::addColumn<bool>("paint");
+
+    QTest::newRow("scroll")          << true  << false;
+    QTest::newRow("ring")            << false << false;
+    QTest::newRow("scroll, painted") << true  << true;
+    QTest::newRow("ring, painted")   << false << true;
+  }
+
+  void
+  benchmarkFrame()
+  {
+    QFETCH(bool, old);
+    QFETCH(bool, paint);
+
+    CPlotter plotter;
+    QVERIFY(prepare(plotter));
+
+    OldWaterfall oldWaterfall;
+    QImage       image(plotter.size(), QImage::Format_ARGB32_Premultiplied);
+    auto const   frames = noise();
+    int          frame  = 0;
+
+    QBENCHMARK
+    {
+      auto const & swide = frames[frame++ % FRAMES];
+
+      if (old)
+      {
+        oldWaterfall.drawData(swide);
+
+        if (paint)
+        {
+          QPainter p(&image);
+          oldWaterfall.paint(p);
+        }
+      }
+      else
+      {
+        plotter.drawData(swide, WF::Sink::Current);
+
+        if (paint) plotter.render(&image);
+      }
+    }
+  }
+};
+
+QTEST_MAIN(TestPlotter)
+
+#include "test_Plotter.moc"
@@ -0,0 +1,246 @@
+#include <optional>
+#include <QtTest>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QTimeZone>
+#include "StationList.hpp"
+#include "StationSchedule.hpp"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  using Station  = StationList::Station;
+  using Stations = StationList::Stations;
+
+  constexpr qint64 DAY = 24 * 60 * 60 * 1000;
+
+  // Station list times carry a fixed date; only the time of day matters.
+
+  QDateTime
+  at(int const h,
+     int const m,
+     int const s  = 0,
+     int const ms = 0)
+  {
+    return QDateTime(QDate(2000, 1, 1), QTime(h, m, s, ms), QTimeZone::utc());
+  }
+
+  Station
+  station(Radio::Frequency const   frequency,
+          QDateTime        const & switchAt,
+          QDateTime        const & switchUntil)
+  {
+    return {"", frequency, switchAt, switchUntil, ""};
+  }
+
+  // Frequency of the station active at a time, or 0 if none is.
+
+  Radio::Frequency
+  active(StationSchedule const & schedule,
+         QDateTime       const & when)
+  {
+    auto const station = schedule.station(when);
+
+    return station ? station->frequency_ : 0;
+  }
+
+  // The rule the schedule replaced, as MainWindow applied it every period;
+  // with the list sorted by (switch at, switch until), the last station
+  // whose window, inclusive of both ends and wrapping through midnight,
+  // contains the time of day.
+
+  Radio::Frequency
+  oldRule(Stations          stations,
+          QDateTime const & when)
+  {
+    std::stable_sort(stations.begin(), stations.end(), [](Station const & a, Station const & b)
+    {
+      return (a.switch_at_ < b.switch_at_) || (a.switch_at_ == b.switch_at_ && a.switch_until_ < b.switch_until_);
+    });
+
+    auto d = when;
+    d.setDate(QDate(2000, 1, 1));
+
+    auto const startOfDay = at(0, 0);
+    auto const endOfDay   = at(23, 59, 59, 999);
+
+    Radio::Frequency frequency = 0;
+
+    for (auto const & station : stations)
+    {
+      bool const inTimeRange = (
+        (station.switch_at_ <= d && d <= station.switch_until_) ||
+        (station.switch_until_ < station.switch_at_ && (
+             (station.switch_at_ <= d && d <= endOfDay) ||
+             (startOfDay <= d && d <= station.switch_until_)
+        ))
+      );
+
+      if (inTimeRange) frequency = station.frequency_;
+    }
+
+    return frequency;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestStationSchedule : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // An empty schedule has no station and no transitions.
+
+  void
+  empty()
+  {
+    StationSchedule schedule;
+    schedule.compile({});
+
+    QVERIFY(schedule.empty());
+    QVERIFY(!schedule.station(at(12, 0)));
+    QVERIFY(!schedule.next(at(12, 0)));
+    QCOMPARE(schedule.segment(at(12, 0)), -1);
+    QVERIFY(schedule.conflicts().isEmpty());
+  }
+
+  // The until time is inclusive, to the millisecond.
+
+  void
+  inclusive()
+  {
+    StationSchedule schedule;
+    schedule.compile({station(7078000, at(12, 0), at(14, 0))});
+
+    QCOMPARE(active(schedule, at(11, 59, 59, 999)), Radio::Frequency {0});
+    QCOMPARE(active(schedule, at(12, 0)),           Radio::Frequency {7078000});
+    QCOMPARE(active(schedule, at(14, 0)),           Radio::Frequency {7078000});
+    QCOMPARE(active(schedule, at(14, 0, 0, 1)),     Radio::Frequency {0});
+  }
+
+  // Where windows overlap, the one sorting last wins for as long as it
+  // covers, and overlaps only count as conflicts if the frequencies differ.
+
+  void
+  overlaps()
+  {
+    StationSchedule schedule;
+    schedule.compile({station(14078000, at(12, 0), at(14, 0)),
+                      station( 7078000, at( 0, 0), at(23, 59, 59, 999)),
+                      station( 7078000, at( 6, 0), at( 8, 0))});
+
+    QCOMPARE(active(schedule, at( 5, 0)),           Radio::Frequency {7078000});
+    QCOMPARE(active(schedule, at(13, 0)),           Radio::Frequency {14078000});
+    QCOMPARE(active(schedule, at(14, 0, 0, 1)),     Radio::Frequency {7078000});
+    QCOMPARE(schedule.conflicts().size(),           qsizetype {1});
+
+    auto const [first, second] = schedule.conflicts().first();
+    QCOMPARE(schedule.stations()[first].frequency_,  Radio::Frequency {7078000});
+    QCOMPARE(schedule.stations()[second].frequency_, Radio::Frequency {14078000});
+    QCOMPARE(schedule.stations()[first].switch_at_,  at(0, 0));
+  }
+
+  // A window whose until time is earlier than its at time runs through
+  // midnight, and the segments either side of midnight are the same one.
+
+  void
+  midnightWrap()
+  {
+    StationSchedule schedule;
+    schedule.compile({station(3578000, at(22, 0), at(2, 0))});
+
+    auto const today    = QDateTime(QDate(2024, 3, 9),  QTime(0, 0), QTimeZone::utc());
+    auto const tomorrow = QDateTime(QDate(2024, 3, 10), QTime(0, 0), QTimeZone::utc());
+
+    QCOMPARE(active(schedule, at(21, 59, 59, 999)), Radio::Frequency {0});
+    QCOMPARE(active(schedule, at(23, 0)),           Radio::Frequency {3578000});
+    QCOMPARE(active(schedule, at( 1, 0)),           Radio::Frequency {3578000});
+    QCOMPARE(active(schedule, at( 2, 0, 0, 1)),     Radio::Frequency {0});
+
+    QCOMPARE(schedule.segment(today.addSecs(23 * 3600)),
+             schedule.segment(tomorrow.addSecs(3600)));
+
+    QCOMPARE(schedule.next(today.addSecs(21 * 3600)).value(), today.addSecs(22 * 3600));
+    QCOMPARE(schedule.next(today.addSecs(23 * 3600)).value(), tomorrow.addMSecs(2 * 3600 * 1000 + 1));
+  }
+
+  // A station that covers the whole of the day never changes.
+
+  void
+  allDay()
+  {
+    StationSchedule schedule;
+    schedule.compile({station(7078000, at(0, 0), at(23, 59, 59, 999))});
+
+    QCOMPARE(active(schedule, at(0, 0)),            Radio::Frequency {7078000});
+    QCOMPARE(active(schedule, at(23, 59, 59, 999)), Radio::Frequency {7078000});
+    QVERIFY(!schedule.next(at(12, 0)));
+  }
+
+  // For random lists, the schedule picks the same station as the old rule
+  // at every minute of the day and either side of every window's ends, and
+  // the next transition is exactly the first time the station changes.
+
+  void
+  matchesOldRule()
+  {
+    QRandomGenerator random {20240309};
+
+    auto const minute = [&random]()
+    {
+      return at(random.bounded(24), random.bounded(60));
+    };
+
+    for (int trial = 0; trial < 200; ++trial)
+    {
+      Stations stations;
+
+      for (int i = random.bounded(1, 6); i > 0; --i)
+      {
+        auto const from = minute();
+        auto const to   = random.bounded(8) ? minute() : from;
+
+        stations.append(station(1000000 + 1000 * stations.size(), from, to));
+      }
+
+      StationSchedule schedule;
+      schedule.compile(stations);
+
+      QList<QDateTime> times;
+
+      for (int m = 0; m < 24 * 60; ++m) times.append(at(0, 0).addSecs(60 * m));
+
+      for (auto const & s : stations)
+      {
+        for (auto const & t : {s.switch_at_, s.switch_until_})
+        {
+          times << t.addMSecs(-1) << t << t.addMSecs(1);
+        }
+      }
+
+      for (auto const & t : times)
+      {
+        QCOMPARE(active(schedule, t), oldRule(stations, t));
+
+        if (auto const next = schedule.next(t))
+        {
+          QVERIFY(*next > t);
+          QVERIFY(t.msecsTo(*next) <= DAY);
+          QVERIFY(active(schedule, *next) != active(schedule, t));
+          QCOMPARE(active(schedule, next->addMSecs(-1)), active(schedule, t));
+        }
+      }
+    }
+  }
+};
+
+QTEST_APPLESS_MAIN(TestStationSchedule)
+
+#include "test_StationSchedule.moc"
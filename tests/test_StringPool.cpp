@@ -0,0 +1,379 @@
+#include <QtTest>
+#include <QList>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QString>
+#include "Activity.hpp"
+#include "decodedtext.h"
+#include "MemoryAccounting.hpp"
+#include "StringPool.hpp"
+#include "varicode.h"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  // A busy band, as far as the activity records are concerned; this many
+  // stations on at a time, heard in random order, over this many decodes,
+  // about an evening's worth. Every so many decodes, a station goes quiet
+  // and a new one comes on.
+
+  constexpr int STATIONS = 300;
+  constexpr int DECODES  = 20000;
+  constexpr int TURNOVER = 20;
+
+  // Every frame a message of its own, in the normal submode.
+
+  constexpr int BITS    = Varicode::JS8CallFirst | Varicode::JS8CallLast;
+  constexpr int SUBMODE = Varicode::JS8CallNormal;
+
+  // A standard call and a grid for each station; calls are unique, grids
+  // are shared by every hundredth station.
+
+  QString
+  call(int const station)
+  {
+    return QString {"K%1%2X%3"}.arg(QChar {'A' + station % 26})
+                               .arg(station / 26 % 10)
+                               .arg(QChar {'A' + station / 260 % 26});
+  }
+
+  QString
+  grid(int const station)
+  {
+    return QString {"FN%1"}.arg(station % 100, 2, 10, QChar {'0'});
+  }
+
+  // The frames heard on the band, as decoded; heartbeats, carrying a grid,
+  // and queries from one station to another, half of each.
+
+  QList<QString>
+  frames()
+  {
+    auto           generator = QRandomGenerator(20240309);
+    QList<QString> frames;
+
+    frames.reserve(DECODES);
+
+    for (int i = 0; i < DECODES; ++i)
+    {
+      auto const first = i / TURNOVER;
+      auto const from  = first + generator.bounded(STATIONS);
+
+      if (generator.bounded(2))
+      {
+        frames << Varicode::packCompoundFrame(call(from), Varicode::FrameHeartbeat, Varicode::packGrid(grid(from)), 0);
+      }
+      else
+      {
+        auto const to  = first + (from - first + 1 + generator.bounded(STATIONS - 1)) % STATIONS;
+        auto const cmd = generator.bounded(2) ? " SNR?" : " GRID?";
+
+        frames << Varicode::packDirectedMessage(call(to) + cmd, call(from), nullptr, nullptr, nullptr, nullptr, nullptr);
+      }
+    }
+
+    return frames;
+  }
+
+  // What the main window holds on to; the latest record for each call, and
+  // the compound calls and commands heard, most recent last, as the band
+  // activity, message buffers and the queues between decoding and display
+  // would.
+
+  struct Heard
+  {
+    QMap<QString, CallDetail> calls;
+    QList<CallDetail>         compound;
+    QList<CommandDetail>      commands;
+  };
+
+  // Replay the band through the activity code, as the main window does
+  // for each decode; heartbeats are taken as the command they stand for,
+  // and both log their caller.
+
+  Heard
+  replay(QList<QString> const & frames,
+         StringPool           & pool)
+  {
+    Heard heard;
+
+    for (auto const & frame : frames)
+    {
+      DecodedText const decodedtext {frame, BITS, SUBMODE};
+
+      if (decodedtext.isCompound() && !decodedtext.isDirectedMessage())
+      {
+        auto cd = Activity::compoundCall(decodedtext, pool);
+
+        heard.compound.append(cd);
+        Activity::logCall(heard.calls, cd, pool);
+      }
+      else if (decodedtext.isDirectedMessage())
+      {
+        auto const cmd = Activity::directedCommand(decodedtext, pool);
+        auto       cd  = Activity::caller(cmd);
+
+        heard.commands.append(cmd);
+        Activity::logCall(heard.calls, cd, pool);
+      }
+    }
+
+    return heard;
+  }
+
+  // Call the function given with every string the records hold.
+
+  template<typename Function>
+  void
+  visit(Heard    const & heard,
+        Function      && function)
+  {
+    for (auto it = heard.calls.cbegin(); it != heard.calls.cend(); ++it)
+    {
+      function(it.key());
+      function(it->call);
+      function(it->through);
+      function(it->grid);
+    }
+
+    for (auto const & cd : heard.compound)
+    {
+      function(cd.call);
+      function(cd.through);
+      function(cd.grid);
+    }
+
+    for (auto const & cmd : heard.commands)
+    {
+      function(cmd.from);
+      function(cmd.to);
+      function(cmd.cmd);
+      function(cmd.extra);
+    }
+  }
+
+  // Strings the records hold; distinct values, and the distinct copies of
+  // them, along with the heap those copies take, counting each once, and
+  // the heap they'd take, as they did before interning, were each record
+  // to have its own.
+
+  struct Strings
+  {
+    qsizetype values = 0;
+    qsizetype copies = 0;
+    qsizetype shared = 0;   // bytes
+    qsizetype plain  = 0;   // bytes
+  };
+
+  Strings
+  strings(Heard const & heard)
+  {
+    QSet<QString>      values;
+    QSet<void const *> copies;
+    Strings            strings;
+
+    visit(heard, [&](QString const & string)
+    {
+      if (string.isEmpty()) return;
+
+      strings.plain += MemoryAccounting::heap(string);
+
+      values.insert(string);
+
+      if (!copies.contains(string.constData()))
+      {
+        copies.insert(string.constData());
+        strings.shared += MemoryAccounting::heap(string);
+      }
+    });
+
+    strings.values = values.size();
+    strings.copies = copies.size();
+
+    return strings;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestStringPool : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Equal strings come back sharing the one copy; empty ones come back as
+  // they are, and aren't pooled.
+
+  void
+  intern()
+  {
+    StringPool pool;
+
+    auto const a = pool.intern(QString {"KB1XYZ"});
+    auto const b = pool.intern(QString {"KB1XYZ"});
+    auto const c = pool.intern(QString {"KB2XYZ"});
+
+    QCOMPARE(a, QString {"KB1XYZ"});
+    QCOMPARE(a.constData(), b.constData());
+    QVERIFY(a.constData() != c.constData());
+
+    QVERIFY(pool.intern(QString {}).isEmpty());
+    QCOMPARE(pool.usage().count, qsizetype {2});
+  }
+
+  // At its limit, the pool drops only what hasn't been interned for a
+  // generation; a string interned every generation stays the same copy
+  // however many strings pass through, and the pool stays within its
+  // limit. Clearing it leaves the strings handed out intact; they're just
+  // no longer shared with what's interned after.
+
+  void
+  evict()
+  {
+    constexpr qsizetype LIMIT = 8;
+
+    StringPool pool {LIMIT};
+
+    auto const hot  = pool.intern(QString {"KB1XYZ"});
+    auto const cold = pool.intern(QString {"KB2XYZ"});
+
+    for (int i = 0; i < 10 * LIMIT; ++i)
+    {
+      pool.intern(QString {"K%1"}.arg(i));
+
+      QCOMPARE(pool.intern(QString {"KB1XYZ"}).constData(), hot.constData());
+      QVERIFY(pool.usage().count <= LIMIT);
+    }
+
+    QVERIFY(pool.intern(QString {"KB2XYZ"}).constData() != cold.constData());
+    QCOMPARE(cold, QString {"KB2XYZ"});
+
+    pool.clear();
+
+    QCOMPARE(pool.usage().count, qsizetype {0});
+    QCOMPARE(hot, QString {"KB1XYZ"});
+    QVERIFY(pool.intern(QString {"KB1XYZ"}).constData() != hot.constData());
+  }
+
+  // Replaying a busy band through the activity code, the records hold a
+  // fraction of the string memory they would were each to have its own
+  // copy; reports both, and the pool's own.
+
+  void
+  replayMemory()
+  {
+    StringPool pool;
+
+    auto const heard = replay(frames(), pool);
+    auto const held  = strings(heard);
+
+    QCOMPARE(heard.compound.size() + heard.commands.size(), qsizetype {DECODES});
+
+    qInfo("%d decodes, %d stations on at a time: strings held %lld bytes plain, %lld interned, pool %lld bytes",
+          DECODES,
+          STATIONS,
+          static_cast<long long>(held.plain),
+          static_cast<long long>(held.shared),
+          static_cast<long long>(pool.usage().bytes));
+
+    QCOMPARE(held.copies, held.values);
+    QVERIFY(held.shared * 10 < held.plain);
+  }
+
+  // With a pool small enough to age strings out many times over the replay,
+  // but large enough for those on the band at any one time, no string held
+  // by the records is ever copied twice; stations still on are never
+  // dropped, and those that have gone don't come back.
+
+  void
+  replayAging()
+  {
+    constexpr qsizetype LIMIT = 1024;
+
+    StringPool pool {LIMIT};
+
+    auto const heard = replay(frames(), pool);
+    auto const held  = strings(heard);
+
+    qInfo("pool limit %lld: %lld values held, in %lld copies; pool %lld strings",
+          static_cast<long long>(LIMIT),
+          static_cast<long long>(held.values),
+          static_cast<long long>(held.copies),
+          static_cast<long long>(pool.usage().count));
+
+    QVERIFY(held.values > LIMIT);
+    QCOMPARE(held.copies, held.values);
+    QVERIFY(pool.usage().count <= LIMIT);
+  }
+
+  // Time to build the records of a busy band from its decodes; this runs
+  // once under ctest, run the test directly, e.g., with -median 5, to
+  // measure it.
+
+  void
+  benchmarkReplay()
+  {
+    auto const band = frames();
+
+    QBENCHMARK
+    {
+      StringPool pool;
+      replay(band, pool);
+    }
+  }
+
+  // A pass over the call activity, as the relay menu, the API and query
+  // replies make; copying the values first, as they used to, or iterating
+  // the map in place.
+
+  void
+  benchmarkActivityPass_data()
+  {
+    QTest::addColumn<bool>("copy");
+
+    QTest::newRow("values()")        << true;
+    QTest::newRow("const reference") << false;
+  }
+
+  void
+  benchmarkActivityPass()
+  {
+    QFETCH(bool, copy);
+
+    StringPool pool;
+
+    auto const heard  = replay(frames(), pool);
+    int        strong = 0;
+
+    QBENCHMARK
+    {
+      strong = 0;
+
+      if (copy)
+      {
+        foreach(auto cd, heard.calls.values()){
+          if (cd.snr >= -10) ++strong;
+        }
+      }
+      else
+      {
+        for(auto const &cd : std::as_const(heard.calls)){
+          if (cd.snr >= -10) ++strong;
+        }
+      }
+    }
+
+    QVERIFY(strong > 0);
+  }
+};
+
+QTEST_APPLESS_MAIN(TestStringPool)
+
+#include "test_StringPool.moc"
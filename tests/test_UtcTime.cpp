@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <QtTest>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QTimeZone>
+#include "DriftingDateTime.h"
+
+/******************************************************************************/
+// Local Constants and Helpers
+/******************************************************************************/
+
+namespace
+{
+  // Call activity of a busy band, as far as the display and ageing loops
+  // are concerned; this many records, heard over the last this many minutes,
+  // aged out after this many.
+
+  constexpr int RECORDS = 2000;
+  constexpr int MINUTES = 120;
+  constexpr int AGING   = 60;
+
+  // Stand-ins for the activity records, before and after the change, with
+  // the timestamps the loops look at.
+
+  struct OldRecord
+  {
+    QDateTime utcTimestamp;
+    QDateTime ackTimestamp;
+  };
+
+  struct NewRecord
+  {
+    UtcTime utcTimestamp;
+    UtcTime ackTimestamp;
+  };
+
+  // Offsets, in milliseconds before now, at which the records were heard;
+  // one in ten of them acknowledged.
+
+  std::vector<qint64>
+  offsets()
+  {
+    auto                generator = QRandomGenerator(20240309);
+    std::vector<qint64> offsets(RECORDS);
+
+    for (auto & offset : offsets)
+    {
+      offset = static_cast<qint64>(generator.bounded(MINUTES * 60 * 1000));
+    }
+
+    return offsets;
+  }
+
+  template <typename Record,
+            typename Time>
+  std::vector<Record>
+  records(Time const now)
+  {
+    std::vector<Record> records;
+
+    for (auto const offset : offsets())
+    {
+      auto const heard = now.addMSecs(-offset);
+      records.push_back({heard, offset % 10 ? Time {} : heard});
+    }
+
+    return records;
+  }
+}
+
+/******************************************************************************/
+// Tests
+/******************************************************************************/
+
+class TestUtcTime : public QObject
+{
+  Q_OBJECT
+
+private slots:
+
+  // Instants either side of the epoch and of midnight, and the intervals
+  // between them, which truncate toward zero in either direction, are as
+  // QDateTime has them.
+
+  void
+  matchesQDateTime_data()
+  {
+    QTest::addColumn<QDateTime>("a");
+    QTest::addColumn<QDateTime>("b");
+
+    auto const utc = [](int y, int mo, int d, int h, int mi, int s, int ms)
+    {
+      return QDateTime(QDate(y, mo, d), QTime(h, mi, s, ms), QTimeZone::utc());
+    };
+
+    QTest::newRow("same")            << utc(2024, 3, 9, 14, 5, 7, 0)     << utc(2024, 3, 9, 14, 5, 7, 0);
+    QTest::newRow("later")           << utc(2024, 3, 9, 14, 5, 7, 0)     << utc(2024, 3, 9, 15, 0, 0, 999);
+    QTest::newRow("earlier")         << utc(2024, 3, 9, 15, 0, 0, 999)   << utc(2024, 3, 9, 14, 5, 7, 0);
+    QTest::newRow("part second")     << utc(2024, 3, 9, 14, 5, 7, 400)   << utc(2024, 3, 9, 14, 5, 6, 900);
+    QTest::newRow("midnight")        << utc(2024, 3, 9, 23, 59, 59, 999) << utc(2024, 3, 10, 0, 0, 0, 0);
+    QTest::newRow("before epoch")    << utc(1969, 12, 31, 23, 59, 58, 500) << utc(1970, 1, 1, 0, 0, 1, 250);
+    QTest::newRow("leap day")        << utc(2024, 2, 29, 12, 0, 0, 0)    << utc(2024, 3, 1, 12, 0, 0, 0);
+    QTest::newRow("invalid")         << QDateTime {}                     << utc(2024, 3, 9, 14, 5, 7, 0);
+    QTest::newRow("both invalid")    << QDateTime {}                     << QDateTime {};
+  }
+
+  void
+  matchesQDateTime()
+  {
+    QFETCH(QDateTime, a);
+    QFETCH(QDateTime, b);
+
+    auto const ua = UtcTime::fromDateTime(a);
+    auto const ub = UtcTime::fromDateTime(b);
+
+    QCOMPARE(ua.isValid(), a.isValid());
+    QCOMPARE(ua.toDateTime(), a);
+    QCOMPARE(ua.msecsTo(ub), a.msecsTo(b));
+    QCOMPARE(ua.secsTo(ub),  a.secsTo(b));
+    QCOMPARE(ua.addSecs(-300).toDateTime(), a.addSecs(-300));
+    QCOMPARE(ua.addMSecs(1500).toDateTime(), a.addMSecs(1500));
+
+    if (a.isValid())
+    {
+      QCOMPARE(ua.hour(),   a.time().hour());
+      QCOMPARE(ua.minute(), a.time().minute());
+      QCOMPARE(ua.second(), a.time().second());
+      QCOMPARE(ua.msecsSinceStartOfDay(), a.time().msecsSinceStartOfDay());
+    }
+
+    // Ordering is the same, other than that an invalid instant comes before
+    // any valid one, for the display sort.
+
+    if (a.isValid() && b.isValid())
+    {
+      QCOMPARE(ua < ub,  a < b);
+      QCOMPARE(ua == ub, a == b);
+    }
+    else if (a.isValid() != b.isValid())
+    {
+      QCOMPARE(ua < ub, !a.isValid());
+    }
+  }
+
+  // The ageing pass over call activity, as the relay menu, query replies and
+  // the API make it; the old way, taking the current time for each record
+  // as since() did and comparing QDateTimes, and the new, taking it once and
+  // comparing integers. These run once under ctest; run the test directly,
+  // e.g., with -median 5, to compare them.
+
+  void
+  benchmarkAgeing_data()
+  {
+    QTest::addColumn<bool>("old");
+
+    QTest::newRow("QDateTime") << true;
+    QTest::newRow("UtcTime")   << false;
+  }
+
+  void
+  benchmarkAgeing()
+  {
+    QFETCH(bool, old);
+
+    auto const oldRecords = records<OldRecord>(DriftingDateTime::currentDateTimeUtc());
+    auto const newRecords = records<NewRecord>(DriftingDateTime::currentUtc());
+    int        current    = 0;
+
+    QBENCHMARK
+    {
+      current = 0;
+
+      if (old)
+      {
+        for (auto const & record : oldRecords)
+        {
+          if (record.utcTimestamp.secsTo(DriftingDateTime::currentDateTimeUtc()) / 60 < AGING) ++current;
+        }
+      }
+      else
+      {
+        auto const now = DriftingDateTime::currentUtc();
+
+        for (auto const & record : newRecords)
+        {
+          if (record.utcTimestamp.secsTo(now) / 60 < AGING) ++current;
+        }
+      }
+    }
+
+    QVERIFY(current > 0 && current < RECORDS);
+  }
+
+  // The display sort of call activity, most recently acknowledged first,
+  // and then most recently heard.
+
+  void
+  benchmarkDisplaySort_data()
+  {
+    QTest::addColumn<bool>("old");
+
+    QTest::newRow("QDateTime") << true;
+    QTest::newRow("UtcTime")   << false;
+  }
+
+  void
+  benchmarkDisplaySort()
+  {
+    QFETCH(bool, old);
+
+    auto const oldRecords = records<OldRecord>(DriftingDateTime::currentDateTimeUtc());
+    auto const newRecords = records<NewRecord>(DriftingDateTime::currentUtc());
+
+    QBENCHMARK
+    {
+      if (old)
+      {
+        auto sorted = oldRecords;
+
+        auto const ms = [](QDateTime const &utc){
+          return utc.isValid() ? utc.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+        };
+
+        std::sort(sorted.begin(), sorted.end(), [&ms](OldRecord const & a, OldRecord const & b)
+        {
+          return std::pair(ms(a.ackTimestamp), ms(a.utcTimestamp)) >
+                 std::pair(ms(b.ackTimestamp), ms(b.utcTimestamp));
+        });
+      }
+      else
+      {
+        auto sorted = newRecords;
+
+        std::sort(sorted.begin(), sorted.end(), [](NewRecord const & a, NewRecord const & b)
+        {
+          return std::pair(a.ackTimestamp, a.utcTimestamp) >
+                 std::pair(b.ackTimestamp, b.utcTimestamp);
+        });
+      }
+    }
+  }
+
+  // The time of day for a decode pass, formatted and parsed back as it used
+  // to be, or taken directly.
+
+  void
+  benchmarkTimeOfDay_data()
+  {
+    QTest::addColumn<bool>("old");
+
+    QTest::newRow("QDateTime") << true;
+    QTest::newRow("UtcTime")   << false;
+  }
+
+  void
+  benchmarkTimeOfDay()
+  {
+    QFETCH(bool, old);
+
+    auto const t   = DriftingDateTime::currentDateTimeUtc();
+    auto const u   = UtcTime::fromDateTime(t);
+    int        nutc = 0;
+
+    QBENCHMARK
+    {
+      if (old)
+      {
+        nutc = t.toString("hh").toInt() * 10000 + t.toString("mm").toInt() * 100 + t.toString("ss").toInt();
+      }
+      else
+      {
+        nutc = u.hour() * 10000 + u.minute() * 100 + u.second();
+      }
+    }
+
+    QCOMPARE(nutc, t.time().hour() * 10000 + t.time().minute() * 100 + t.time().second());
+  }
+};
+
+QTEST_APPLESS_MAIN(TestUtcTime)
+
+#include "test_UtcTime.moc"
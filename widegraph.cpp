@@ -7,6 +7,7 @@
 #include <QSettings>
 #include <QSignalBlocker>
 #include <QTimer>
+#include <QWindow>
 #include "ui_widegraph.h"
 #include "Configuration.hpp"
 #include "DriftingDateTime.h"
@@ -256,6 +257,11 @@ WideGraph::WideGraph(QSettings * settings,
     {
       QMutexLocker lock(&m_drawLock);
 
+      // If nobody can see us, the plotter records what we hand it, but
+      // doesn't paint it until we're visible again.
+
+      auto const displayed = isDisplayed();
+
       // Draw the tr cycle horizontal lines if needed.
 
       auto const now            = DriftingDateTime::currentDateTimeUtc();
@@ -264,14 +270,18 @@ WideGraph::WideGraph(QSettings * settings,
 
       if (secondInPeriod < m_lastSecondInPeriod)
       {
-        ui->widePlot->drawLine(now.toString(m_timeFormat).append(m_band));
+        auto const text = now.toString(m_timeFormat).append(m_band);
+
+        if (displayed) ui->widePlot->drawLine(text);
+        else           ui->widePlot->deferLine(text);
       }
       m_lastSecondInPeriod = secondInPeriod;
 
       // Draw the data, handing the plotter a copy, and informing them
       // of our current state.
 
-      ui->widePlot->drawData(m_swide, m_state);
+      if (displayed) ui->widePlot->drawData(m_swide, m_state);
+      else           ui->widePlot->deferData(m_swide);
 
       // Whatever our state was, the sink is now drained until new data
       // arrives; data we draw until then will duplicate the operation
@@ -336,6 +346,24 @@ WideGraph::shouldDisplayDecodeAttempts() const
   return ui->decodeAttemptCheckBox->isChecked();
 }
 
+// Whether anyone can see the waterfall; we might be hidden, our window
+// minimized, or, on platforms that can tell, covered or on a locked screen,
+// in which case the window isn't exposed.
+
+bool
+WideGraph::isDisplayed() const
+{
+  auto const handle = window()->windowHandle();
+
+  return isVisible() && !window()->isMinimized() && handle && handle->isExposed();
+}
+
+MemoryAccounting::Usage
+WideGraph::replotUsage() const
+{
+  return ui->widePlot->replotUsage();
+}
+
 bool
 WideGraph::isAutoSyncEnabled() const
 {
@@ -447,7 +475,7 @@ WideGraph::drawDecodeLine(QColor const & color,
                           int    const   ia,
                           int    const   ib)
 {
-  ui->widePlot->drawDecodeLine(color, ia, ib);
+  if (isDisplayed()) ui->widePlot->drawDecodeLine(color, ia, ib);
 }
 
 void
@@ -455,7 +483,7 @@ WideGraph::drawHorizontalLine(QColor const & color,
                               int    const   x,
                               int    const   width)
 {
-    ui->widePlot->drawHorizontalLine(color, x, width);
+    if (isDisplayed()) ui->widePlot->drawHorizontalLine(color, x, width);
 }
 
 void
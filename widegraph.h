@@ -14,6 +14,7 @@
 #include <QVector>
 #include <QWidget>
 #include "commons.h"
+#include "MemoryAccounting.hpp"
 #include "WF.hpp"
 
 namespace Ui {
@@ -40,6 +41,8 @@ public:
   bool filterEnabled() const;
   int  freq() const;
   bool isAutoSyncEnabled() const;
+  bool isDisplayed() const;
+  MemoryAccounting::Usage replotUsage() const;
   int  nStartFreq() const;
   bool shouldDisplayDecodeAttempts() const;
   bool shouldAutoSyncSubmode(int) const;